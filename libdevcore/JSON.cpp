@@ -25,6 +25,7 @@
 
 #include <boost/algorithm/string/replace.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <memory>
@@ -111,4 +112,49 @@ bool jsonParseStrict(string const& _input, Json::Value& _json, string* _errs /*
 	return parse(readerBuilder, _input, _json, _errs);
 }
 
+JsonObjectStreamWriter::JsonObjectStreamWriter(ostream& _stream):
+	m_stream(_stream)
+{
+	m_stream << '{';
+}
+
+bool JsonObjectStreamWriter::write(vector<string> const& _path, Json::Value const& _value)
+{
+	if (m_finished || _path.empty() || !(m_lastPath < _path))
+		return false;
+	if (!m_lastPath.empty() && _path.size() > m_lastPath.size() && equal(m_lastPath.begin(), m_lastPath.end(), _path.begin()))
+		return false;
+
+	size_t common = 0;
+	while (common + 1 < m_lastPath.size() && common + 1 < _path.size() && m_lastPath[common] == _path[common])
+		++common;
+	for (size_t i = common; i + 1 < m_lastPath.size(); ++i)
+		m_stream << '}';
+
+	bool first = m_lastPath.empty();
+	for (size_t i = common; i < _path.size(); ++i)
+	{
+		if (!first)
+			m_stream << ',';
+		m_stream << jsonCompactPrint(Json::Value(_path[i])) << ':';
+		first = true;
+		if (i + 1 < _path.size())
+			m_stream << '{';
+	}
+	m_stream << jsonCompactPrint(_value);
+
+	m_lastPath = _path;
+	return true;
+}
+
+void JsonObjectStreamWriter::finish()
+{
+	if (m_finished)
+		return;
+	for (size_t i = 1; i < m_lastPath.size(); ++i)
+		m_stream << '}';
+	m_stream << '}';
+	m_finished = true;
+}
+
 } // namespace dev
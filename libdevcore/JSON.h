@@ -24,7 +24,9 @@
 
 #include <json/json.h>
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace dev {
 
@@ -41,4 +43,29 @@ std::string jsonCompactPrint(Json::Value const& _input);
 /// \return \c true if the document was successfully parsed, \c false if an error occurred.
 bool jsonParseStrict(std::string const& _input, Json::Value& _json, std::string* _errs = nullptr);
 
+/// Writes a JSON object to a stream member by member in the format of jsonCompactPrint, so that
+/// the whole object never has to be kept in memory. Members have to be written in the order of
+/// their keys, which is the order jsoncpp prints them in. The enclosing objects of a member are
+/// opened when it is written, i.e. objects without members are not written at all.
+class JsonObjectStreamWriter
+{
+public:
+	/// Writes the opening brace of the outermost object to @a _stream.
+	explicit JsonObjectStreamWriter(std::ostream& _stream);
+
+	/// Writes the member with the value @a _value and the path @a _path, which consists of
+	/// the keys of the enclosing objects followed by the key of the member itself.
+	/// @returns false without writing anything if the member does not come after the previously
+	/// written member or is nested inside it, or if finish() was already called.
+	bool write(std::vector<std::string> const& _path, Json::Value const& _value);
+	/// Closes all open objects including the outermost one.
+	void finish();
+
+private:
+	std::ostream& m_stream;
+	/// Path of the previously written member. All objects enclosing it are open.
+	std::vector<std::string> m_lastPath;
+	bool m_finished = false;
+};
+
 }
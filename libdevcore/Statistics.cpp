@@ -0,0 +1,134 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Collection of resource usage statistics of compilation phases.
+ */
+
+#include <libdevcore/Statistics.h>
+
+#include <algorithm>
+#include <ctime>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// @returns the CPU time used by the current thread in milliseconds.
+double threadCPUTime()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+	timespec time;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0)
+		return double(time.tv_sec) * 1000.0 + double(time.tv_nsec) / 1000000.0;
+#endif
+	// Falls back to the CPU time of the whole process.
+	return double(clock()) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/// @returns the peak resident set size of the process in kilobytes or zero if it is not available.
+size_t peakResidentSetSize()
+{
+#if defined(_WIN32)
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__)
+	// Reported in bytes instead of kilobytes.
+	return size_t(usage.ru_maxrss) / 1024;
+#else
+	return size_t(usage.ru_maxrss);
+#endif
+#endif
+}
+
+}
+
+thread_local StatisticsCollector* StatisticsCollector::s_active = nullptr;
+
+void StatisticsCollector::merge(StatisticsCollector const& _other)
+{
+	for (auto const& phase: _other.phases)
+	{
+		PhaseStatistics& statistics = phases[phase.first];
+		statistics.wallTime += phase.second.wallTime;
+		statistics.cpuTime += phase.second.cpuTime;
+		statistics.processPeakMemory = max(statistics.processPeakMemory, phase.second.processPeakMemory);
+	}
+	for (auto const& counter: _other.counters)
+		counters[counter.first] += counter.second;
+}
+
+Json::Value StatisticsCollector::toJson() const
+{
+	Json::Value ret(Json::objectValue);
+	ret["phases"] = Json::objectValue;
+	for (auto const& phase: phases)
+	{
+		Json::Value& statistics = ret["phases"][phase.first];
+		statistics["wallTime"] = phase.second.wallTime;
+		statistics["cpuTime"] = phase.second.cpuTime;
+		statistics["processPeakMemory"] = Json::UInt64(phase.second.processPeakMemory);
+	}
+	ret["counters"] = Json::objectValue;
+	for (auto const& counter: counters)
+		ret["counters"][counter.first] = Json::UInt64(counter.second);
+	return ret;
+}
+
+StatisticsCollector* StatisticsCollector::active()
+{
+	return s_active;
+}
+
+ScopedStatisticsCollector::ScopedStatisticsCollector(StatisticsCollector* _collector):
+	m_previous(StatisticsCollector::s_active)
+{
+	StatisticsCollector::s_active = _collector;
+}
+
+ScopedStatisticsCollector::~ScopedStatisticsCollector()
+{
+	StatisticsCollector::s_active = m_previous;
+}
+
+ScopedPhase::ScopedPhase(char const* _name):
+	m_collector(StatisticsCollector::active()),
+	m_name(_name)
+{
+	if (!m_collector)
+		return;
+	m_wallStart = chrono::steady_clock::now();
+	m_cpuStart = threadCPUTime();
+}
+
+ScopedPhase::~ScopedPhase()
+{
+	if (!m_collector)
+		return;
+	PhaseStatistics& statistics = m_collector->phases[m_name];
+	statistics.wallTime += chrono::duration<double, milli>(chrono::steady_clock::now() - m_wallStart).count();
+	statistics.cpuTime += threadCPUTime() - m_cpuStart;
+	statistics.processPeakMemory = max(statistics.processPeakMemory, peakResidentSetSize());
+}
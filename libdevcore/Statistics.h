@@ -0,0 +1,104 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Collection of resource usage statistics of compilation phases.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace dev
+{
+
+/// Resource usage of a phase, accumulated over all times it was run.
+struct PhaseStatistics
+{
+	/// Wall clock time in milliseconds.
+	double wallTime = 0;
+	/// CPU time of the thread running the phase in milliseconds.
+	double cpuTime = 0;
+	/// Peak resident set size of the whole process in kilobytes when the phase ended last.
+	/// This is a high-water mark of the process that never decreases, i.e. it is not the memory
+	/// used by the phase, but only shows whether the process grew while the phase was running.
+	size_t processPeakMemory = 0;
+};
+
+/**
+ * Resource usage of named phases and values of named counters.
+ *
+ * Instrumented code records into the collector that is active on the current thread,
+ * if any, so that it does not need access to the collector. Phases can be nested and
+ * the time of a phase includes the time of its nested phases.
+ */
+class StatisticsCollector
+{
+public:
+	std::map<std::string, PhaseStatistics> phases;
+	std::map<std::string, size_t> counters;
+
+	/// Adds the phases and counters of @a _other to this collector.
+	void merge(StatisticsCollector const& _other);
+
+	Json::Value toJson() const;
+
+	/// @returns the collector that is active on the current thread or nullptr.
+	static StatisticsCollector* active();
+
+private:
+	friend class ScopedStatisticsCollector;
+	static thread_local StatisticsCollector* s_active;
+};
+
+/// Makes @a _collector the active collector of the current thread while in scope.
+/// If @a _collector is nullptr, nothing is recorded while in scope.
+class ScopedStatisticsCollector
+{
+public:
+	explicit ScopedStatisticsCollector(StatisticsCollector* _collector);
+	~ScopedStatisticsCollector();
+
+private:
+	StatisticsCollector* m_previous;
+};
+
+/// Records the resources used while in scope as phase @a _name of the active collector.
+class ScopedPhase
+{
+public:
+	explicit ScopedPhase(char const* _name);
+	~ScopedPhase();
+
+private:
+	StatisticsCollector* m_collector;
+	char const* m_name;
+	std::chrono::steady_clock::time_point m_wallStart;
+	double m_cpuStart = 0;
+};
+
+/// Increments counter @a _name of the active collector by @a _amount.
+inline void countEvent(char const* _name, size_t _amount = 1)
+{
+	if (StatisticsCollector* collector = StatisticsCollector::active())
+		collector->counters[_name] += _amount;
+}
+
+}
@@ -29,6 +29,8 @@
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
 
+#include <libdevcore/Statistics.h>
+
 #include <fstream>
 #include <json/json.h>
 
@@ -115,7 +117,7 @@ namespace
 
 string locationFromSources(StringMap const& _sourceCodes, SourceLocation const& _location)
 {
-	if (_location.isEmpty() || !_location.source.get() || _sourceCodes.empty() || _location.start >= _location.end || _location.start < 0)
+	if (_location.isEmpty() || !_location.source || _sourceCodes.empty() || _location.start >= _location.end || _location.start < 0)
 		return "";
 
 	auto it = _sourceCodes.find(_location.source->name());
@@ -385,6 +387,7 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 
 Assembly& Assembly::optimise(OptimiserSettings const& _settings)
 {
+	ScopedPhase phase("evmOptimiser");
 	optimiseInternal(_settings, {});
 	return *this;
 }
@@ -413,6 +416,7 @@ map<u256, u256> Assembly::optimiseInternal(
 	for (unsigned count = 1; count > 0;)
 	{
 		count = 0;
+		countEvent("evmOptimiserRounds");
 
 		if (_settings.runJumpdestRemover)
 		{
@@ -53,9 +53,192 @@
 #include <liblangutil/CharStream.h>
 #include <liblangutil/Exceptions.h>
 
+#include <libdevcore/CommonIO.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 using namespace std;
 using namespace langutil;
 
+namespace
+{
+
+/// Number of consecutive indices whose streams are stored in one chunk of the stream table.
+size_t constexpr c_chunkSize = 1024;
+
+/// The streams of c_chunkSize consecutive indices. A chunk is reused for other indices once
+/// all of its streams have been destroyed, so lookups check its first index before and after
+/// reading a stream.
+struct StreamChunk
+{
+	atomic<uint32_t> firstIndex{0};
+	array<atomic<CharStream const*>, c_chunkSize> streams{};
+	/// Number of streams of this chunk that have been destroyed. Guarded by the table mutex.
+	size_t released = 0;
+};
+
+/// The streams that currently exist, by index. Indices are not reused, such that source
+/// locations that outlive their stream do not resolve to a different one.
+/// Lookups do not lock: directories and chunks are never freed, only chunks are reused.
+struct StreamTable
+{
+	/// The chunk of each range of indices, or nullptr if the range is not used (anymore).
+	using Directory = vector<atomic<StreamChunk*>>;
+
+	/// Guards all modifications of the table.
+	mutex tableMutex;
+	atomic<Directory*> directory{nullptr};
+	/// Owns all directories, including replaced ones, which lookups may still use.
+	vector<unique_ptr<Directory>> directories;
+	/// Owns all chunks.
+	vector<unique_ptr<StreamChunk>> chunks;
+	/// Chunks whose streams have all been destroyed.
+	vector<StreamChunk*> freeChunks;
+	uint32_t lastIndex = 0;
+};
+
+StreamTable& streamTable()
+{
+	// Never destroyed, streams with static storage duration may outlive it otherwise.
+	static StreamTable* table = new StreamTable();
+	return *table;
+}
+
+}
+
+CharStream::CharStream(string _source, string _name):
+	m_name(std::move(_name))
+{
+	auto source = make_shared<string const>(std::move(_source));
+	m_source = *source;
+	m_owner = std::move(source);
+	registerStream();
+}
+
+CharStream& CharStream::operator=(CharStream const& _other)
+{
+	m_owner = _other.m_owner;
+	m_source = _other.m_source;
+	m_name = _other.m_name;
+	m_position = _other.m_position;
+	lock_guard<mutex> lock(m_lineStartsMutex);
+	m_lineStarts.reset();
+	return *this;
+}
+
+CharStream& CharStream::operator=(CharStream&& _other)
+{
+	m_owner = std::move(_other.m_owner);
+	m_source = std::exchange(_other.m_source, {});
+	m_name = std::move(_other.m_name);
+	m_position = _other.m_position;
+	lock_guard<mutex> lock(m_lineStartsMutex);
+	m_lineStarts.reset();
+	return *this;
+}
+
+CharStream::~CharStream()
+{
+	StreamTable& table = streamTable();
+	lock_guard<mutex> lock(table.tableMutex);
+	size_t chunkIndex = m_index / c_chunkSize;
+	atomic<StreamChunk*>& entry = (*table.directory.load(memory_order_relaxed))[chunkIndex];
+	StreamChunk* chunk = entry.load(memory_order_relaxed);
+	chunk->streams[m_index % c_chunkSize].store(nullptr, memory_order_release);
+	// Index zero is never used.
+	if (++chunk->released == (chunkIndex == 0 ? c_chunkSize - 1 : c_chunkSize))
+	{
+		entry.store(nullptr, memory_order_release);
+		table.freeChunks.push_back(chunk);
+	}
+}
+
+CharStream CharStream::fromFile(string const& _path, string _name)
+{
+	namespace ip = boost::interprocess;
+	try
+	{
+		ip::file_mapping file(_path.c_str(), ip::read_only);
+		auto region = make_shared<ip::mapped_region const>(file, ip::read_only);
+		string_view source(static_cast<char const*>(region->get_address()), region->get_size());
+		return CharStream(source, std::move(region), std::move(_name));
+	}
+	catch (ip::interprocess_exception const&)
+	{
+		// Empty files cannot be mapped.
+		return CharStream(dev::readFileAsString(_path), std::move(_name));
+	}
+}
+
+CharStream const* CharStream::fromIndex(uint32_t _index)
+{
+	StreamTable::Directory const* directory = streamTable().directory.load(memory_order_acquire);
+	size_t chunkIndex = _index / c_chunkSize;
+	if (!directory || chunkIndex >= directory->size())
+		return nullptr;
+	StreamChunk const* chunk = (*directory)[chunkIndex].load(memory_order_acquire);
+	uint32_t firstIndex = _index - _index % c_chunkSize;
+	if (!chunk || chunk->firstIndex.load(memory_order_acquire) != firstIndex)
+		return nullptr;
+	CharStream const* stream = chunk->streams[_index % c_chunkSize].load(memory_order_acquire);
+	// The chunk may have been reused for other indices in the meantime.
+	if (chunk->firstIndex.load(memory_order_acquire) != firstIndex)
+		return nullptr;
+	return stream;
+}
+
+void CharStream::registerStream()
+{
+	StreamTable& table = streamTable();
+	lock_guard<mutex> lock(table.tableMutex);
+	solAssert(table.lastIndex < numeric_limits<uint32_t>::max(), "Too many char streams.");
+	m_index = ++table.lastIndex;
+	size_t chunkIndex = m_index / c_chunkSize;
+
+	StreamTable::Directory* directory = table.directory.load(memory_order_relaxed);
+	if (!directory || chunkIndex >= directory->size())
+	{
+		size_t oldSize = directory ? directory->size() : 0;
+		auto grown = make_unique<StreamTable::Directory>(max<size_t>({2 * oldSize, chunkIndex + 1, 16}));
+		for (size_t i = 0; i < oldSize; ++i)
+			(*grown)[i].store((*directory)[i].load(memory_order_relaxed), memory_order_relaxed);
+		directory = table.directories.emplace_back(std::move(grown)).get();
+		table.directory.store(directory, memory_order_release);
+	}
+
+	StreamChunk* chunk = (*directory)[chunkIndex].load(memory_order_relaxed);
+	if (!chunk)
+	{
+		if (table.freeChunks.empty())
+			chunk = table.chunks.emplace_back(make_unique<StreamChunk>()).get();
+		else
+		{
+			chunk = table.freeChunks.back();
+			table.freeChunks.pop_back();
+			chunk->released = 0;
+		}
+		chunk->firstIndex.store(static_cast<uint32_t>(chunkIndex * c_chunkSize), memory_order_release);
+		(*directory)[chunkIndex].store(chunk, memory_order_release);
+	}
+	chunk->streams[m_index % c_chunkSize].store(this, memory_order_release);
+}
+
+CharStream const* CharStreamReference::operator->() const
+{
+	CharStream const* stream = get();
+	solAssert(stream, "Source location refers to a char stream that does not exist.");
+	return stream;
+}
+
 char CharStream::advanceAndGet(size_t _chars)
 {
 	if (isPastEndOfInput())
@@ -83,33 +266,36 @@ char CharStream::setPosition(size_t _location)
 string CharStream::lineAtPosition(int _position) const
 {
 	// if _position points to \n, it returns the line before the \n
-	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
-	if (searchStart > 0)
-		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
-	if (lineStart == string::npos)
-		lineStart = 0;
-	else
-		lineStart++;
-	return m_source.substr(
-		lineStart,
-		min(m_source.find('\n', lineStart), m_source.size()) - lineStart
-	);
+	vector<size_t> const& starts = lineStarts();
+	size_t line = lineOf(min<size_t>(m_source.size(), _position));
+	size_t lineStart = starts[line];
+	size_t lineEnd = line + 1 < starts.size() ? starts[line + 1] - 1 : m_source.size();
+	return string(m_source.substr(lineStart, lineEnd - lineStart));
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
-	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
-	size_type lineStart;
-	if (searchPosition == 0)
-		lineStart = 0;
-	else
+	size_t searchPosition = min<size_t>(m_source.size(), _position);
+	size_t line = lineOf(searchPosition);
+	return tuple<int, int>(line, searchPosition - lineStarts()[line]);
+}
+
+vector<size_t> const& CharStream::lineStarts() const
+{
+	lock_guard<mutex> lock(m_lineStartsMutex);
+	if (!m_lineStarts)
 	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
-		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
+		m_lineStarts = make_unique<vector<size_t>>();
+		m_lineStarts->push_back(0);
+		for (size_t i = 0; i < m_source.size(); ++i)
+			if (m_source[i] == '\n')
+				m_lineStarts->push_back(i + 1);
 	}
-	return tuple<int, int>(lineNumber, searchPosition - lineStart);
+	return *m_lineStarts;
+}
+
+size_t CharStream::lineOf(size_t _position) const
+{
+	vector<size_t> const& starts = lineStarts();
+	return size_t(upper_bound(starts.begin(), starts.end(), _position) - starts.begin()) - 1;
 }
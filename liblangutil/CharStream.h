@@ -52,9 +52,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 namespace langutil
 {
@@ -63,18 +69,53 @@ namespace langutil
  * Bidirectional stream of characters.
  *
  * This CharStream is used by lexical analyzers as the source.
+ * The source text is immutable and shared by all copies of a stream, it is either owned by
+ * the stream or a view of memory kept alive by an owner, for example a memory-mapped file.
+ * Every char stream is registered under an index for as long as it exists, so that source
+ * locations can refer to it by that index instead of owning it.
  */
 class CharStream
 {
 public:
-	CharStream() = default;
-	explicit CharStream(std::string const& _source, std::string const& name):
-		m_source(_source), m_name(name) {}
+	CharStream() { registerStream(); }
+	explicit CharStream(std::string _source, std::string _name);
+	/// Creates a stream over @a _source, which has to stay unchanged as long as @a _owner exists.
+	CharStream(std::string_view _source, std::shared_ptr<void const> _owner, std::string _name):
+		m_owner(std::move(_owner)), m_source(_source), m_name(std::move(_name)) { registerStream(); }
+	/// Copies share the source text.
+	CharStream(CharStream const& _other):
+		m_owner(_other.m_owner), m_source(_other.m_source), m_name(_other.m_name), m_position(_other.m_position) { registerStream(); }
+	CharStream(CharStream&& _other):
+		m_owner(std::move(_other.m_owner)),
+		m_source(std::exchange(_other.m_source, {})),
+		m_name(std::move(_other.m_name)),
+		m_position(_other.m_position)
+	{
+		registerStream();
+	}
+	/// Assignment keeps the index of this stream.
+	CharStream& operator=(CharStream const& _other);
+	CharStream& operator=(CharStream&& _other);
+	~CharStream();
+
+	/// @returns a stream over the content of the file @a _path, which is mapped into memory
+	/// if possible and read otherwise. The file must not be modified while the stream or
+	/// one of its copies exists.
+	static CharStream fromFile(std::string const& _path, std::string _name);
+
+	/// @returns the index of this stream, which is unique among all streams ever created.
+	uint32_t index() const noexcept { return m_index; }
+	/// @returns the stream with the index @a _index or nullptr if it does not exist (anymore).
+	static CharStream const* fromIndex(uint32_t _index);
 
 	int position() const { return m_position; }
 	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
 
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	/// @returns the character @a _charsForward characters after the current position or 0 past the end of input.
+	char get(size_t _charsForward = 0) const
+	{
+		return isPastEndOfInput(_charsForward) ? 0 : m_source[m_position + _charsForward];
+	}
 	char advanceAndGet(size_t _chars = 1);
 	/// Sets scanner position to @ _amount characters backwards in source text.
 	/// @returns The character of the current location after update is returned.
@@ -86,21 +127,63 @@ public:
 
 	void reset() { m_position = 0; }
 
-	std::string const& source() const noexcept { return m_source; }
+	std::string_view source() const noexcept { return m_source; }
 	std::string const& name() const noexcept { return m_name; }
 
 	///@{
 	///@name Error printing helper functions
-	/// Functions that help pretty-printing parse errors
-	/// Do only use in error cases, they are quite expensive.
+	/// Functions that help pretty-printing parse errors.
+	/// They use an index of the line starts that is built on first use, so that
+	/// translating a position takes logarithmic time in the number of lines.
 	std::string lineAtPosition(int _position) const;
 	std::tuple<int, int> translatePositionToLineColumn(int _position) const;
 	///@}
 
 private:
-	std::string m_source;
+	void registerStream();
+	/// @returns the offsets of the first characters of all lines, building them on first use.
+	std::vector<size_t> const& lineStarts() const;
+	/// @returns the zero-based line of @a _position, which has to be at most the source size.
+	size_t lineOf(size_t _position) const;
+
+	/// Keeps the memory m_source refers to alive.
+	std::shared_ptr<void const> m_owner;
+	std::string_view m_source;
 	std::string m_name;
 	size_t m_position{0};
+	uint32_t m_index = 0;
+
+	/// Protects m_lineStarts, which is built lazily and may be requested from several threads.
+	mutable std::mutex m_lineStartsMutex;
+	mutable std::unique_ptr<std::vector<size_t>> m_lineStarts;
+};
+
+/**
+ * Reference to a char stream by its index. It does not keep the stream alive and
+ * resolves to nullptr once the stream is destroyed.
+ */
+class CharStreamReference
+{
+public:
+	CharStreamReference() = default;
+	CharStreamReference(std::nullptr_t) {}
+	CharStreamReference(CharStream const& _stream): m_index(_stream.index()) {}
+	CharStreamReference(std::shared_ptr<CharStream> const& _stream): m_index(_stream ? _stream->index() : 0) {}
+
+	/// @returns the referenced stream or nullptr if it is not set or does not exist anymore.
+	CharStream const* get() const { return m_index ? CharStream::fromIndex(m_index) : nullptr; }
+	CharStream const* operator->() const;
+	/// @returns true if the referenced stream exists.
+	explicit operator bool() const { return get() != nullptr; }
+
+	/// @returns the index of the referenced stream or zero if it is not set.
+	uint32_t index() const noexcept { return m_index; }
+
+	bool operator==(CharStreamReference const& _other) const { return m_index == _other.m_index; }
+	bool operator!=(CharStreamReference const& _other) const { return m_index != _other.m_index; }
+
+private:
+	uint32_t m_index = 0;
 };
 
 }
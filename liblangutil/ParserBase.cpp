@@ -49,7 +49,7 @@ Token ParserBase::peekNextToken() const
 
 string ParserBase::currentLiteral() const
 {
-	return m_scanner->currentLiteral();
+	return string(m_scanner->currentLiteral());
 }
 
 Token ParserBase::advance()
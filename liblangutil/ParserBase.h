@@ -45,7 +45,7 @@ public:
 		m_parserErrorRecovery = _parserErrorRecovery;
 	}
 
-	std::shared_ptr<CharStream> source() const { return m_scanner->charStream(); }
+	CharStreamReference source() const { return *m_scanner->charStream(); }
 
 protected:
 	/// Utility class that creates an error and throws an exception if the
@@ -55,6 +55,8 @@
 #include <liblangutil/Scanner.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <optional>
 #include <ostream>
 #include <tuple>
@@ -110,18 +112,21 @@ public:
 		m_complete(false)
 	{
 		if (_type == LITERAL_TYPE_COMMENT)
-			m_scanner->m_nextSkippedComment.literal.clear();
+			m_scanner->m_commentLiteral.clear();
 		else
-			m_scanner->m_nextToken.literal.clear();
+		{
+			m_scanner->m_literal.clear();
+			m_scanner->m_literalStart = m_scanner->sourcePos();
+		}
 	}
 	~LiteralScope()
 	{
 		if (!m_complete)
 		{
 			if (m_type == LITERAL_TYPE_COMMENT)
-				m_scanner->m_nextSkippedComment.literal.clear();
+				m_scanner->m_commentLiteral.clear();
 			else
-				m_scanner->m_nextToken.literal.clear();
+				m_scanner->m_literal.clear();
 		}
 	}
 	void complete() { m_complete = true; }
@@ -134,6 +139,73 @@ private:
 
 }
 
+namespace
+{
+
+/// Set of bytes with a constant time membership test.
+class ByteSet
+{
+public:
+	template <class Predicate>
+	constexpr explicit ByteSet(Predicate _contains)
+	{
+		for (size_t byte = 0; byte < m_contains.size(); ++byte)
+			m_contains[byte] = _contains(uint8_t(byte));
+	}
+	bool contains(char _c) const { return m_contains[uint8_t(_c)]; }
+
+private:
+	std::array<bool, 256> m_contains{};
+};
+
+constexpr bool isLineBreakStart(uint8_t _c)
+{
+	// Line feed, vertical tab, form feed, carriage return and the first bytes of NEL, LS and PS.
+	return (0x0a <= _c && _c <= 0x0d) || _c == 0xc2 || _c == 0xe2;
+}
+
+/// The characters that end a run of whitespace.
+constexpr ByteSet c_nonWhiteSpace{[](uint8_t _c) { return _c != ' ' && _c != '\n' && _c != '\t' && _c != '\r'; }};
+/// The characters a single line comment can end at.
+constexpr ByteSet c_lineBreakStarts{isLineBreakStart};
+/// The characters that need attention inside a multi-line documentation comment.
+constexpr ByteSet c_docCommentSpecial{[](uint8_t _c) { return _c == '\n' || _c == '\r' || _c == '*'; }};
+/// The characters that need attention inside a string literal.
+constexpr ByteSet c_stringSpecial{[](uint8_t _c) {
+	return _c == '"' || _c == '\'' || _c == '\\' || isLineBreakStart(_c);
+}};
+
+/// Moves @a _source forward to the first character at or after its position that is in @a _stop,
+/// or to the end of the input, and @returns the number of characters skipped.
+/// This runs over the source text directly instead of advancing character by character.
+size_t skipUntil(CharStream& _source, ByteSet const& _stop)
+{
+	string_view const text = _source.source();
+	size_t const start = _source.position();
+	size_t position = start;
+	while (position < text.size() && !_stop.contains(text[position]))
+		++position;
+	if (position != start)
+		_source.setPosition(position);
+	return position - start;
+}
+
+/// Moves @a _source forward to the next occurrence of @a _char, or to the end of the input,
+/// and @returns the number of characters skipped.
+size_t skipUntil(CharStream& _source, char _char)
+{
+	string_view const text = _source.source();
+	size_t const start = _source.position();
+	if (start >= text.size())
+		return 0;
+	void const* found = memchr(text.data() + start, _char, text.size() - start);
+	size_t const position = found ? size_t(static_cast<char const*>(found) - text.data()) : text.size();
+	_source.setPosition(position);
+	return position - start;
+}
+
+}
+
 void Scanner::reset(CharStream _source)
 {
 	m_source = make_shared<CharStream>(std::move(_source));
@@ -151,23 +223,129 @@ void Scanner::reset()
 {
 	m_source->reset();
 	m_supportPeriodInIdentifier = false;
-	m_char = m_source->get();
-	skipWhitespace();
-	next();
-	next();
+	m_tokens.clear();
+	m_comments.clear();
+	m_decodedLiterals.clear();
+	m_currentIndex = 0;
+	m_tokensContiguous = true;
+	rescanFrom(0, 0);
+	descAhead(1);
 }
 
 void Scanner::setPosition(size_t _offset)
 {
-	m_char = m_source->setPosition(_offset);
-	scanToken();
-	next();
+	if (m_tokensContiguous)
+	{
+		auto token = lower_bound(
+			m_tokens.begin(),
+			m_tokens.end(),
+			int(_offset),
+			[](TokenDesc const& _token, int _offset) { return _token.start < _offset; }
+		);
+		if (token != m_tokens.end() && token->start == int(_offset))
+		{
+			m_currentIndex = size_t(token - m_tokens.begin());
+			descAhead(1);
+			return;
+		}
+		m_tokensContiguous = m_currentIndex == 0 ? _offset == 0 : m_tokens[m_currentIndex - 1].end == int(_offset);
+	}
+	rescanFrom(m_currentIndex, _offset);
+	descAhead(1);
+}
+
+void Scanner::applyEdit(size_t _start, size_t _end, string_view _replacement)
+{
+	string_view const oldSource = source();
+	solAssert(_start <= _end && _end <= oldSource.size(), "Invalid edit range.");
+	string newSource;
+	newSource.reserve(oldSource.size() - (_end - _start) + _replacement.size());
+	newSource.append(oldSource.substr(0, _start));
+	newSource.append(_replacement);
+	newSource.append(oldSource.substr(_end));
+	// Copies share the old source text and keep it alive until the tokens are moved.
+	CharStream const oldStream = *m_source;
+	*m_source = CharStream(std::move(newSource), oldStream.name());
+	if (!m_tokensContiguous)
+	{
+		reset();
+		return;
+	}
+
+	int const delta = int(_replacement.size()) - int(_end - _start);
+	// The token that ends where the edit starts can be extended by it and
+	// the token before can depend on up to two characters after its end.
+	size_t first = size_t(partition_point(
+		m_tokens.begin(),
+		m_tokens.end(),
+		[&](TokenDesc const& _token) { return _token.end < int(_start); }
+	) - m_tokens.begin());
+	if (first > 0)
+		--first;
+	size_t const restart = first == 0 ? 0 : size_t(m_tokens[first - 1].end);
+
+	vector<TokenDesc> oldTokens = std::move(m_tokens);
+	vector<CommentDesc> oldComments = std::move(m_comments);
+	m_tokens.assign(oldTokens.begin(), oldTokens.begin() + ptrdiff_t(first));
+	for (size_t i = first; i > 0; --i)
+		if (m_tokens[i - 1].comment != TokenDesc::noComment)
+		{
+			m_comments.assign(oldComments.begin(), oldComments.begin() + ptrdiff_t(m_tokens[i - 1].comment + 1));
+			break;
+		}
+
+	m_currentIndex = first;
+	m_supportPeriodInIdentifier = false;
+	m_char = m_source->setPosition(restart);
+	while (true)
+	{
+		scanToken();
+		TokenDesc const& token = m_tokens.back();
+		if (token.token == Token::EOS)
+			break;
+		if (token.end < int(_start + _replacement.size()))
+			continue;
+		// The tokens after the first one that ends where a previous token ended are unchanged.
+		int const oldEnd = token.end - delta;
+		auto match = lower_bound(
+			oldTokens.begin() + ptrdiff_t(first),
+			oldTokens.end(),
+			oldEnd,
+			[](TokenDesc const& _token, int _end) { return _token.end < _end; }
+		);
+		if (match != oldTokens.end() && match->end == oldEnd)
+		{
+			for (auto it = std::next(match); it != oldTokens.end(); ++it)
+			{
+				TokenDesc& moved = m_tokens.emplace_back(*it);
+				moved.start += delta;
+				moved.end += delta;
+				if (!moved.decodedLiteral && moved.literalSize > 0)
+					moved.literalOffset = uint32_t(int(moved.literalOffset) + delta);
+				if (moved.comment != TokenDesc::noComment)
+				{
+					CommentDesc& comment = m_comments.emplace_back(oldComments[moved.comment]);
+					comment.start += delta;
+					comment.end += delta;
+					moved.comment = uint32_t(m_comments.size() - 1);
+				}
+			}
+			break;
+		}
+		// The remaining tokens were not needed before, so they are scanned on demand.
+		if (match == oldTokens.end() && oldTokens.back().token != Token::EOS)
+			break;
+	}
+	if (m_tokens.back().token != Token::EOS)
+		m_char = m_source->setPosition(size_t(m_tokens.back().end));
+	m_currentIndex = 0;
+	descAhead(1);
 }
 
 void Scanner::supportPeriodInIdentifier(bool _value)
 {
 	m_supportPeriodInIdentifier = _value;
-	rescan();
+	descAhead(1);
 }
 
 bool Scanner::scanHexByte(char& o_scannedByte)
@@ -223,16 +401,53 @@ void Scanner::addUnicodeAsUTF8(unsigned codepoint)
 	}
 }
 
-void Scanner::rescan()
+void Scanner::rescanToken(size_t _index)
 {
-	size_t rollbackTo = 0;
-	if (m_skippedComment.literal.empty())
-		rollbackTo = m_currentToken.location.start;
+	TokenDesc const& token = m_tokens[_index];
+	if (token.comment == TokenDesc::noComment)
+		rescanFrom(_index, size_t(token.start));
 	else
-		rollbackTo = m_skippedComment.location.start;
-	m_char = m_source->rollback(size_t(m_source->position()) - rollbackTo);
-	next();
-	next();
+		rescanFrom(_index, size_t(m_comments[token.comment].start));
+}
+
+void Scanner::rescanFrom(size_t _index, size_t _offset)
+{
+	// Comments are stored in the order of their tokens, so those of the dropped tokens are the last ones.
+	for (size_t i = _index; i < m_tokens.size(); ++i)
+		if (m_tokens[i].comment != TokenDesc::noComment)
+		{
+			m_comments.resize(m_tokens[i].comment);
+			break;
+		}
+	m_tokens.resize(_index);
+	m_char = m_source->setPosition(_offset);
+	scanToken();
+}
+
+bool Scanner::needsRescan(TokenDesc const& _token) const
+{
+	if (_token.periodInIdentifier == m_supportPeriodInIdentifier)
+		return false;
+	string_view const text = source();
+	if (!isIdentifierStart(text[size_t(_token.start)]))
+		return false;
+	return
+		text.substr(size_t(_token.start), size_t(_token.end - _token.start)).find('.') != string_view::npos ||
+		(size_t(_token.end) < text.size() && text[size_t(_token.end)] == '.');
+}
+
+SourceLocation Scanner::currentCommentLocation() const
+{
+	uint32_t comment = currentDesc().comment;
+	if (comment == TokenDesc::noComment)
+		return {};
+	return SourceLocation{m_comments[comment].start, m_comments[comment].end, {}};
+}
+
+string_view Scanner::currentCommentLiteral() const
+{
+	uint32_t comment = currentDesc().comment;
+	return comment == TokenDesc::noComment ? string_view{} : m_comments[comment].literal;
 }
 
 // Ensure that tokens can be stored in a byte.
@@ -240,11 +455,45 @@ BOOST_STATIC_ASSERT(TokenTraits::count() <= 0x100);
 
 Token Scanner::next()
 {
-	m_currentToken = m_nextToken;
-	m_skippedComment = m_nextSkippedComment;
-	scanToken();
+	if (currentDesc().token != Token::EOS)
+		++m_currentIndex;
+	descAhead(1);
+	return currentDesc().token;
+}
 
-	return m_currentToken.token;
+Scanner::TokenDesc const& Scanner::descAhead(size_t _ahead)
+{
+	for (size_t index = m_currentIndex; ; ++index)
+	{
+		if (needsRescan(m_tokens[index]))
+			rescanToken(index);
+		if (index == m_currentIndex + _ahead || m_tokens[index].token == Token::EOS)
+			return m_tokens[index];
+		if (index + 1 == m_tokens.size())
+			scanToken();
+	}
+}
+
+string_view Scanner::literal(TokenDesc const& _token) const
+{
+	if (_token.decodedLiteral)
+		return m_decodedLiterals[_token.literalOffset];
+	return source().substr(_token.literalOffset, _token.literalSize);
+}
+
+void Scanner::storeLiteral(string const& _literal, size_t _sourceOffset)
+{
+	m_newToken.literalSize = uint32_t(_literal.size());
+	if (_literal.empty())
+		return;
+	if (source().substr(_sourceOffset, _literal.size()) == _literal)
+		m_newToken.literalOffset = uint32_t(_sourceOffset);
+	else
+	{
+		m_newToken.decodedLiteral = true;
+		m_newToken.literalOffset = uint32_t(m_decodedLiterals.size());
+		m_decodedLiterals.emplace_back(_literal);
+	}
 }
 
 Token Scanner::selectToken(char _next, Token _then, Token _else)
@@ -259,8 +508,13 @@ Token Scanner::selectToken(char _next, Token _then, Token _else)
 bool Scanner::skipWhitespace()
 {
 	int const startPosition = sourcePos();
-	while (isWhiteSpace(m_char))
+	if (isWhiteSpace(m_char))
+	{
+		// The current character is not necessarily the one in the source (see skipMultiLineComment).
 		advance();
+		if (skipUntil(*m_source, c_nonWhiteSpace))
+			m_char = m_source->get();
+	}
 	// Return whether or not we skipped any characters.
 	return sourcePos() != startPosition;
 }
@@ -275,8 +529,13 @@ Token Scanner::skipSingleLineComment()
 {
 	// Line terminator is not part of the comment. If it is a
 	// non-ascii line terminator, it will result in a parser error.
-	while (!isUnicodeLinebreak())
-		if (!advance()) break;
+	while (true)
+	{
+		if (skipUntil(*m_source, c_lineBreakStarts))
+			m_char = m_source->get();
+		if (isUnicodeLinebreak() || !advance())
+			break;
+	}
 
 	return Token::Whitespace;
 }
@@ -313,6 +572,14 @@ Token Scanner::scanSingleLineDocComment()
 
 	while (!isSourcePastEndOfInput())
 	{
+		int const runStart = sourcePos();
+		if (size_t runLength = skipUntil(*m_source, c_lineBreakStarts))
+		{
+			m_char = m_source->get();
+			m_commentLiteral.append(m_source->source(), runStart, runLength);
+			if (isSourcePastEndOfInput())
+				break;
+		}
 		if (tryScanEndOfLine())
 		{
 			// check if next line is also a documentation comment
@@ -344,6 +611,8 @@ Token Scanner::skipMultiLineComment()
 	advance();
 	while (!isSourcePastEndOfInput())
 	{
+		if (skipUntil(*m_source, '*'))
+			m_char = m_source->get();
 		char ch = m_char;
 		advance();
 
@@ -371,6 +640,15 @@ Token Scanner::scanMultiLineDocComment()
 
 	while (!isSourcePastEndOfInput())
 	{
+		int const runStart = sourcePos();
+		if (size_t runLength = skipUntil(*m_source, c_docCommentSpecial))
+		{
+			m_char = m_source->get();
+			m_commentLiteral.append(m_source->source(), runStart, runLength);
+			charsAdded = true;
+			if (isSourcePastEndOfInput())
+				break;
+		}
 		//handle newlines in multline comments
 		if (atEndOfLine())
 		{
@@ -424,11 +702,9 @@ Token Scanner::scanSlash()
 		else if (m_char == '/')
 		{
 			// doxygen style /// comment
-			Token comment;
-			m_nextSkippedComment.location.start = firstSlashPosition;
-			comment = scanSingleLineDocComment();
-			m_nextSkippedComment.location.end = sourcePos();
-			m_nextSkippedComment.token = comment;
+			m_newComment.start = firstSlashPosition;
+			scanSingleLineDocComment();
+			m_newComment.end = sourcePos();
 			return Token::Whitespace;
 		}
 		else
@@ -450,11 +726,9 @@ Token Scanner::scanSlash()
 				return Token::Whitespace;
 			}
 			// we actually have a multiline documentation comment
-			Token comment;
-			m_nextSkippedComment.location.start = firstSlashPosition;
-			comment = scanMultiLineDocComment();
-			m_nextSkippedComment.location.end = sourcePos();
-			m_nextSkippedComment.token = comment;
+			m_newComment.start = firstSlashPosition;
+			Token comment = scanMultiLineDocComment();
+			m_newComment.end = sourcePos();
 			if (comment == Token::Illegal)
 				return Token::Illegal; // error already set
 			else
@@ -471,20 +745,18 @@ Token Scanner::scanSlash()
 
 void Scanner::scanToken()
 {
-	m_nextToken.error = ScannerError::NoError;
-	m_nextToken.literal.clear();
-	m_nextToken.extendedTokenInfo = make_tuple(0, 0);
-	m_nextSkippedComment.literal.clear();
-	m_nextSkippedComment.extendedTokenInfo = make_tuple(0, 0);
+	m_newToken = TokenDesc{};
+	m_literal.clear();
+	m_commentLiteral.clear();
 
 	Token token;
 	// M and N are for the purposes of grabbing different type sizes
-	unsigned m;
-	unsigned n;
+	unsigned m = 0;
+	unsigned n = 0;
 	do
 	{
 		// Remember the position of the next token
-		m_nextToken.location.start = sourcePos();
+		m_newToken.start = sourcePos();
 		switch (m_char)
 		{
 		case '"':
@@ -679,9 +951,19 @@ void Scanner::scanToken()
 		// whitespace.
 	}
 	while (token == Token::Whitespace);
-	m_nextToken.location.end = sourcePos();
-	m_nextToken.token = token;
-	m_nextToken.extendedTokenInfo = make_tuple(m, n);
+	m_newToken.end = sourcePos();
+	m_newToken.token = token;
+	m_newToken.firstSize = uint16_t(m);
+	m_newToken.secondSize = uint16_t(n);
+	m_newToken.periodInIdentifier = m_supportPeriodInIdentifier;
+	storeLiteral(m_literal, m_literalStart);
+	if (!m_commentLiteral.empty())
+	{
+		m_newComment.literal = m_decodedLiterals.emplace_back(m_commentLiteral);
+		m_newToken.comment = uint32_t(m_comments.size());
+		m_comments.push_back(m_newComment);
+	}
+	m_tokens.push_back(m_newToken);
 }
 
 bool Scanner::scanEscape()
@@ -762,6 +1044,13 @@ Token Scanner::scanString()
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
 	while (m_char != quote && !isSourcePastEndOfInput() && !isUnicodeLinebreak())
 	{
+		int const runStart = sourcePos();
+		if (size_t runLength = skipUntil(*m_source, c_stringSpecial))
+		{
+			m_char = m_source->get();
+			m_literal.append(m_source->source(), runStart, runLength);
+			continue;
+		}
 		char c = m_char;
 		advance();
 		if (c == '\\')
@@ -931,5 +1220,5 @@ tuple<Token, unsigned, unsigned> Scanner::scanIdentifierOrKeyword()
 	while (isIdentifierPart(m_char) || (m_char == '.' && m_supportPeriodInIdentifier))
 		addLiteralCharAndAdvance();
 	literal.complete();
-	return TokenTraits::fromIdentifierOrKeyword(m_nextToken.literal);
+	return TokenTraits::fromIdentifierOrKeyword(m_literal);
 }
@@ -58,8 +58,12 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonData.h>
 
+#include <deque>
 #include <optional>
 #include <iosfwd>
+#include <limits>
+#include <string_view>
+#include <vector>
 
 namespace langutil
 {
@@ -88,16 +92,26 @@ enum class ScannerError
 std::string to_string(ScannerError _errorCode);
 std::ostream& operator<<(std::ostream& os, ScannerError _errorCode);
 
+/**
+ * Scanner that keeps the tokens it produced for its source in an array, together with their
+ * literals as views of the source text, such that looking ahead any number of tokens only
+ * scans them once. Tokens are scanned on demand, because the tokens that follow inline
+ * assembly depend on whether periods are allowed in identifiers.
+ * Edits of the source only scan the tokens again that the edit can change, see applyEdit().
+ */
 class Scanner
 {
 	friend class LiteralScope;
 public:
 	explicit Scanner(std::shared_ptr<CharStream> _source) { reset(std::move(_source)); }
 	explicit Scanner(CharStream _source = CharStream()) { reset(std::move(_source)); }
+	/// Literals are views into the scanner, so it cannot be copied.
+	Scanner(Scanner const&) = delete;
+	Scanner& operator=(Scanner const&) = delete;
 
-	std::string const& source() const noexcept { return m_source->source(); }
+	std::string_view source() const noexcept { return m_source->source(); }
 
-	std::shared_ptr<CharStream> charStream() noexcept { return m_source; }
+	std::shared_ptr<CharStream> const& charStream() const noexcept { return m_source; }
 
 	/// Resets the scanner as if newly constructed with _source as input.
 	void reset(CharStream _source);
@@ -106,47 +120,57 @@ public:
 	void reset();
 
 	/// Enables or disables support for period in identifier.
-	/// This re-scans the current token and comment literal and thus invalidates it.
+	/// The current and all following tokens that are affected by this are scanned again.
 	void supportPeriodInIdentifier(bool _value);
 
 	/// @returns the next token and advances input
 	Token next();
 
-	/// Set scanner to a specific offset. This is used in error recovery.
+	/// Set scanner to a specific offset. This is used in error recovery and to parse parts of
+	/// an edited source again. A token that was scanned at this offset before is reused.
 	void setPosition(size_t _offset);
 
+	/// Replaces the characters from @a _start to @a _end of the source by @a _replacement and
+	/// moves to the start of the input. The char stream keeps its index. Only the tokens from the
+	/// one before the edit up to the first one after it that ends where a previous token ended
+	/// are scanned again, all later tokens are moved by the change in length.
+	/// This invalidates the literals of all tokens.
+	void applyEdit(size_t _start, size_t _end, std::string_view _replacement);
+
 	///@{
 	///@name Information about the current token
 
 	/// @returns the current token
 	Token currentToken() const
 	{
-		return m_currentToken.token;
+		return currentDesc().token;
 	}
 	ElementaryTypeNameToken currentElementaryTypeNameToken() const
 	{
-		unsigned firstSize;
-		unsigned secondSize;
-		std::tie(firstSize, secondSize) = m_currentToken.extendedTokenInfo;
-		return ElementaryTypeNameToken(m_currentToken.token, firstSize, secondSize);
+		TokenDesc const& current = currentDesc();
+		return ElementaryTypeNameToken(current.token, current.firstSize, current.secondSize);
 	}
 
-	SourceLocation currentLocation() const { return m_currentToken.location; }
-	std::string const& currentLiteral() const { return m_currentToken.literal; }
-	std::tuple<unsigned, unsigned> const& currentTokenInfo() const { return m_currentToken.extendedTokenInfo; }
+	SourceLocation currentLocation() const { return currentDesc().location(); }
+	/// @returns the literal of the current token, which stays valid until the scanner is reset or edited.
+	std::string_view currentLiteral() const { return literal(currentDesc()); }
+	std::tuple<unsigned, unsigned> currentTokenInfo() const
+	{
+		return std::make_tuple(currentDesc().firstSize, currentDesc().secondSize);
+	}
 
 	/// Retrieves the last error that occurred during lexical analysis.
 	/// @note If no error occurred, the value is undefined.
-	ScannerError currentError() const noexcept { return m_currentToken.error; }
+	ScannerError currentError() const noexcept { return currentDesc().error; }
 	///@}
 
 	///@{
 	///@name Information about the current comment token
 
-	SourceLocation currentCommentLocation() const { return m_skippedComment.location; }
-	std::string const& currentCommentLiteral() const { return m_skippedComment.literal; }
+	SourceLocation currentCommentLocation() const;
+	std::string_view currentCommentLiteral() const;
 	/// Called by the parser during FunctionDefinition parsing to clear the current comment
-	void clearCurrentCommentLiteral() { m_skippedComment.literal.clear(); }
+	void clearCurrentCommentLiteral() { m_tokens[m_currentIndex].comment = TokenDesc::noComment; }
 
 	///@}
 
@@ -154,9 +178,12 @@ public:
 	///@name Information about the next token
 
 	/// @returns the next token without advancing input.
-	Token peekNextToken() const { return m_nextToken.token; }
-	SourceLocation peekLocation() const { return m_nextToken.location; }
-	std::string const& peekLiteral() const { return m_nextToken.literal; }
+	Token peekNextToken() const { return nextDesc().token; }
+	SourceLocation peekLocation() const { return nextDesc().location(); }
+	std::string_view peekLiteral() const { return literal(nextDesc()); }
+	/// @returns the token @a _ahead tokens after the current one without advancing input,
+	/// scanning it first if it was not needed before.
+	Token peekToken(size_t _ahead) { return descAhead(_ahead).token; }
 	///@}
 
 	///@{
@@ -168,41 +195,80 @@ public:
 	std::string sourceAt(SourceLocation const& _location) const
 	{
 		solAssert(!_location.isEmpty(), "");
-		solAssert(m_source.get() == _location.source.get(), "CharStream memory locations must match.");
-		return m_source->source().substr(_location.start, _location.end - _location.start);
+		solAssert(m_source->index() == _location.source.index(), "CharStream memory locations must match.");
+		return std::string(m_source->source().substr(_location.start, _location.end - _location.start));
 	}
 	///@}
 
 private:
 	inline Token setError(ScannerError _error) noexcept
 	{
-		m_nextToken.error = _error;
+		m_newToken.error = _error;
 		return Token::Illegal;
 	}
 
-	/// Used for the current and look-ahead token and comments
+	/// A scanned token. Its literal is part of the source text if it appears there unchanged
+	/// and an element of m_decodedLiterals otherwise.
 	struct TokenDesc
 	{
-		Token token;
-		SourceLocation location;
-		std::string literal;
+		static constexpr uint32_t noComment = std::numeric_limits<uint32_t>::max();
+
+		SourceLocation location() const { return SourceLocation{start, end, {}}; }
+
+		Token token = Token::EOS;
 		ScannerError error = ScannerError::NoError;
-		std::tuple<unsigned, unsigned> extendedTokenInfo;
+		/// Sizes of elementary type names like bytes8 or fixed128x18.
+		uint16_t firstSize = 0;
+		uint16_t secondSize = 0;
+		/// Whether the token was scanned with support for period in identifier.
+		bool periodInIdentifier = false;
+		/// Whether the literal is an element of m_decodedLiterals.
+		bool decodedLiteral = false;
+		int start = 0;
+		int end = 0;
+		/// Offset of the literal in the source or its index in m_decodedLiterals.
+		uint32_t literalOffset = 0;
+		uint32_t literalSize = 0;
+		/// Index of the documentation comment directly before the token in m_comments or noComment.
+		uint32_t comment = noComment;
 	};
 
+	/// A documentation comment, whose literal always is an element of m_decodedLiterals.
+	struct CommentDesc
+	{
+		int start = 0;
+		int end = 0;
+		std::string_view literal;
+	};
+
+	TokenDesc const& currentDesc() const { return m_tokens[m_currentIndex]; }
+	/// The token after the current one is always scanned, unless the current one ends the input.
+	TokenDesc const& nextDesc() const { return m_tokens[std::min(m_currentIndex + 1, m_tokens.size() - 1)]; }
+	/// @returns the token @a _ahead tokens after the current one, scanning it and the ones before
+	/// it first, or again if they were scanned with a different support for period in identifier.
+	TokenDesc const& descAhead(size_t _ahead);
+	/// Drops the token at @a _index and all following ones and scans one token from @a _offset on.
+	void rescanFrom(size_t _index, size_t _offset);
+	/// Drops the token at @a _index and all following ones and scans it again.
+	void rescanToken(size_t _index);
+	/// @returns true if @a _token would be a different token with the current support for period
+	/// in identifier, which only affects identifiers that contain or are followed by a period.
+	bool needsRescan(TokenDesc const& _token) const;
+	std::string_view literal(TokenDesc const& _token) const;
+	/// Stores @a _literal as the literal of the token that is being scanned, as part of the
+	/// source text if it is found there at @a _sourceOffset.
+	void storeLiteral(std::string const& _literal, size_t _sourceOffset);
+
 	///@{
 	///@name Literal buffer support
-	inline void addLiteralChar(char c) { m_nextToken.literal.push_back(c); }
-	inline void addCommentLiteralChar(char c) { m_nextSkippedComment.literal.push_back(c); }
+	inline void addLiteralChar(char c) { m_literal.push_back(c); }
+	inline void addCommentLiteralChar(char c) { m_commentLiteral.push_back(c); }
 	inline void addLiteralCharAndAdvance() { addLiteralChar(m_char); advance(); }
 	void addUnicodeAsUTF8(unsigned codepoint);
 	///@}
 
 	bool advance() { m_char = m_source->advanceAndGet(); return !m_source->isPastEndOfInput(); }
 	void rollback(int _amount) { m_char = m_source->rollback(_amount); }
-	/// Rolls back to the start of the current token and re-runs the scanner.
-	void rescan();
-
 	inline Token selectErrorToken(ScannerError _err) { advance(); return setError(_err); }
 	inline Token selectToken(Token _tok) { advance(); return _tok; }
 	/// If the next character is _next, advance and return _then, otherwise return _else.
@@ -211,7 +277,7 @@ private:
 	bool scanHexByte(char& o_scannedByte);
 	std::optional<unsigned> scanUnicode();
 
-	/// Scans a single Solidity token.
+	/// Scans a single Solidity token and appends it to the scanned tokens.
 	void scanToken();
 
 	/// Skips all whitespace and @returns true if something was skipped.
@@ -252,11 +318,22 @@ private:
 
 	bool m_supportPeriodInIdentifier = false;
 
-	TokenDesc m_skippedComment;  // desc for current skipped comment
-	TokenDesc m_nextSkippedComment; // desc for next skipped comment
-
-	TokenDesc m_currentToken;  // desc for current token (as returned by Next())
-	TokenDesc m_nextToken;     // desc for next token (one token look-ahead)
+	/// All tokens scanned so far, the last one is not followed by others if it is Token::EOS.
+	std::vector<TokenDesc> m_tokens;
+	/// Index of the current token (as returned by next()) in m_tokens.
+	size_t m_currentIndex = 0;
+	/// Whether every token in m_tokens was scanned directly after the previous one, which is
+	/// only not the case after setPosition() skipped parts of the source.
+	bool m_tokensContiguous = true;
+	std::vector<CommentDesc> m_comments;
+	/// Literals that do not appear unchanged in the source, which keeps them at stable addresses.
+	std::deque<std::string> m_decodedLiterals;
+
+	TokenDesc m_newToken; ///< token that is being scanned
+	std::string m_literal; ///< literal of the token that is being scanned
+	size_t m_literalStart = 0; ///< position of the literal in the source, if it appears there
+	CommentDesc m_newComment; ///< documentation comment before the token that is being scanned
+	std::string m_commentLiteral; ///< literal of that comment
 
 	std::shared_ptr<CharStream> m_source;
 
@@ -43,7 +43,7 @@ struct SourceLocation
 {
 	bool operator==(SourceLocation const& _other) const
 	{
-		return source.get() == _other.source.get() && start == _other.start && end == _other.end;
+		return source == _other.source && start == _other.start && end == _other.end;
 	}
 	bool operator!=(SourceLocation const& _other) const { return !operator==(_other); }
 	inline bool operator<(SourceLocation const& _other) const;
@@ -58,7 +58,7 @@ struct SourceLocation
 		assertThrow(!isEmpty(), SourceLocationError, "Requested text from empty source location.");
 		assertThrow(start <= end, SourceLocationError, "Invalid source location.");
 		assertThrow(end <= int(source->source().length()), SourceLocationError, "Invalid source location.");
-		return source->source().substr(start, end - start);
+		return std::string(source->source().substr(start, end - start));
 	}
 
 	/// @returns the smallest SourceLocation that contains both @param _a and @param _b.
@@ -68,7 +68,7 @@ struct SourceLocation
 	/// @param _b, then start resp. end of the result will be -1 as well).
 	static SourceLocation smallestCovering(SourceLocation _a, SourceLocation const& _b)
 	{
-		if (!_a.source)
+		if (!_a.source.index())
 			_a.source = _b.source;
 
 		if (_a.start < 0)
@@ -83,7 +83,8 @@ struct SourceLocation
 
 	int start = -1;
 	int end = -1;
-	std::shared_ptr<CharStream> source;
+	/// The source the positions refer to. It is not kept alive by the location.
+	CharStreamReference source;
 };
 
 /// Stream output for Location (used e.g. in boost exceptions).
@@ -110,14 +111,14 @@ bool SourceLocation::operator<(SourceLocation const& _other) const
 
 bool SourceLocation::contains(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || source.get() != _other.source.get())
+	if (isEmpty() || _other.isEmpty() || source != _other.source)
 		return false;
 	return start <= _other.start && _other.end <= end;
 }
 
 bool SourceLocation::intersects(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || source.get() != _other.source.get())
+	if (isEmpty() || _other.isEmpty() || source != _other.source)
 		return false;
 	return _other.start < end && start < _other.end;
 }
@@ -43,11 +43,10 @@ SourceReferenceExtractor::Message SourceReferenceExtractor::extract(Exception co
 
 SourceReference SourceReferenceExtractor::extract(SourceLocation const* _location, std::string message)
 {
-	if (!_location || !_location->source.get()) // Nothing we can extract here
+	CharStream const* source = _location ? _location->source.get() : nullptr;
+	if (!source) // Nothing we can extract here
 		return SourceReference::MessageOnly(std::move(message));
 
-	shared_ptr<CharStream> const& source = _location->source;
-
 	LineColumn const interest = source->translatePositionToLineColumn(_location->start);
 	LineColumn start = interest;
 	LineColumn end = source->translatePositionToLineColumn(_location->end);
@@ -23,12 +23,13 @@
 #include <libsolc/libsolc.h>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/Version.h>
-#include <libyul/YulString.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/JSON.h>
 
+#include <atomic>
 #include <cstdlib>
 #include <list>
+#include <mutex>
 #include <string>
 
 #include "license.h"
@@ -37,12 +38,49 @@ using namespace std;
 using namespace dev;
 using namespace solidity;
 
+struct SolidityCompiler
+{
+	explicit SolidityCompiler(ReadCallback::Callback const& _readFile):
+		compiler(_readFile)
+	{
+		compiler.keepAnalysis();
+	}
+
+	StandardCompiler compiler;
+	/// All sources of this compiler in the format of the "sources" field of the standard JSON input.
+	Json::Value sources = Json::objectValue;
+	/// Output of the last compilation.
+	string result;
+	/// Set while a solidity_compiler_* function is using this compiler. Used to reject
+	/// concurrent use instead of racing on sources and result.
+	atomic<bool> inUse{false};
+};
+
 namespace
 {
 
 // The strings in this list must not be resized after they have been added here (via solidity_alloc()), because
 // this may potentially change the pointer that was passed to the caller from solidity_alloc().
 static list<string> solidityAllocations;
+/// Guards solidityAllocations, which read callbacks and compilations on different threads extend.
+static mutex allocationMutex;
+
+/// Output of solidity_compiler_compile() if the compiler is already in use.
+static string const c_compilerInUse = "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"The compiler is already in use by another thread.\",\"formattedMessage\":\"The compiler is already in use by another thread.\"}]}";
+
+/// Marks a SolidityCompiler as in use for its lifetime, if it was not in use already.
+class CompilerUse
+{
+public:
+	explicit CompilerUse(SolidityCompiler& _compiler): m_compiler(_compiler), m_acquired(!_compiler.inUse.exchange(true)) {}
+	~CompilerUse() { if (m_acquired) m_compiler.inUse = false; }
+	/// @returns false if the compiler is used by another thread.
+	bool acquired() const { return m_acquired; }
+
+private:
+	SolidityCompiler& m_compiler;
+	bool m_acquired;
+};
 
 /// Find the equivalent to @p _data in the list of allocations of solidity_alloc(),
 /// removes it from the list and returns its value.
@@ -51,6 +89,7 @@ static list<string> solidityAllocations;
 /// on the caller-side and hence, will call abort() then.
 string takeOverAllocation(char const* _data)
 {
+	lock_guard<mutex> lock(allocationMutex);
 	for (auto iter = begin(solidityAllocations); iter != end(solidityAllocations); ++iter)
 		if (iter->data() == _data)
 		{
@@ -110,6 +149,33 @@ string compile(string _input, CStyleReadFileCallback _readCallback, void* _readC
 	return compiler.compile(move(_input));
 }
 
+/// Adds, replaces or removes (if null) the sources in @p _changes. Ignored if it is not an object.
+void updateSources(Json::Value& _sources, Json::Value const& _changes)
+{
+	if (!_changes.isObject())
+		return;
+	for (auto const& name: _changes.getMemberNames())
+		if (_changes[name].isNull())
+			_sources.removeMember(name);
+		else
+			_sources[name] = _changes[name];
+}
+
+string compile(SolidityCompiler& _compiler, string const& _input)
+{
+	Json::Value input;
+	if (!jsonParseStrict(_input, input) || !input.isObject() || !(input["sources"].isObject() || input["sources"].isNull()))
+	{
+		// Let the compiler report the error.
+		return _compiler.compiler.compile(_input);
+	}
+
+	updateSources(_compiler.sources, input["sources"]);
+	input["sources"] = _compiler.sources;
+
+	return jsonCompactPrint(_compiler.compiler.compile(input));
+}
+
 }
 
 extern "C"
@@ -127,13 +193,16 @@ extern char const* solidity_version() noexcept
 
 extern char* solidity_compile(char const* _input, CStyleReadFileCallback _readCallback, void* _readContext) noexcept
 {
-	return solidityAllocations.emplace_back(compile(_input, _readCallback, _readContext)).data();
+	string output = compile(_input, _readCallback, _readContext);
+	lock_guard<mutex> lock(allocationMutex);
+	return solidityAllocations.emplace_back(move(output)).data();
 }
 
 extern char* solidity_alloc(size_t _size) noexcept
 {
 	try
 	{
+		lock_guard<mutex> lock(allocationMutex);
 		return solidityAllocations.emplace_back(_size, '\0').data();
 	}
 	catch (...)
@@ -151,8 +220,75 @@ extern void solidity_free(char* _data) noexcept
 extern void solidity_reset() noexcept
 {
 	// This is called right before each compilation, but not at the end, so additional memory
-	// can be freed here.
-	yul::YulStringRepository::reset();
+	// can be freed here. Types and interned strings belong to the compilers.
+	lock_guard<mutex> lock(allocationMutex);
 	solidityAllocations.clear();
 }
+
+extern SolidityCompiler* solidity_compiler_create(CStyleReadFileCallback _readCallback, void* _readContext) noexcept
+{
+	try
+	{
+		return new SolidityCompiler(wrapReadCallback(_readCallback, _readContext));
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+
+extern bool solidity_compiler_update_sources(SolidityCompiler* _compiler, char const* _sources) noexcept
+{
+	try
+	{
+		CompilerUse use(*_compiler);
+		if (!use.acquired())
+			return false;
+		Json::Value changes;
+		if (!jsonParseStrict(_sources, changes) || !changes.isObject())
+			return false;
+		updateSources(_compiler->sources, changes);
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+extern bool solidity_compiler_allow_concurrent_reads(SolidityCompiler* _compiler, bool _allow) noexcept
+{
+	CompilerUse use(*_compiler);
+	if (!use.acquired())
+		return false;
+	_compiler->compiler.allowConcurrentReads(_allow);
+	return true;
+}
+
+extern char const* solidity_compiler_compile(SolidityCompiler* _compiler, char const* _input, size_t* o_length) noexcept
+{
+	CompilerUse use(*_compiler);
+	if (!use.acquired())
+	{
+		if (o_length)
+			*o_length = c_compilerInUse.size();
+		return c_compilerInUse.data();
+	}
+	try
+	{
+		_compiler->result = compile(*_compiler, _input);
+	}
+	catch (...)
+	{
+		_compiler->result = "{\"errors\":[{\"type\":\"InternalCompilerError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Unknown exception.\"}]}";
+	}
+	if (o_length)
+		*o_length = _compiler->result.size();
+	return _compiler->result.data();
+}
+
+extern void solidity_compiler_destroy(SolidityCompiler* _compiler) noexcept
+{
+	delete _compiler;
+}
 }
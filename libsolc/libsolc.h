@@ -95,6 +95,60 @@ char* solidity_compile(char const* _input, CStyleReadFileCallback _readCallback,
 /// is invalid after calling this!
 void solidity_reset() SOLC_NOEXCEPT;
 
+/// A compiler that keeps its sources as well as the results of parsing and analysing them
+/// between compilations. Can only be accessed via the solidity_compiler_* functions.
+///
+/// A compiler can be used from any thread, but not from multiple threads at the same time:
+/// solidity_compiler_update_sources() and solidity_compiler_compile() fail if another call with
+/// the same compiler is in progress.
+///
+/// Different compilers are independent of each other: they can compile on different threads at the
+/// same time and each of them keeps its own analysis. The analysis kept by a compiler is discarded
+/// once the number of types it keeps grows too large, and the next compilation starts from scratch.
+typedef struct SolidityCompiler SolidityCompiler;
+
+/// Creates a new compiler without any sources.
+///
+/// @param _readCallback The optional callback pointer used by all compilations of this compiler. Can be NULL.
+/// @param _readContext An optional context pointer passed to _readCallback. Can be NULL.
+///
+/// @returns the compiler, which has to be freed using solidity_compiler_destroy(), or NULL if it
+///          could not be allocated.
+SolidityCompiler* solidity_compiler_create(CStyleReadFileCallback _readCallback, void* _readContext) SOLC_NOEXCEPT;
+
+/// Adds, replaces or removes sources of @p _compiler.
+///
+/// @param _sources A JSON object in the format of the "sources" field of the "Standard Input JSON".
+///                 A source with a value of null is removed.
+///
+/// @returns false if @p _sources is not a JSON object or @p _compiler is in use by another thread,
+///          in which case the sources are unchanged.
+bool solidity_compiler_update_sources(SolidityCompiler* _compiler, char const* _sources) SOLC_NOEXCEPT;
+
+/// Declares whether the read callback of @p _compiler can be called from multiple threads at the
+/// same time. If so, imported files are read concurrently when "settings.parallelism" is larger
+/// than one. Otherwise, which is the default, the callback is called by one thread at a time.
+/// Changing it discards the analysis kept by @p _compiler.
+///
+/// @returns false if @p _compiler is in use by another thread, in which case nothing is changed.
+bool solidity_compiler_allow_concurrent_reads(SolidityCompiler* _compiler, bool _allow) SOLC_NOEXCEPT;
+
+/// Takes a "Standard Input JSON" and returns a "Standard Output JSON" like solidity_compile().
+/// The sources of the input are added to the sources of @p _compiler as by
+/// solidity_compiler_update_sources() and all sources of the compiler are compiled. If the
+/// other settings did not change since the previous compilation, only the sources that are
+/// affected by a changed source are analysed again.
+///
+/// @param o_length If not NULL, the length of the output is stored here.
+///
+/// @returns a pointer to the result, which is owned by @p _compiler. It must NOT be freed by the caller
+///          and is valid until the next call to any solidity_compiler_* function with @p _compiler.
+///          If @p _compiler is in use by another thread, the result only contains an error.
+char const* solidity_compiler_compile(SolidityCompiler* _compiler, char const* _input, size_t* o_length) SOLC_NOEXCEPT;
+
+/// Frees @p _compiler, its sources and its result. Does nothing if @p _compiler is NULL.
+void solidity_compiler_destroy(SolidityCompiler* _compiler) SOLC_NOEXCEPT;
+
 #ifdef __cplusplus
 }
 #endif
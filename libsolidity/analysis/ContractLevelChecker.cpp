@@ -158,53 +158,53 @@ void ContractLevelChecker::findDuplicateDefinitions(map<string, vector<T>> const
 
 void ContractLevelChecker::checkAbstractFunctions(ContractDefinition const& _contract)
 {
-	// Mapping from name to function definition (exactly one per argument type equality class) and
-	// flag to indicate whether it is fully implemented.
-	using FunTypeAndFlag = std::pair<FunctionTypePointer, bool>;
-	map<string, vector<FunTypeAndFlag>> functions;
-
-	auto registerFunction = [&](Declaration const& _declaration, FunctionTypePointer const& _type, bool _implemented)
+	// Mapping from signature to the first function with that signature, where it was found and
+	// a flag to indicate whether it is fully implemented.
+	struct Implementation
 	{
-		auto& overloads = functions[_declaration.name()];
-		auto it = find_if(overloads.begin(), overloads.end(), [&](FunTypeAndFlag const& _funAndFlag)
-		{
-			return _type->hasEqualParameterTypes(*_funAndFlag.first);
-		});
-		if (it == overloads.end())
-			overloads.emplace_back(_type, _implemented);
-		else if (_implemented)
-			it->second = true;
+		std::pair<size_t, size_t> position;
+		bool implemented;
 	};
+	map<OverrideProxy, Implementation, OverrideProxy::CompareBySignature> functions;
 
 	// Search from base to derived, collect all functions and update
 	// the 'implemented' flag.
+	size_t contractIndex = 0;
 	for (ContractDefinition const* contract: boost::adaptors::reverse(_contract.annotation().linearizedBaseContracts))
 	{
-		for (VariableDeclaration const* v: contract->stateVariables())
-			if (v->isPartOfExternalInterface())
-				registerFunction(*v, TypeProvider::function(*v), true);
-
-		for (FunctionDefinition const* function: contract->definedFunctions())
-			if (!function->isConstructor())
-				registerFunction(
-					*function,
-					TypeProvider::function(*function)->asCallableFunction(false),
-					function->isImplemented()
-				);
+		for (OverrideProxy const& function: m_overrideChecker.definedFunctions(*contract))
+		{
+			auto it = functions.try_emplace(function, Implementation{{contractIndex, function.id()}, false}).first;
+			if (!function.unimplemented())
+				it->second.implemented = true;
+		}
+		contractIndex++;
 	}
 
 	// Set to not fully implemented if at least one flag is false.
+	// Only the first unimplemented function of each name is listed.
 	// Note that `_contract.annotation().unimplementedFunctions` has already been
 	// pre-filled by `checkBaseConstructorArguments`.
-	for (auto const& it: functions)
-		for (auto const& funAndFlag: it.second)
-			if (!funAndFlag.second)
-			{
-				FunctionDefinition const* function = dynamic_cast<FunctionDefinition const*>(&funAndFlag.first->declaration());
-				solAssert(function, "");
-				_contract.annotation().unimplementedFunctions.push_back(function);
-				break;
-			}
+	for (auto it = functions.begin(); it != functions.end();)
+	{
+		string const& name = it->first.name();
+		auto firstUnimplemented = functions.end();
+		for (; it != functions.end() && it->first.name() == name; ++it)
+			if (
+				!it->second.implemented &&
+				(firstUnimplemented == functions.end() || it->second.position < firstUnimplemented->second.position)
+			)
+				firstUnimplemented = it;
+
+		if (firstUnimplemented != functions.end())
+		{
+			FunctionDefinition const* function = dynamic_cast<FunctionDefinition const*>(
+				&firstUnimplemented->first.functionType()->declaration()
+			);
+			solAssert(function, "");
+			_contract.annotation().unimplementedFunctions.push_back(function);
+		}
+	}
 
 	if (_contract.abstract())
 	{
@@ -327,36 +327,49 @@ void ContractLevelChecker::checkExternalTypeClashes(ContractDefinition const& _c
 {
 	map<string, vector<pair<Declaration const*, FunctionTypePointer>>> externalDeclarations;
 	for (ContractDefinition const* contract: _contract.annotation().linearizedBaseContracts)
+		for (auto const& [signature, declarationAndType]: externalFunctions(*contract))
+			externalDeclarations[signature].emplace_back(declarationAndType);
+	for (auto const& it: externalDeclarations)
+		for (size_t i = 0; i < it.second.size(); ++i)
+			for (size_t j = i + 1; j < it.second.size(); ++j)
+				if (!it.second[i].second->hasEqualParameterTypes(*it.second[j].second))
+					m_errorReporter.typeError(
+						it.second[j].first->location(),
+						"Function overload clash during conversion to external types for arguments."
+					);
+}
+
+vector<pair<string, pair<Declaration const*, FunctionTypePointer>>> const& ContractLevelChecker::externalFunctions(
+	ContractDefinition const& _contract
+)
+{
+	auto [it, inserted] = m_externalFunctions.try_emplace(&_contract);
+	if (inserted)
 	{
-		for (FunctionDefinition const* f: contract->definedFunctions())
+		for (FunctionDefinition const* f: _contract.definedFunctions())
 			if (f->isPartOfExternalInterface())
 			{
 				auto functionType = TypeProvider::function(*f);
 				// under non error circumstances this should be true
 				if (functionType->interfaceFunctionType())
-					externalDeclarations[functionType->externalSignature()].emplace_back(
-						f, functionType->asCallableFunction(false)
+					it->second.emplace_back(
+						functionType->externalSignature(),
+						make_pair(f, functionType->asCallableFunction(false))
 					);
 			}
-		for (VariableDeclaration const* v: contract->stateVariables())
+		for (VariableDeclaration const* v: _contract.stateVariables())
 			if (v->isPartOfExternalInterface())
 			{
 				auto functionType = TypeProvider::function(*v);
 				// under non error circumstances this should be true
 				if (functionType->interfaceFunctionType())
-					externalDeclarations[functionType->externalSignature()].emplace_back(
-						v, functionType->asCallableFunction(false)
+					it->second.emplace_back(
+						functionType->externalSignature(),
+						make_pair(v, functionType->asCallableFunction(false))
 					);
 			}
 	}
-	for (auto const& it: externalDeclarations)
-		for (size_t i = 0; i < it.second.size(); ++i)
-			for (size_t j = i + 1; j < it.second.size(); ++j)
-				if (!it.second[i].second->hasEqualParameterTypes(*it.second[j].second))
-					m_errorReporter.typeError(
-						it.second[j].first->location(),
-						"Function overload clash during conversion to external types for arguments."
-					);
+	return it->second;
 }
 
 void ContractLevelChecker::checkHashCollisions(ContractDefinition const& _contract)
@@ -27,6 +27,8 @@
 #include <map>
 #include <functional>
 #include <set>
+#include <string>
+#include <vector>
 
 namespace langutil
 {
@@ -75,6 +77,11 @@ private:
 	/// Checks that different functions with external visibility end up having different
 	/// external argument types (i.e. different signature).
 	void checkExternalTypeClashes(ContractDefinition const& _contract);
+	/// @returns the external signature, declaration and callable type of the functions and
+	/// public state variables defined in @a _contract itself, computed once per contract.
+	std::vector<std::pair<std::string, std::pair<Declaration const*, FunctionType const*>>> const& externalFunctions(
+		ContractDefinition const& _contract
+	);
 	/// Checks for hash collisions in external function signatures.
 	void checkHashCollisions(ContractDefinition const& _contract);
 	/// Checks that all requirements for a library are fulfilled if this is a library.
@@ -87,6 +94,11 @@ private:
 
 	OverrideChecker m_overrideChecker;
 	langutil::ErrorReporter& m_errorReporter;
+	/// Cache for externalFunctions().
+	std::map<
+		ContractDefinition const*,
+		std::vector<std::pair<std::string, std::pair<Declaration const*, FunctionType const*>>>
+	> m_externalFunctions;
 };
 
 }
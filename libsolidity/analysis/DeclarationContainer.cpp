@@ -26,6 +26,9 @@
 #include <libsolidity/ast/Types.h>
 #include <libdevcore/StringUtils.h>
 
+#include <algorithm>
+#include <functional>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
@@ -39,10 +42,8 @@ Declaration const* DeclarationContainer::conflictingDeclaration(
 		_name = &_declaration.name();
 	solAssert(!_name->empty(), "");
 	vector<Declaration const*> declarations;
-	if (m_declarations.count(*_name))
-		declarations += m_declarations.at(*_name);
-	if (m_invisibleDeclarations.count(*_name))
-		declarations += m_invisibleDeclarations.at(*_name);
+	if (size_t index = find(*_name, hash(*_name)))
+		declarations = m_entries[index - 1].declarations + m_entries[index - 1].invisibleDeclarations;
 
 	if (
 		dynamic_cast<FunctionDefinition const*>(&_declaration) ||
@@ -82,18 +83,22 @@ Declaration const* DeclarationContainer::conflictingDeclaration(
 
 void DeclarationContainer::activateVariable(ASTString const& _name)
 {
+	size_t index = find(_name, hash(_name));
 	solAssert(
-		m_invisibleDeclarations.count(_name) && m_invisibleDeclarations.at(_name).size() == 1,
+		index && m_entries[index - 1].invisibleDeclarations.size() == 1,
 		"Tried to activate a non-inactive variable or multiple inactive variables with the same name."
 	);
-	solAssert(m_declarations.count(_name) == 0 || m_declarations.at(_name).empty(), "");
-	m_declarations[_name].emplace_back(m_invisibleDeclarations.at(_name).front());
-	m_invisibleDeclarations.erase(_name);
+	Entry& entry = m_entries[index - 1];
+	solAssert(entry.declarations.empty(), "");
+	entry.declarations.emplace_back(entry.invisibleDeclarations.front());
+	entry.invisibleDeclarations.clear();
+	m_sortedDeclarationsValid = false;
 }
 
 bool DeclarationContainer::isInvisible(ASTString const& _name) const
 {
-	return m_invisibleDeclarations.count(_name);
+	size_t index = find(_name, hash(_name));
+	return index && !m_entries[index - 1].invisibleDeclarations.empty();
 }
 
 bool DeclarationContainer::registerDeclaration(
@@ -109,31 +114,46 @@ bool DeclarationContainer::registerDeclaration(
 		return true;
 
 	if (_update)
-	{
 		solAssert(!dynamic_cast<FunctionDefinition const*>(&_declaration), "Attempt to update function definition.");
-		m_declarations.erase(*_name);
-		m_invisibleDeclarations.erase(*_name);
-	}
 	else if (conflictingDeclaration(_declaration, _name))
 		return false;
 
-	vector<Declaration const*>& decls = _invisible ? m_invisibleDeclarations[*_name] : m_declarations[*_name];
+	Entry& entry = findOrInsert(*_name);
+	if (_update)
+	{
+		entry.declarations.clear();
+		entry.invisibleDeclarations.clear();
+		m_sortedDeclarationsValid = false;
+	}
+	vector<Declaration const*>& decls = _invisible ? entry.invisibleDeclarations : entry.declarations;
 	if (!contains(decls, &_declaration))
+	{
 		decls.push_back(&_declaration);
+		m_sortedDeclarationsValid = false;
+	}
 	return true;
 }
 
 vector<Declaration const*> DeclarationContainer::resolveName(ASTString const& _name, bool _recursive, bool _alsoInvisible) const
 {
 	solAssert(!_name.empty(), "Attempt to resolve empty name.");
-	vector<Declaration const*> result;
-	if (m_declarations.count(_name))
-		result = m_declarations.at(_name);
-	if (_alsoInvisible && m_invisibleDeclarations.count(_name))
-		result += m_invisibleDeclarations.at(_name);
-	if (result.empty() && _recursive && m_enclosingContainer)
-		result = m_enclosingContainer->resolveName(_name, true, _alsoInvisible);
-	return result;
+	return resolveName(_name, hash(_name), _recursive, _alsoInvisible);
+}
+
+vector<pair<ASTString const*, vector<Declaration const*> const*>> const& DeclarationContainer::declarations() const
+{
+	if (!m_sortedDeclarationsValid)
+	{
+		m_sortedDeclarations.clear();
+		for (Entry const& entry: m_entries)
+			if (!entry.declarations.empty())
+				m_sortedDeclarations.emplace_back(&entry.name, &entry.declarations);
+		sort(m_sortedDeclarations.begin(), m_sortedDeclarations.end(), [](auto const& _a, auto const& _b) {
+			return *_a.first < *_b.first;
+		});
+		m_sortedDeclarationsValid = true;
+	}
+	return m_sortedDeclarations;
 }
 
 vector<ASTString> DeclarationContainer::similarNames(ASTString const& _name) const
@@ -143,23 +163,92 @@ vector<ASTString> DeclarationContainer::similarNames(ASTString const& _name) con
 	// since 80 is the suggested line length limit, we use 80^2 as length threshold
 	static size_t const MAXIMUM_LENGTH_THRESHOLD = 80 * 80;
 
+	vector<Entry const*> entries;
+	for (Entry const& entry: m_entries)
+		entries.push_back(&entry);
+	sort(entries.begin(), entries.end(), [](Entry const* _a, Entry const* _b) { return _a->name < _b->name; });
+
 	vector<ASTString> similar;
 	size_t maximumEditDistance = _name.size() > 3 ? 2 : _name.size() / 2;
-	for (auto const& declaration: m_declarations)
+	for (Entry const* entry: entries)
+		if (
+			!entry->declarations.empty() &&
+			stringWithinDistance(_name, entry->name, maximumEditDistance, MAXIMUM_LENGTH_THRESHOLD)
+		)
+			similar.push_back(entry->name);
+	for (Entry const* entry: entries)
+		if (
+			!entry->invisibleDeclarations.empty() &&
+			stringWithinDistance(_name, entry->name, maximumEditDistance, MAXIMUM_LENGTH_THRESHOLD)
+		)
+			similar.push_back(entry->name);
+
+	if (m_enclosingContainer)
+		similar += m_enclosingContainer->similarNames(_name);
+
+	return similar;
+}
+
+size_t DeclarationContainer::hash(ASTString const& _name)
+{
+	return std::hash<ASTString>{}(_name);
+}
+
+size_t DeclarationContainer::find(ASTString const& _name, size_t _hash) const
+{
+	if (m_slots.empty())
+		return 0;
+	size_t mask = m_slots.size() - 1;
+	for (size_t slot = _hash & mask; m_slots[slot]; slot = (slot + 1) & mask)
 	{
-		string const& declarationName = declaration.first;
-		if (stringWithinDistance(_name, declarationName, maximumEditDistance, MAXIMUM_LENGTH_THRESHOLD))
-			similar.push_back(declarationName);
+		Entry const& entry = m_entries[m_slots[slot] - 1];
+		if (entry.hash == _hash && entry.name == _name)
+			return m_slots[slot];
 	}
-	for (auto const& declaration: m_invisibleDeclarations)
+	return 0;
+}
+
+DeclarationContainer::Entry& DeclarationContainer::findOrInsert(ASTString const& _name)
+{
+	size_t nameHash = hash(_name);
+	if (size_t index = find(_name, nameHash))
+		return m_entries[index - 1];
+
+	m_entries.push_back(Entry{_name, nameHash, {}, {}});
+	if (m_slots.size() <= 2 * m_entries.size())
 	{
-		string const& declarationName = declaration.first;
-		if (stringWithinDistance(_name, declarationName, maximumEditDistance, MAXIMUM_LENGTH_THRESHOLD))
-			similar.push_back(declarationName);
+		m_slots.assign(m_slots.empty() ? 16 : 2 * m_slots.size(), 0);
+		for (size_t i = 0; i + 1 < m_entries.size(); ++i)
+			insertSlot(i);
 	}
+	insertSlot(m_entries.size() - 1);
+	return m_entries.back();
+}
 
-	if (m_enclosingContainer)
-		similar += m_enclosingContainer->similarNames(_name);
+void DeclarationContainer::insertSlot(size_t _index)
+{
+	size_t mask = m_slots.size() - 1;
+	size_t slot = m_entries[_index].hash & mask;
+	while (m_slots[slot])
+		slot = (slot + 1) & mask;
+	m_slots[slot] = uint32_t(_index + 1);
+}
 
-	return similar;
+vector<Declaration const*> DeclarationContainer::resolveName(
+	ASTString const& _name,
+	size_t _hash,
+	bool _recursive,
+	bool _alsoInvisible
+) const
+{
+	vector<Declaration const*> result;
+	if (size_t index = find(_name, _hash))
+	{
+		result = m_entries[index - 1].declarations;
+		if (_alsoInvisible)
+			result += m_entries[index - 1].invisibleDeclarations;
+	}
+	if (result.empty() && _recursive && m_enclosingContainer)
+		result = m_enclosingContainer->resolveName(_name, _hash, true, _alsoInvisible);
+	return result;
 }
@@ -24,8 +24,11 @@
 
 #include <libsolidity/ast/ASTForward.h>
 #include <boost/noncopyable.hpp>
+#include <cstdint>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace dev
 {
@@ -35,6 +38,8 @@ namespace solidity
 /**
  * Container that stores mappings between names and declarations. It also contains a link to the
  * enclosing scope.
+ * The names are stored in an open addressing hash table and the hash of a name is computed
+ * only once when resolving it through the enclosing scopes.
  */
 class DeclarationContainer
 {
@@ -53,7 +58,9 @@ public:
 	std::vector<Declaration const*> resolveName(ASTString const& _name, bool _recursive = false, bool _alsoInvisible = false) const;
 	ASTNode const* enclosingNode() const { return m_enclosingNode; }
 	DeclarationContainer const* enclosingContainer() const { return m_enclosingContainer; }
-	std::map<ASTString, std::vector<Declaration const*>> const& declarations() const { return m_declarations; }
+	/// @returns the names that have visible declarations together with these declarations,
+	/// ordered by name.
+	std::vector<std::pair<ASTString const*, std::vector<Declaration const*> const*>> const& declarations() const;
 	/// @returns whether declaration is valid, and if not also returns previous declaration.
 	Declaration const* conflictingDeclaration(Declaration const& _declaration, ASTString const* _name = nullptr) const;
 
@@ -69,10 +76,39 @@ public:
 	std::vector<ASTString> similarNames(ASTString const& _name) const;
 
 private:
+	/// The visible and invisible declarations of a name.
+	struct Entry
+	{
+		ASTString name;
+		size_t hash;
+		std::vector<Declaration const*> declarations;
+		std::vector<Declaration const*> invisibleDeclarations;
+	};
+
+	static size_t hash(ASTString const& _name);
+	/// @returns the index of the entry of @a _name, whose hash is @a _hash, plus one,
+	/// or zero if there is none.
+	size_t find(ASTString const& _name, size_t _hash) const;
+	/// @returns the entry of @a _name, which is created if there is none.
+	Entry& findOrInsert(ASTString const& _name);
+	/// Adds the entry at @a _index to the hash table.
+	void insertSlot(size_t _index);
+	std::vector<Declaration const*> resolveName(
+		ASTString const& _name,
+		size_t _hash,
+		bool _recursive,
+		bool _alsoInvisible
+	) const;
+
 	ASTNode const* m_enclosingNode;
 	DeclarationContainer const* m_enclosingContainer;
-	std::map<ASTString, std::vector<Declaration const*>> m_declarations;
-	std::map<ASTString, std::vector<Declaration const*>> m_invisibleDeclarations;
+	std::vector<Entry> m_entries;
+	/// The hash table, which maps to indices into m_entries plus one. Zero marks an empty slot.
+	/// Its size is a power of two and more than twice the number of entries.
+	std::vector<uint32_t> m_slots;
+	/// Cache for declarations(), cleared when an entry is added or changed.
+	mutable std::vector<std::pair<ASTString const*, std::vector<Declaration const*> const*>> m_sortedDeclarations;
+	mutable bool m_sortedDeclarationsValid = false;
 };
 
 }
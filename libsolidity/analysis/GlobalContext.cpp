@@ -111,5 +111,13 @@ MagicVariableDeclaration const* GlobalContext::currentSuper() const
 	return m_superPointer[m_currentContract].get();
 }
 
+void GlobalContext::removeContract(ContractDefinition const& _contract)
+{
+	if (m_currentContract == &_contract)
+		m_currentContract = nullptr;
+	m_thisPointer.erase(&_contract);
+	m_superPointer.erase(&_contract);
+}
+
 }
 }
@@ -49,6 +49,8 @@ public:
 	void setCurrentContract(ContractDefinition const& _contract);
 	MagicVariableDeclaration const* currentThis() const;
 	MagicVariableDeclaration const* currentSuper() const;
+	/// Removes the "this" and "super" declarations of @a _contract, which is about to be destroyed.
+	void removeContract(ContractDefinition const& _contract);
 
 	/// @returns a vector of all implicit global declarations excluding "this".
 	std::vector<Declaration const*> declarations() const;
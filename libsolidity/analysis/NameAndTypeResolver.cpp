@@ -47,11 +47,12 @@ NameAndTypeResolver::NameAndTypeResolver(
 	m_errorReporter(_errorReporter),
 	m_globalContext(_globalContext)
 {
+	// The global scope is kept if sources are re-analysed incrementally.
 	if (!m_scopes[nullptr])
-		m_scopes[nullptr] = make_shared<DeclarationContainer>();
-	for (Declaration const* declaration: _globalContext.declarations())
 	{
-		solAssert(m_scopes[nullptr]->registerDeclaration(*declaration), "Unable to register global declaration.");
+		m_scopes[nullptr] = make_shared<DeclarationContainer>();
+		for (Declaration const* declaration: _globalContext.declarations())
+			solAssert(m_scopes[nullptr]->registerDeclaration(*declaration), "Unable to register global declaration.");
 	}
 }
 
@@ -117,9 +118,9 @@ bool NameAndTypeResolver::performImports(SourceUnit& _sourceUnit, map<string, So
 				}
 			else if (imp->name().empty())
 				for (auto const& nameAndDeclaration: scope->second->declarations())
-					for (auto const& declaration: nameAndDeclaration.second)
+					for (auto const& declaration: *nameAndDeclaration.second)
 						if (!DeclarationRegistrationHelper::registerDeclaration(
-							target, *declaration, &nameAndDeclaration.first, &imp->location(), true, false, m_errorReporter
+							target, *declaration, nameAndDeclaration.first, &imp->location(), true, false, m_errorReporter
 						))
 							error =  true;
 		}
@@ -335,7 +336,7 @@ void NameAndTypeResolver::importInheritedScope(ContractDefinition const& _base)
 	auto iterator = m_scopes.find(&_base);
 	solAssert(iterator != end(m_scopes), "");
 	for (auto const& nameAndDeclaration: iterator->second->declarations())
-		for (auto const& declaration: nameAndDeclaration.second)
+		for (auto const& declaration: *nameAndDeclaration.second)
 			// Import if it was declared in the base, is not the constructor and is visible in derived classes
 			if (declaration->scope() == &_base && declaration->isVisibleInDerivedContracts())
 				if (!m_currentScope->registerDeclaration(*declaration))
@@ -560,7 +561,10 @@ bool DeclarationRegistrationHelper::visit(SourceUnit& _sourceUnit)
 
 void DeclarationRegistrationHelper::endVisit(SourceUnit& _sourceUnit)
 {
-	_sourceUnit.annotation().exportedSymbols = m_scopes[&_sourceUnit]->declarations();
+	map<ASTString, vector<Declaration const*>> exportedSymbols;
+	for (auto const& nameAndDeclarations: m_scopes[&_sourceUnit]->declarations())
+		exportedSymbols[*nameAndDeclarations.first] = *nameAndDeclarations.second;
+	_sourceUnit.annotation().exportedSymbols = std::move(exportedSymbols);
 	closeCurrentScope();
 }
 
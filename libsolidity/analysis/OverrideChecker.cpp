@@ -39,16 +39,6 @@ using namespace dev::solidity;
 namespace
 {
 
-// Helper struct to do a search by name
-struct MatchByName
-{
-	string const& m_name;
-	bool operator()(OverrideProxy const& _item)
-	{
-		return _item.name() == m_name;
-	}
-};
-
 /**
  * Construct the override graph for this signature.
  * Reserve node 0 for the current contract and node
@@ -307,11 +297,13 @@ Token OverrideProxy::functionKind() const
 
 FunctionType const* OverrideProxy::functionType() const
 {
-	return std::visit(GenericVisitor{
-		[&](FunctionDefinition const* _item) { return FunctionType(*_item).asCallableFunction(false); },
-		[&](VariableDeclaration const* _item) { return FunctionType(*_item).asCallableFunction(false); },
-		[&](ModifierDefinition const*) -> FunctionType const* { solAssert(false, "Requested function type of modifier."); return nullptr; }
-	}, m_item);
+	if (!m_functionType)
+		m_functionType = std::visit(GenericVisitor{
+			[&](FunctionDefinition const* _item) { return FunctionType(*_item).asCallableFunction(false); },
+			[&](VariableDeclaration const* _item) { return FunctionType(*_item).asCallableFunction(false); },
+			[&](ModifierDefinition const*) -> FunctionType const* { solAssert(false, "Requested function type of modifier."); return nullptr; }
+		}, m_item);
+	return m_functionType;
 }
 
 ModifierType const* OverrideProxy::modifierType() const
@@ -443,9 +435,11 @@ void OverrideChecker::checkIllegalOverrides(ContractDefinition const& _contract)
 	OverrideProxyBySignatureMultiSet const& inheritedFuncs = inheritedFunctions(_contract);
 	OverrideProxyBySignatureMultiSet const& inheritedMods = inheritedModifiers(_contract);
 
+	// Modifiers only have a name, so looking up a modifier among functions or a function among
+	// modifiers finds the items with the same name.
 	for (ModifierDefinition const* modifier: _contract.functionModifiers())
 	{
-		if (contains_if(inheritedFuncs, MatchByName{modifier->name()}))
+		if (inheritedFuncs.count(OverrideProxy{modifier}))
 			m_errorReporter.typeError(
 				modifier->location(),
 				"Override changes function or public state variable to modifier."
@@ -459,7 +453,7 @@ void OverrideChecker::checkIllegalOverrides(ContractDefinition const& _contract)
 		if (function->isConstructor())
 			continue;
 
-		if (contains_if(inheritedMods, MatchByName{function->name()}))
+		if (inheritedMods.count(OverrideProxy{function}))
 			m_errorReporter.typeError(function->location(), "Override changes modifier to function.");
 
 		checkOverrideList(OverrideProxy{function}, inheritedFuncs);
@@ -469,7 +463,7 @@ void OverrideChecker::checkIllegalOverrides(ContractDefinition const& _contract)
 		if (!stateVar->isPublic())
 			continue;
 
-		if (contains_if(inheritedMods, MatchByName{stateVar->name()}))
+		if (inheritedMods.count(OverrideProxy{stateVar}))
 			m_errorReporter.typeError(stateVar->location(), "Override changes modifier to public state variable.");
 
 		checkOverrideList(OverrideProxy{stateVar}, inheritedFuncs);
@@ -617,11 +611,8 @@ void OverrideChecker::checkAmbiguousOverrides(ContractDefinition const& _contrac
 		OverrideProxyBySignatureMultiSet nonOverriddenFunctions = inheritedFunctions(_contract);
 
 		// Remove all functions that match the signature of a function in the current contract.
-		for (FunctionDefinition const* f: _contract.definedFunctions())
-			nonOverriddenFunctions.erase(OverrideProxy{f});
-		for (VariableDeclaration const* v: _contract.stateVariables())
-			if (v->isPublic())
-				nonOverriddenFunctions.erase(OverrideProxy{v});
+		for (OverrideProxy const& function: definedFunctions(_contract))
+			nonOverriddenFunctions.erase(function);
 
 		// Walk through the set of functions signature by signature.
 		for (auto it = nonOverriddenFunctions.cbegin(); it != nonOverriddenFunctions.cend();)
@@ -636,8 +627,8 @@ void OverrideChecker::checkAmbiguousOverrides(ContractDefinition const& _contrac
 
 	{
 		OverrideProxyBySignatureMultiSet modifiers = inheritedModifiers(_contract);
-		for (ModifierDefinition const* mod: _contract.functionModifiers())
-			modifiers.erase(OverrideProxy{mod});
+		for (OverrideProxy const& mod: definedModifiers(_contract))
+			modifiers.erase(mod);
 
 		for (auto it = modifiers.cbegin(); it != modifiers.cend();)
 		{
@@ -804,6 +795,30 @@ void OverrideChecker::checkOverrideList(OverrideProxy _item, OverrideProxyBySign
 		);
 }
 
+OverrideChecker::OverrideProxyBySignatureMultiSet const& OverrideChecker::definedFunctions(ContractDefinition const& _contract) const
+{
+	auto [it, inserted] = m_definedFunctions.try_emplace(&_contract);
+	if (inserted)
+	{
+		for (FunctionDefinition const* fun: _contract.definedFunctions())
+			if (!fun->isConstructor())
+				it->second.emplace(fun);
+		for (VariableDeclaration const* var: _contract.stateVariables())
+			if (var->isPublic())
+				it->second.emplace(var);
+	}
+	return it->second;
+}
+
+OverrideChecker::OverrideProxyBySignatureMultiSet const& OverrideChecker::definedModifiers(ContractDefinition const& _contract) const
+{
+	auto [it, inserted] = m_definedModifiers.try_emplace(&_contract);
+	if (inserted)
+		for (ModifierDefinition const* mod: _contract.functionModifiers())
+			it->second.emplace(mod);
+	return it->second;
+}
+
 OverrideChecker::OverrideProxyBySignatureMultiSet const& OverrideChecker::inheritedFunctions(ContractDefinition const& _contract) const
 {
 	if (!m_inheritedFunctions.count(&_contract))
@@ -812,13 +827,8 @@ OverrideChecker::OverrideProxyBySignatureMultiSet const& OverrideChecker::inheri
 
 		for (auto const* base: resolveDirectBaseContracts(_contract))
 		{
-			set<OverrideProxy, OverrideProxy::CompareBySignature> functionsInBase;
-			for (FunctionDefinition const* fun: base->definedFunctions())
-				if (!fun->isConstructor())
-					functionsInBase.emplace(OverrideProxy{fun});
-			for (VariableDeclaration const* var: base->stateVariables())
-				if (var->isPublic())
-					functionsInBase.emplace(OverrideProxy{var});
+			OverrideProxyBySignatureMultiSet const& defined = definedFunctions(*base);
+			set<OverrideProxy, OverrideProxy::CompareBySignature> functionsInBase(defined.begin(), defined.end());
 
 			for (OverrideProxy const& func: inheritedFunctions(*base))
 				functionsInBase.insert(func);
@@ -840,9 +850,8 @@ OverrideChecker::OverrideProxyBySignatureMultiSet const& OverrideChecker::inheri
 
 		for (auto const* base: resolveDirectBaseContracts(_contract))
 		{
-			set<OverrideProxy, OverrideProxy::CompareBySignature> modifiersInBase;
-			for (ModifierDefinition const* mod: base->functionModifiers())
-				modifiersInBase.emplace(OverrideProxy{mod});
+			OverrideProxyBySignatureMultiSet const& defined = definedModifiers(*base);
+			set<OverrideProxy, OverrideProxy::CompareBySignature> modifiersInBase(defined.begin(), defined.end());
 
 			for (OverrideProxy const& mod: inheritedModifiers(*base))
 				modifiersInBase.insert(mod);
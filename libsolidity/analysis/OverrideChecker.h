@@ -122,6 +122,8 @@ private:
 	> m_item;
 
 	std::shared_ptr<OverrideComparator> mutable m_comparator;
+	/// Cache for functionType().
+	mutable FunctionType const* m_functionType = nullptr;
 };
 
 
@@ -139,6 +141,15 @@ public:
 
 	void check(ContractDefinition const& _contract);
 
+	using OverrideProxyBySignatureMultiSet = std::multiset<OverrideProxy, OverrideProxy::CompareBySignature>;
+
+	/// @returns the functions (including public state variables) defined in @a _contract itself,
+	/// sorted by signature. The result is computed once per contract and shared by all contracts
+	/// deriving from it.
+	OverrideProxyBySignatureMultiSet const& definedFunctions(ContractDefinition const& _contract) const;
+	/// @returns the modifiers defined in @a _contract itself, sorted by name.
+	OverrideProxyBySignatureMultiSet const& definedModifiers(ContractDefinition const& _contract) const;
+
 private:
 	struct CompareByID
 	{
@@ -176,8 +187,6 @@ private:
 	/// Resolves an override list of UserDefinedTypeNames to a list of contracts.
 	std::set<ContractDefinition const*, CompareByID> resolveOverrideList(OverrideSpecifier const& _overrides) const;
 
-	using OverrideProxyBySignatureMultiSet = std::multiset<OverrideProxy, OverrideProxy::CompareBySignature>;
-
 	void checkOverrideList(OverrideProxy _item, OverrideProxyBySignatureMultiSet const& _inherited);
 
 	/// Returns all functions of bases (including public state variables) that have not yet been overwritten.
@@ -187,6 +196,9 @@ private:
 
 	langutil::ErrorReporter& m_errorReporter;
 
+	/// Caches for definedFunctions() and definedModifiers().
+	std::map<ContractDefinition const*, OverrideProxyBySignatureMultiSet> mutable m_definedFunctions;
+	std::map<ContractDefinition const*, OverrideProxyBySignatureMultiSet> mutable m_definedModifiers;
 	/// Cache for inheritedFunctions().
 	std::map<ContractDefinition const*, OverrideProxyBySignatureMultiSet> mutable m_inheritedFunctions;
 	std::map<ContractDefinition const*, OverrideProxyBySignatureMultiSet> mutable m_inheritedModifiers;
@@ -40,7 +40,7 @@ namespace solidity
  *  - whether override specifiers are actually contracts
  * @TODO factor out each use-case into an individual class (but do the traversal only once)
  */
-class PostTypeChecker: private ASTConstVisitor
+class PostTypeChecker: public ASTConstVisitor
 {
 public:
 	/// @param _errorReporter provides the error logging functionality.
@@ -25,11 +25,14 @@
 #include <libsolidity/ast/ASTVisitor.h>
 #include <libsolidity/ast/AST_accept.h>
 #include <libsolidity/ast/TypeProvider.h>
+#include <libyul/AsmData.h>
+#include <libyul/optimiser/ASTWalker.h>
 #include <libdevcore/Keccak256.h>
 
 #include <boost/algorithm/string.hpp>
 #include <algorithm>
 #include <functional>
+#include <unordered_set>
 
 using namespace std;
 using namespace dev;
@@ -39,39 +42,173 @@ class IDDispenser
 {
 public:
 	static size_t next() { return ++instance(); }
-	static void reset() { instance() = 0; }
+	static size_t last() { return instance(); }
+	static void reset(size_t _lastID) { instance() = _lastID; }
 private:
 	static size_t& instance()
 	{
-		static IDDispenser dispenser;
+		thread_local IDDispenser dispenser;
 		return dispenser.id;
 	}
 	size_t id = 0;
 };
 
+namespace
+{
+/// The nodes created on the current thread since ASTNode::startRecording, while recording.
+thread_local unique_ptr<unordered_set<ASTNode*>> recordedNodes;
+
+void shiftSourceLocation(langutil::SourceLocation& _location, int _offset, int _delta)
+{
+	if (_location.start >= _offset)
+		_location.start += _delta;
+	if (_location.end >= _offset)
+		_location.end += _delta;
+}
+
+/// Moves the locations of all nodes of an inline assembly block, see ASTNode::shiftLocation.
+class YulLocationShifter: public yul::ASTModifier
+{
+public:
+	YulLocationShifter(int _offset, int _delta): m_offset(_offset), m_delta(_delta) {}
+
+	using ASTModifier::operator();
+	void operator()(yul::Literal& _literal) override { shift(_literal.location); }
+	void operator()(yul::Identifier& _identifier) override { shift(_identifier.location); }
+	void operator()(yul::FunctionCall& _call) override
+	{
+		shift(_call.location);
+		shift(_call.functionName.location);
+		ASTModifier::operator()(_call);
+	}
+	void operator()(yul::ExpressionStatement& _statement) override
+	{
+		shift(_statement.location);
+		ASTModifier::operator()(_statement);
+	}
+	void operator()(yul::Assignment& _assignment) override
+	{
+		shift(_assignment.location);
+		ASTModifier::operator()(_assignment);
+	}
+	void operator()(yul::VariableDeclaration& _declaration) override
+	{
+		shift(_declaration.location);
+		for (yul::TypedName& variable: _declaration.variables)
+			shift(variable.location);
+		ASTModifier::operator()(_declaration);
+	}
+	void operator()(yul::If& _if) override
+	{
+		shift(_if.location);
+		ASTModifier::operator()(_if);
+	}
+	void operator()(yul::Switch& _switch) override
+	{
+		shift(_switch.location);
+		for (yul::Case& switchCase: _switch.cases)
+			shift(switchCase.location);
+		ASTModifier::operator()(_switch);
+	}
+	void operator()(yul::FunctionDefinition& _function) override
+	{
+		shift(_function.location);
+		for (yul::TypedName& parameter: _function.parameters)
+			shift(parameter.location);
+		for (yul::TypedName& returnVariable: _function.returnVariables)
+			shift(returnVariable.location);
+		ASTModifier::operator()(_function);
+	}
+	void operator()(yul::ForLoop& _loop) override
+	{
+		shift(_loop.location);
+		ASTModifier::operator()(_loop);
+	}
+	void operator()(yul::Break& _break) override { shift(_break.location); }
+	void operator()(yul::Continue& _continue) override { shift(_continue.location); }
+	void operator()(yul::Leave& _leave) override { shift(_leave.location); }
+	void operator()(yul::Block& _block) override
+	{
+		shift(_block.location);
+		ASTModifier::operator()(_block);
+	}
+
+private:
+	void shift(langutil::SourceLocation& _location) const { shiftSourceLocation(_location, m_offset, m_delta); }
+
+	int m_offset;
+	int m_delta;
+};
+}
+
 ASTNode::ASTNode(SourceLocation const& _location):
 	m_id(IDDispenser::next()),
 	m_location(_location)
 {
+	if (recordedNodes)
+		recordedNodes->insert(this);
+}
+
+ASTNode::~ASTNode()
+{
+	if (recordedNodes)
+		recordedNodes->erase(this);
+	// Annotations from an arena are destroyed in place, their memory belongs to the arena.
+	if (m_arena && m_annotation)
+		m_annotation.release()->~ASTAnnotation();
+}
+
+void ASTNode::resetID(size_t _lastID)
+{
+	IDDispenser::reset(_lastID);
+}
+
+size_t ASTNode::lastID()
+{
+	return IDDispenser::last();
+}
+
+void ASTNode::startRecording()
+{
+	solAssert(!recordedNodes, "Already recording.");
+	recordedNodes = make_unique<unordered_set<ASTNode*>>();
+}
+
+vector<ASTNode*> ASTNode::stopRecording()
+{
+	solAssert(recordedNodes, "Not recording.");
+	vector<ASTNode*> nodes(recordedNodes->begin(), recordedNodes->end());
+	recordedNodes.reset();
+	return nodes;
+}
+
+void ASTNode::shiftIDs(vector<ASTNode*> const& _nodes, size_t _offset)
+{
+	for (ASTNode* node: _nodes)
+		node->m_id += _offset;
 }
 
-void ASTNode::resetID()
+void ASTNode::shiftLocation(int _offset, int _delta)
 {
-	IDDispenser::reset();
+	shiftSourceLocation(m_location, _offset, _delta);
 }
 
 ASTAnnotation& ASTNode::annotation() const
+{
+	return initAnnotation<ASTAnnotation>();
+}
+
+void ASTNode::resetAnalysis()
 {
 	if (!m_annotation)
-		m_annotation = make_unique<ASTAnnotation>();
-	return *m_annotation;
+		return;
+	m_annotationOutdated = true;
+	annotation();
 }
 
 SourceUnitAnnotation& SourceUnit::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<SourceUnitAnnotation>();
-	return dynamic_cast<SourceUnitAnnotation&>(*m_annotation);
+	return initAnnotation<SourceUnitAnnotation>();
 }
 
 set<SourceUnit const*> SourceUnit::referencedSourceUnits(bool _recurse, set<SourceUnit const*> _skipList) const
@@ -91,11 +228,27 @@ set<SourceUnit const*> SourceUnit::referencedSourceUnits(bool _recurse, set<Sour
 	return sourceUnits;
 }
 
+void ImportDirective::shiftLocation(int _offset, int _delta)
+{
+	Declaration::shiftLocation(_offset, _delta);
+	// The symbols are not visited as child nodes.
+	for (SymbolAlias& symbolAlias: m_symbolAliases)
+	{
+		symbolAlias.symbol->shiftLocation(_offset, _delta);
+		shiftSourceLocation(symbolAlias.location, _offset, _delta);
+	}
+}
+
 ImportAnnotation& ImportDirective::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ImportAnnotation>();
-	return dynamic_cast<ImportAnnotation&>(*m_annotation);
+	return initAnnotation<ImportAnnotation>();
+}
+
+void ImportDirective::resetAnalysis()
+{
+	Declaration::resetAnalysis();
+	for (SymbolAlias const& symbolAlias: m_symbolAliases)
+		symbolAlias.symbol->resetAnalysis();
 }
 
 TypePointer ImportDirective::type() const
@@ -255,6 +408,21 @@ vector<Declaration const*> const& ContractDefinition::inheritableMembers() const
 	return *m_inheritableMembers;
 }
 
+vector<pair<FunctionDefinition const*, FunctionTypePointer>> const& ContractDefinition::attachableFunctions() const
+{
+	if (!m_attachableFunctions)
+	{
+		m_attachableFunctions = make_unique<vector<pair<FunctionDefinition const*, FunctionTypePointer>>>();
+		for (FunctionDefinition const* function: definedFunctions())
+			if (function->isVisibleAsLibraryMember() && !function->parameters().empty())
+				m_attachableFunctions->emplace_back(
+					function,
+					FunctionType(*function, false).asCallableFunction(true, true)
+				);
+	}
+	return *m_attachableFunctions;
+}
+
 TypePointer ContractDefinition::type() const
 {
 	return TypeProvider::typeType(TypeProvider::contract(*this));
@@ -262,16 +430,21 @@ TypePointer ContractDefinition::type() const
 
 ContractDefinitionAnnotation& ContractDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ContractDefinitionAnnotation>();
-	return dynamic_cast<ContractDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<ContractDefinitionAnnotation>();
+}
+
+void ContractDefinition::resetAnalysis()
+{
+	Declaration::resetAnalysis();
+	m_interfaceFunctionList.reset();
+	m_interfaceEvents.reset();
+	m_inheritableMembers.reset();
+	m_attachableFunctions.reset();
 }
 
 TypeNameAnnotation& TypeName::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<TypeNameAnnotation>();
-	return dynamic_cast<TypeNameAnnotation&>(*m_annotation);
+	return initAnnotation<TypeNameAnnotation>();
 }
 
 TypePointer StructDefinition::type() const
@@ -281,9 +454,7 @@ TypePointer StructDefinition::type() const
 
 TypeDeclarationAnnotation& StructDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<TypeDeclarationAnnotation>();
-	return dynamic_cast<TypeDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<TypeDeclarationAnnotation>();
 }
 
 TypePointer EnumValue::type() const
@@ -300,9 +471,7 @@ TypePointer EnumDefinition::type() const
 
 TypeDeclarationAnnotation& EnumDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<TypeDeclarationAnnotation>();
-	return dynamic_cast<TypeDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<TypeDeclarationAnnotation>();
 }
 
 ContractDefinition::ContractKind FunctionDefinition::inContractKind() const
@@ -321,6 +490,12 @@ CallableDeclarationAnnotation& CallableDeclaration::annotation() const
 	return dynamic_cast<CallableDeclarationAnnotation&>(*m_annotation);
 }
 
+void CallableDeclaration::resetAnalysis()
+{
+	Declaration::resetAnalysis();
+	clearLocalVariables();
+}
+
 
 FunctionTypePointer FunctionDefinition::functionType(bool _internal) const
 {
@@ -375,9 +550,7 @@ string FunctionDefinition::externalIdentifierHex() const
 
 FunctionDefinitionAnnotation& FunctionDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<FunctionDefinitionAnnotation>();
-	return dynamic_cast<FunctionDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<FunctionDefinitionAnnotation>();
 }
 
 TypePointer ModifierDefinition::type() const
@@ -387,9 +560,7 @@ TypePointer ModifierDefinition::type() const
 
 ModifierDefinitionAnnotation& ModifierDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ModifierDefinitionAnnotation>();
-	return dynamic_cast<ModifierDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<ModifierDefinitionAnnotation>();
 }
 
 TypePointer EventDefinition::type() const
@@ -407,16 +578,12 @@ FunctionTypePointer EventDefinition::functionType(bool _internal) const
 
 EventDefinitionAnnotation& EventDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<EventDefinitionAnnotation>();
-	return dynamic_cast<EventDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<EventDefinitionAnnotation>();
 }
 
 UserDefinedTypeNameAnnotation& UserDefinedTypeName::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<UserDefinedTypeNameAnnotation>();
-	return dynamic_cast<UserDefinedTypeNameAnnotation&>(*m_annotation);
+	return initAnnotation<UserDefinedTypeNameAnnotation>();
 }
 
 SourceUnit const& Scopable::sourceUnit() const
@@ -451,9 +618,7 @@ string Scopable::sourceUnitName() const
 
 DeclarationAnnotation& Declaration::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<DeclarationAnnotation>();
-	return dynamic_cast<DeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<DeclarationAnnotation>();
 }
 
 bool VariableDeclaration::isLValue() const
@@ -641,86 +806,68 @@ FunctionTypePointer VariableDeclaration::functionType(bool _internal) const
 
 VariableDeclarationAnnotation& VariableDeclaration::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<VariableDeclarationAnnotation>();
-	return dynamic_cast<VariableDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<VariableDeclarationAnnotation>();
 }
 
 StatementAnnotation& Statement::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<StatementAnnotation>();
-	return dynamic_cast<StatementAnnotation&>(*m_annotation);
+	return initAnnotation<StatementAnnotation>();
+}
+
+void InlineAssembly::shiftLocation(int _offset, int _delta)
+{
+	Statement::shiftLocation(_offset, _delta);
+	YulLocationShifter{_offset, _delta}(*m_operations);
 }
 
 InlineAssemblyAnnotation& InlineAssembly::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<InlineAssemblyAnnotation>();
-	return dynamic_cast<InlineAssemblyAnnotation&>(*m_annotation);
+	return initAnnotation<InlineAssemblyAnnotation>();
 }
 
 BlockAnnotation& Block::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<BlockAnnotation>();
-	return dynamic_cast<BlockAnnotation&>(*m_annotation);
+	return initAnnotation<BlockAnnotation>();
 }
 
 TryCatchClauseAnnotation& TryCatchClause::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<TryCatchClauseAnnotation>();
-	return dynamic_cast<TryCatchClauseAnnotation&>(*m_annotation);
+	return initAnnotation<TryCatchClauseAnnotation>();
 }
 
 ForStatementAnnotation& ForStatement::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ForStatementAnnotation>();
-	return dynamic_cast<ForStatementAnnotation&>(*m_annotation);
+	return initAnnotation<ForStatementAnnotation>();
 }
 
 ReturnAnnotation& Return::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ReturnAnnotation>();
-	return dynamic_cast<ReturnAnnotation&>(*m_annotation);
+	return initAnnotation<ReturnAnnotation>();
 }
 
 ExpressionAnnotation& Expression::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<ExpressionAnnotation>();
-	return dynamic_cast<ExpressionAnnotation&>(*m_annotation);
+	return initAnnotation<ExpressionAnnotation>();
 }
 
 MemberAccessAnnotation& MemberAccess::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<MemberAccessAnnotation>();
-	return dynamic_cast<MemberAccessAnnotation&>(*m_annotation);
+	return initAnnotation<MemberAccessAnnotation>();
 }
 
 BinaryOperationAnnotation& BinaryOperation::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<BinaryOperationAnnotation>();
-	return dynamic_cast<BinaryOperationAnnotation&>(*m_annotation);
+	return initAnnotation<BinaryOperationAnnotation>();
 }
 
 FunctionCallAnnotation& FunctionCall::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<FunctionCallAnnotation>();
-	return dynamic_cast<FunctionCallAnnotation&>(*m_annotation);
+	return initAnnotation<FunctionCallAnnotation>();
 }
 
 IdentifierAnnotation& Identifier::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = make_unique<IdentifierAnnotation>();
-	return dynamic_cast<IdentifierAnnotation&>(*m_annotation);
+	return initAnnotation<IdentifierAnnotation>();
 }
 
 ASTString Literal::valueWithoutUnderscores() const
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <libsolidity/ast/ASTForward.h>
+#include <libsolidity/ast/ASTArena.h>
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/ast/ASTAnnotations.h>
 #include <libsolidity/ast/ASTEnums.h>
@@ -67,12 +68,33 @@ public:
 	using SourceLocation = langutil::SourceLocation;
 
 	explicit ASTNode(SourceLocation const& _location);
-	virtual ~ASTNode() {}
+	virtual ~ASTNode();
 
 	/// @returns an identifier of this AST node that is unique for a single compilation run.
 	size_t id() const { return m_id; }
-	/// Resets the global ID counter. This invalidates all previous IDs.
-	static void resetID();
+	/// Resets the ID counter of the current thread, such that the next node created on it
+	/// gets the ID @a _lastID + 1. This invalidates all previous IDs.
+	static void resetID(size_t _lastID = 0);
+	/// @returns the ID of the node created last on the current thread.
+	static size_t lastID();
+
+	/// Starts recording the nodes created on the current thread.
+	static void startRecording();
+	/// Stops recording and @returns the recorded nodes that were not destroyed since.
+	static std::vector<ASTNode*> stopRecording();
+	/// Adds @a _offset to the IDs of @a _nodes. Used to move the IDs of nodes created on
+	/// another thread to the range a sequential run would have assigned to them.
+	static void shiftIDs(std::vector<ASTNode*> const& _nodes, size_t _offset);
+
+	/// Creates a node of type @a T from @a _args. The node and its annotation are allocated
+	/// from @a _arena, which has to outlive the node.
+	template <class T, class... Args>
+	static ASTPointer<T> createInArena(ASTArena& _arena, Args&&... _args)
+	{
+		ASTPointer<T> node = std::allocate_shared<T>(ASTArenaAllocator<T>(_arena), std::forward<Args>(_args)...);
+		static_cast<ASTNode&>(*node).m_arena = &_arena;
+		return node;
+	}
 
 	virtual void accept(ASTVisitor& _visitor) = 0;
 	virtual void accept(ASTConstVisitor& _visitor) const = 0;
@@ -97,9 +119,17 @@ public:
 
 	/// Returns the source code location of this node.
 	SourceLocation const& location() const { return m_location; }
+	/// Moves the start and the end of the location of this node by @a _delta if they are at or
+	/// after @a _offset. Used to keep the node when the source before @a _offset is edited.
+	/// This does not visit the child nodes.
+	virtual void shiftLocation(int _offset, int _delta);
 
 	///@todo make this const-safe by providing a different way to access the annotation
 	virtual ASTAnnotation& annotation() const;
+	/// Drops the annotation and all other results of the analysis of this node, such that it can
+	/// be analysed again. The new annotation reuses the memory of the old one.
+	/// This does not visit the child nodes.
+	virtual void resetAnalysis();
 
 	///@{
 	///@name equality operators
@@ -109,12 +139,48 @@ public:
 	///@}
 
 protected:
-	size_t const m_id = 0;
+	size_t m_id = 0;
 	/// Annotation - is specialised in derived classes, is created upon request (because of polymorphism).
 	mutable std::unique_ptr<ASTAnnotation> m_annotation;
 
+	/// @returns the annotation, which is created as @a T if it does not exist yet.
+	/// Annotations of the same kind are stored next to each other in the arena.
+	/// The annotation is created by the first call to annotation(), which is the override of
+	/// the most derived class, so it always is a @a T. Builds without NDEBUG check this.
+	template <class T>
+	T& initAnnotation() const
+	{
+#ifndef NDEBUG
+		solAssert(!m_annotation || dynamic_cast<T*>(m_annotation.get()), "Annotation accessed as a different kind.");
+#endif
+		if (!m_annotation)
+		{
+			if (m_arena)
+				m_annotation.reset(new (m_arena->allocate<T>(sizeof(T), alignof(T))) T());
+			else
+				m_annotation = std::make_unique<T>();
+		}
+		else if (m_annotationOutdated)
+		{
+			if (m_arena)
+			{
+				T* annotation = static_cast<T*>(m_annotation.release());
+				annotation->~T();
+				m_annotation.reset(new (annotation) T());
+			}
+			else
+				m_annotation = std::make_unique<T>();
+			m_annotationOutdated = false;
+		}
+		return static_cast<T&>(*m_annotation);
+	}
+
 private:
+	/// The arena this node was allocated from, if any. Its annotation is allocated from it as well.
+	ASTArena* m_arena = nullptr;
 	SourceLocation m_location;
+	/// Whether the annotation has to be recreated on the next access, see resetAnalysis().
+	mutable bool m_annotationOutdated = false;
 };
 
 template <class _T>
@@ -141,6 +207,8 @@ public:
 	SourceUnitAnnotation& annotation() const override;
 
 	std::vector<ASTPointer<ASTNode>> nodes() const { return m_nodes; }
+	/// Replaces the node at @a _index, used to parse a part of an edited source again.
+	void replaceNode(size_t _index, ASTPointer<ASTNode> _node) { m_nodes[_index] = std::move(_node); }
 
 	/// @returns a set of referenced SourceUnits. Recursively if @a _recurse is true.
 	std::set<SourceUnit const*> referencedSourceUnits(bool _recurse = false, std::set<SourceUnit const*> _skipList = std::set<SourceUnit const*>()) const;
@@ -307,7 +375,9 @@ public:
 	{
 		return m_symbolAliases;
 	}
+	void shiftLocation(int _offset, int _delta) override;
 	ImportAnnotation& annotation() const override;
+	void resetAnalysis() override;
 
 	TypePointer type() const override;
 
@@ -330,6 +400,7 @@ public:
 	virtual ~VariableScope() = default;
 	void addLocalVariable(VariableDeclaration const& _localVariable) { m_localVariables.push_back(&_localVariable); }
 	std::vector<VariableDeclaration const*> const& localVariables() const { return m_localVariables; }
+	void clearLocalVariables() { m_localVariables.clear(); }
 
 private:
 	std::vector<VariableDeclaration const*> m_localVariables;
@@ -402,6 +473,8 @@ public:
 
 	std::vector<ASTPointer<InheritanceSpecifier>> const& baseContracts() const { return m_baseContracts; }
 	std::vector<ASTPointer<ASTNode>> const& subNodes() const { return m_subNodes; }
+	/// Replaces the sub node at @a _index, used to parse a part of an edited source again.
+	void replaceSubNode(size_t _index, ASTPointer<ASTNode> _node) { m_subNodes[_index] = std::move(_node); }
 	std::vector<UsingForDirective const*> usingForDirectives() const { return filteredNodes<UsingForDirective>(m_subNodes); }
 	std::vector<StructDefinition const*> definedStructs() const { return filteredNodes<StructDefinition>(m_subNodes); }
 	std::vector<EnumDefinition const*> definedEnums() const { return filteredNodes<EnumDefinition>(m_subNodes); }
@@ -422,6 +495,10 @@ public:
 	/// @returns a list of the inheritable members of this contract
 	std::vector<Declaration const*> const& inheritableMembers() const;
 
+	/// @returns the functions of this library that `using for` can attach to a type, together
+	/// with their types when called as members of their first argument.
+	std::vector<std::pair<FunctionDefinition const*, FunctionTypePointer>> const& attachableFunctions() const;
+
 	/// Returns the constructor or nullptr if no constructor was specified.
 	FunctionDefinition const* constructor() const;
 	/// @returns true iff the constructor of this contract is public (or non-existing).
@@ -441,6 +518,7 @@ public:
 	TypePointer type() const override;
 
 	ContractDefinitionAnnotation& annotation() const override;
+	void resetAnalysis() override;
 
 	ContractKind contractKind() const { return m_contractKind; }
 
@@ -455,6 +533,7 @@ private:
 	mutable std::unique_ptr<std::vector<std::pair<FixedHash<4>, FunctionTypePointer>>> m_interfaceFunctionList;
 	mutable std::unique_ptr<std::vector<EventDefinition const*>> m_interfaceEvents;
 	mutable std::unique_ptr<std::vector<Declaration const*>> m_inheritableMembers;
+	mutable std::unique_ptr<std::vector<std::pair<FunctionDefinition const*, FunctionTypePointer>>> m_attachableFunctions;
 };
 
 class InheritanceSpecifier: public ASTNode
@@ -623,6 +702,7 @@ public:
 	virtual bool virtualSemantics() const { return markedVirtual(); }
 
 	CallableDeclarationAnnotation& annotation() const override;
+	void resetAnalysis() override;
 
 protected:
 	ASTPointer<ParameterList> m_parameters;
@@ -1145,6 +1225,7 @@ public:
 	yul::Dialect const& dialect() const { return m_dialect; }
 	yul::Block const& operations() const { return *m_operations; }
 
+	void shiftLocation(int _offset, int _delta) override;
 	InlineAssemblyAnnotation& annotation() const override;
 
 private:
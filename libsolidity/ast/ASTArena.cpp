@@ -0,0 +1,45 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/ast/ASTArena.h>
+
+#include <liblangutil/Exceptions.h>
+
+#include <cstdint>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+atomic<size_t> ASTArena::s_kindCount{1};
+
+void* ASTArena::allocateBlock(Region& _region, size_t _size, size_t _alignment)
+{
+	solAssert(_alignment > 0 && (_alignment & (_alignment - 1)) == 0, "Invalid alignment.");
+	// Large allocations get a block of their own, so that the current block can still be used.
+	size_t blockSize = max(_region.nextBlockSize, _size + _alignment);
+	_region.blocks.emplace_back(new char[blockSize]);
+	char* block = _region.blocks.back().get();
+	char* result = block + (_alignment - reinterpret_cast<uintptr_t>(block) % _alignment) % _alignment;
+	if (blockSize == _region.nextBlockSize)
+	{
+		_region.next = result + _size;
+		_region.remaining = size_t(block + blockSize - _region.next);
+		_region.nextBlockSize = min(2 * _region.nextBlockSize, c_maxBlockSize);
+	}
+	return result;
+}
@@ -0,0 +1,134 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Bump allocator for the nodes and annotations of a source unit.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Memory region the nodes and annotations of a single source unit are allocated from.
+ * Allocation only moves a pointer forward, nothing is freed individually. All memory is
+ * released at once when the arena is destroyed, so it has to outlive the nodes allocated
+ * from it. The arena is used by one thread at a time and does not lock.
+ * Objects can be grouped by kind, such that e.g. the annotations of all expressions are
+ * stored next to each other instead of being interleaved with the nodes.
+ */
+class ASTArena: private boost::noncopyable
+{
+public:
+	ASTArena(): m_regions(1) {}
+
+	/// @returns @a _size bytes aligned to @a _alignment, valid until the arena is destroyed.
+	void* allocate(size_t _size, size_t _alignment) { return allocate(m_regions.front(), _size, _alignment); }
+	/// @returns @a _size bytes aligned to @a _alignment next to the other objects of kind @a Kind.
+	template <class Kind>
+	void* allocate(size_t _size, size_t _alignment) { return allocate(region(kindIndex<Kind>()), _size, _alignment); }
+	/// @returns the number of bytes handed out so far.
+	size_t usedBytes() const { return m_usedBytes; }
+
+private:
+	/// Blocks start small, such that kinds with few objects do not waste memory, and grow
+	/// up to c_maxBlockSize.
+	static size_t constexpr c_minBlockSize = 4 * 1024;
+	static size_t constexpr c_maxBlockSize = 64 * 1024;
+
+	struct Region
+	{
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char* next = nullptr;
+		size_t remaining = 0;
+		size_t nextBlockSize = c_minBlockSize;
+	};
+
+	/// @returns the index of the region of the objects of kind @a Kind, the same in all arenas.
+	/// It is determined once per kind, index zero is the region of the objects without a kind.
+	template <class Kind>
+	static size_t kindIndex()
+	{
+		static size_t const index = s_kindCount++;
+		return index;
+	}
+	Region& region(size_t _kindIndex)
+	{
+		if (_kindIndex >= m_regions.size())
+			m_regions.resize(_kindIndex + 1);
+		return m_regions[_kindIndex];
+	}
+
+	void* allocate(Region& _region, size_t _size, size_t _alignment)
+	{
+		m_usedBytes += _size;
+		size_t padding = (_alignment - reinterpret_cast<uintptr_t>(_region.next) % _alignment) % _alignment;
+		if (_region.next && padding + _size <= _region.remaining)
+		{
+			char* result = _region.next + padding;
+			_region.next = result + _size;
+			_region.remaining -= padding + _size;
+			return result;
+		}
+		return allocateBlock(_region, _size, _alignment);
+	}
+	/// Adds a block to @a _region and @returns @a _size bytes from it.
+	void* allocateBlock(Region& _region, size_t _size, size_t _alignment);
+
+	static std::atomic<size_t> s_kindCount;
+
+	std::vector<Region> m_regions;
+	size_t m_usedBytes = 0;
+};
+
+/// Allocator that takes memory from an arena, which has to outlive everything allocated.
+template <class T>
+class ASTArenaAllocator
+{
+public:
+	using value_type = T;
+
+	explicit ASTArenaAllocator(ASTArena& _arena): m_arena(&_arena) {}
+	template <class U>
+	ASTArenaAllocator(ASTArenaAllocator<U> const& _other): m_arena(&_other.arena()) {}
+
+	T* allocate(size_t _count) { return static_cast<T*>(m_arena->allocate(_count * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) noexcept {}
+
+	ASTArena& arena() const { return *m_arena; }
+
+	template <class U>
+	bool operator==(ASTArenaAllocator<U> const& _other) const { return m_arena == &_other.arena(); }
+	template <class U>
+	bool operator!=(ASTArenaAllocator<U> const& _other) const { return m_arena != &_other.arena(); }
+
+private:
+	ASTArena* m_arena;
+};
+
+}
+}
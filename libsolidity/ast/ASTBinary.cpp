@@ -0,0 +1,2172 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/ast/ASTBinary.h>
+
+#include <libsolidity/analysis/GlobalContext.h>
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/TypeProvider.h>
+#include <libsolidity/interface/Version.h>
+
+#include <libyul/AsmAnalysis.h>
+#include <libyul/AsmAnalysisInfo.h>
+#include <libyul/AsmData.h>
+#include <libyul/AsmParser.h>
+#include <libyul/backends/evm/EVMDialect.h>
+#include <libyul/optimiser/ASTWalker.h>
+
+#include <liblangutil/ErrorReporter.h>
+#include <liblangutil/Scanner.h>
+
+#include <libdevcore/CommonData.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+using namespace langutil;
+
+namespace
+{
+
+/// Identifies the encoding, has to be changed whenever the encoding changes.
+string const c_magic = "solast2";
+Token const c_lastToken = static_cast<Token>(TokenTraits::count() - 1);
+/// The largest number of bytes of the numerator and denominator of a rational number constant.
+size_t const c_maxRationalBytes = 4096 / 8;
+
+enum class NodeType: uint8_t
+{
+	Null,
+	SourceUnit,
+	PragmaDirective,
+	ImportDirective,
+	ContractDefinition,
+	InheritanceSpecifier,
+	UsingForDirective,
+	StructDefinition,
+	EnumDefinition,
+	EnumValue,
+	ParameterList,
+	OverrideSpecifier,
+	FunctionDefinition,
+	VariableDeclaration,
+	ModifierDefinition,
+	ModifierInvocation,
+	EventDefinition,
+	ElementaryTypeName,
+	UserDefinedTypeName,
+	FunctionTypeName,
+	Mapping,
+	ArrayTypeName,
+	InlineAssembly,
+	Block,
+	PlaceholderStatement,
+	IfStatement,
+	TryCatchClause,
+	TryStatement,
+	WhileStatement,
+	ForStatement,
+	Continue,
+	Break,
+	Return,
+	Throw,
+	EmitStatement,
+	VariableDeclarationStatement,
+	ExpressionStatement,
+	Conditional,
+	Assignment,
+	TupleExpression,
+	UnaryOperation,
+	BinaryOperation,
+	FunctionCall,
+	NewExpression,
+	MemberAccess,
+	IndexAccess,
+	IndexRangeAccess,
+	Identifier,
+	ElementaryTypeNameExpression,
+	Literal
+};
+
+/// The kinds of nodes annotations refer to.
+enum class ReferenceKind
+{
+	Null,
+	/// A node of the source unit or of a source it imports.
+	Node,
+	/// One of the magic variables of the global context, like "msg".
+	MagicVariable,
+	/// The "this" of a contract.
+	This,
+	/// The "super" of a contract.
+	Super
+};
+
+/// @returns the nodes of @a _sourceUnit in the order they are visited.
+vector<ASTNode const*> nodesInOrder(SourceUnit const& _sourceUnit)
+{
+	vector<ASTNode const*> nodes;
+	SimpleASTVisitor collector(
+		[&](ASTNode const& _node)
+		{
+			nodes.push_back(&_node);
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	_sourceUnit.accept(collector);
+	return nodes;
+}
+
+/// @returns the names of the sources that @a _sourceUnit named @a _sourceName imports directly
+/// or indirectly, without the source itself.
+set<string> importedSources(SourceUnit const& _sourceUnit, string const& _sourceName, ASTBinaryContext const& _context)
+{
+	set<string> names;
+	vector<SourceUnit const*> toVisit{&_sourceUnit};
+	while (!toVisit.empty())
+	{
+		SourceUnit const* sourceUnit = toVisit.back();
+		toVisit.pop_back();
+		for (ImportDirective const* import: ASTNode::filteredNodes<ImportDirective>(sourceUnit->nodes()))
+		{
+			string const& path = import->annotation().absolutePath;
+			auto source = _context.sources.find(path);
+			if (names.insert(path).second && source != _context.sources.end() && source->second.ast)
+				toVisit.push_back(source->second.ast);
+		}
+	}
+	names.erase(_sourceName);
+	return names;
+}
+
+/// @returns true if the parser could have produced the elementary type name given by the arguments.
+bool validElementaryTypeName(Token _token, unsigned _firstNumber, unsigned _secondNumber)
+{
+	if (!TokenTraits::isElementaryTypeName(_token))
+		return false;
+	switch (_token)
+	{
+	case Token::BytesM:
+		return 1 <= _firstNumber && _firstNumber <= 32 && _secondNumber == 0;
+	case Token::IntM:
+	case Token::UIntM:
+		return 8 <= _firstNumber && _firstNumber <= 256 && _firstNumber % 8 == 0 && _secondNumber == 0;
+	case Token::FixedMxN:
+	case Token::UFixedMxN:
+		return 8 <= _firstNumber && _firstNumber <= 256 && _firstNumber % 8 == 0 && _secondNumber <= 80;
+	default:
+		return _firstNumber == 0 && _secondNumber == 0;
+	}
+}
+
+/// Collects the identifiers of an inline assembly block by their locations.
+class AssemblyIdentifierCollector: public yul::ASTWalker
+{
+public:
+	using yul::ASTWalker::operator();
+	void operator()(yul::Identifier const& _identifier) override
+	{
+		identifiers[{_identifier.location.start, _identifier.location.end}] = &_identifier;
+	}
+
+	map<pair<int, int>, yul::Identifier const*> identifiers;
+};
+
+}
+
+string ASTBinaryWriter::write(
+	SourceUnit const& _sourceUnit,
+	string const& _sourceName,
+	string_view _source,
+	ASTBinaryContext const* _context
+)
+{
+	// The symbols of imports and the types of type name expressions are not visited.
+	size_t firstID = numeric_limits<size_t>::max();
+	size_t lastID = 0;
+	auto addID = [&](ASTNode const& _node)
+	{
+		firstID = min(firstID, _node.id());
+		lastID = max(lastID, _node.id());
+	};
+	SimpleASTVisitor idRange(
+		[&](ASTNode const& _node)
+		{
+			addID(_node);
+			if (auto import = dynamic_cast<ImportDirective const*>(&_node))
+				for (auto const& symbolAlias: import->symbolAliases())
+					addID(*symbolAlias.symbol);
+			else if (auto expression = dynamic_cast<ElementaryTypeNameExpression const*>(&_node))
+				addID(expression->type());
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	_sourceUnit.accept(idRange);
+
+	ASTBinaryWriter writer;
+	writer.m_firstID = firstID - 1;
+	writer.writeString(c_magic);
+	writer.writeString(VersionString);
+	writer.writeString(_sourceName);
+	writer.writeString(_source);
+	writer.writeString(_context ? writeAnnotations(_sourceUnit, _sourceName, *_context) : string());
+	writer.writeNumber(lastID - writer.m_firstID);
+	writer.writeNode(&_sourceUnit);
+	return std::move(writer.m_data);
+}
+
+string ASTBinaryWriter::writeAnnotations(
+	SourceUnit const& _sourceUnit,
+	string const& _sourceName,
+	ASTBinaryContext const& _context
+)
+{
+	ASTBinaryWriter writer;
+	writer.m_context = &_context;
+	writer.writeString(_context.evmVersion.name());
+
+	// The annotations are only valid as long as the imported sources do not change.
+	vector<SourceUnit const*> sourceUnits{&_sourceUnit};
+	set<string> const imported = importedSources(_sourceUnit, _sourceName, _context);
+	writer.writeNumber(imported.size());
+	for (string const& name: imported)
+	{
+		ASTBinaryContext::Source const& source = _context.sources.at(name);
+		solAssert(source.ast, "");
+		writer.writeString(name);
+		writer.writeString(source.keccak256.hex());
+		sourceUnits.push_back(source.ast);
+	}
+	vector<ImportDirective const*> const imports = ASTNode::filteredNodes<ImportDirective>(_sourceUnit.nodes());
+	writer.writeNumber(imports.size());
+	for (ImportDirective const* import: imports)
+		writer.writeString(import->annotation().absolutePath);
+
+	vector<ASTNode const*> nodes;
+	for (size_t source = 0; source < sourceUnits.size(); ++source)
+	{
+		vector<ASTNode const*> sourceNodes = nodesInOrder(*sourceUnits[source]);
+		for (size_t index = 0; index < sourceNodes.size(); ++index)
+			writer.m_nodeIndices[sourceNodes[index]] = {source, index};
+		if (source == 0)
+			nodes = std::move(sourceNodes);
+	}
+	for (ASTNode const* node: nodes)
+		writer.writeAnnotation(*node);
+	return std::move(writer.m_data);
+}
+
+void ASTBinaryWriter::writeAnnotation(ASTNode const& _node)
+{
+	if (auto sourceUnit = dynamic_cast<SourceUnit const*>(&_node))
+	{
+		set<ExperimentalFeature> const& features = sourceUnit->annotation().experimentalFeatures;
+		writeNumber(features.size());
+		for (ExperimentalFeature feature: features)
+			writeNumber(unsigned(feature));
+	}
+	else if (auto contract = dynamic_cast<ContractDefinition const*>(&_node))
+	{
+		ContractDefinitionAnnotation const& annotation = contract->annotation();
+		writeReferences(annotation.unimplementedFunctions);
+		writeReferences(annotation.linearizedBaseContracts);
+		writeReferences(annotation.contractDependencies);
+		vector<pair<FunctionDefinition const*, ASTNode const*>> arguments(
+			annotation.baseConstructorArguments.begin(),
+			annotation.baseConstructorArguments.end()
+		);
+		sort(arguments.begin(), arguments.end(), [&](auto const& _a, auto const& _b) {
+			return m_nodeIndices.at(_a.first) < m_nodeIndices.at(_b.first);
+		});
+		writeNumber(arguments.size());
+		for (auto const& [constructor, argumentNode]: arguments)
+		{
+			writeReference(constructor);
+			writeReference(argumentNode);
+		}
+	}
+	else if (auto callable = dynamic_cast<CallableDeclaration const*>(&_node))
+		writeReferences(callable->annotation().baseFunctions);
+	else if (auto variable = dynamic_cast<VariableDeclaration const*>(&_node))
+	{
+		writeType(variable->annotation().type);
+		writeReferences(variable->annotation().baseFunctions);
+	}
+	else if (auto inlineAssembly = dynamic_cast<InlineAssembly const*>(&_node))
+	{
+		// The analysis info is computed again from the external references.
+		vector<pair<yul::Identifier const*, InlineAssemblyAnnotation::ExternalIdentifierInfo>> references(
+			inlineAssembly->annotation().externalReferences.begin(),
+			inlineAssembly->annotation().externalReferences.end()
+		);
+		sort(references.begin(), references.end(), [](auto const& _a, auto const& _b) {
+			return _a.first->location.start < _b.first->location.start;
+		});
+		writeNumber(references.size());
+		for (auto const& [identifier, info]: references)
+		{
+			solAssert(info.valueSize == 1 || info.valueSize == size_t(-1), "");
+			writeSignedNumber(identifier->location.start);
+			writeSignedNumber(identifier->location.end);
+			writeReference(info.declaration);
+			writeBool(info.isSlot);
+			writeBool(info.isOffset);
+			writeBool(info.valueSize == 1);
+		}
+	}
+	else if (auto returnStatement = dynamic_cast<Return const*>(&_node))
+		writeReference(returnStatement->annotation().functionReturnParameters);
+	else if (auto typeName = dynamic_cast<TypeName const*>(&_node))
+	{
+		writeType(typeName->annotation().type);
+		if (auto userDefinedTypeName = dynamic_cast<UserDefinedTypeName const*>(typeName))
+			writeReference(userDefinedTypeName->annotation().referencedDeclaration);
+	}
+	else if (auto expression = dynamic_cast<Expression const*>(&_node))
+	{
+		ExpressionAnnotation const& annotation = expression->annotation();
+		writeType(annotation.type);
+		writeBool(annotation.isConstant);
+		writeBool(annotation.isPure);
+		writeBool(annotation.isLValue);
+		writeBool(annotation.lValueRequested);
+		writeBool(annotation.arguments.has_value());
+		if (annotation.arguments)
+		{
+			writeTypes(annotation.arguments->types);
+			writeNumber(annotation.arguments->names.size());
+			for (auto const& name: annotation.arguments->names)
+				writeString(*name);
+		}
+		if (auto identifier = dynamic_cast<Identifier const*>(expression))
+		{
+			writeReference(identifier->annotation().referencedDeclaration);
+			writeReferences(identifier->annotation().overloadedDeclarations);
+		}
+		else if (auto memberAccess = dynamic_cast<MemberAccess const*>(expression))
+			writeReference(memberAccess->annotation().referencedDeclaration);
+		else if (auto binaryOperation = dynamic_cast<BinaryOperation const*>(expression))
+			writeType(binaryOperation->annotation().commonType);
+		else if (auto functionCall = dynamic_cast<FunctionCall const*>(expression))
+		{
+			writeNumber(unsigned(functionCall->annotation().kind));
+			writeBool(functionCall->annotation().tryCall);
+		}
+	}
+}
+
+void ASTBinaryWriter::writeReference(ASTNode const* _node)
+{
+	if (!_node)
+		writeNumber(unsigned(ReferenceKind::Null));
+	else if (m_nodeIndices.count(_node))
+	{
+		writeNumber(unsigned(ReferenceKind::Node));
+		writeNumber(m_nodeIndices.at(_node).first);
+		writeNumber(m_nodeIndices.at(_node).second);
+	}
+	else
+	{
+		auto variable = dynamic_cast<MagicVariableDeclaration const*>(_node);
+		solAssert(variable, "Annotation refers to a node outside of the imported sources.");
+		if (variable->name() == "this" || variable->name() == "super")
+		{
+			auto contractType = dynamic_cast<ContractType const*>(variable->type());
+			solAssert(contractType, "");
+			writeNumber(unsigned(contractType->isSuper() ? ReferenceKind::Super : ReferenceKind::This));
+			writeReference(&contractType->contractDefinition());
+		}
+		else
+		{
+			solAssert(m_context && m_context->globalContext, "");
+			vector<Declaration const*> const variables = m_context->globalContext->declarations();
+			auto position = find(variables.begin(), variables.end(), variable);
+			solAssert(position != variables.end(), "Unknown magic variable.");
+			writeNumber(unsigned(ReferenceKind::MagicVariable));
+			writeNumber(size_t(position - variables.begin()));
+		}
+	}
+}
+
+template <class T>
+void ASTBinaryWriter::writeReferences(vector<T const*> const& _nodes)
+{
+	writeNumber(_nodes.size());
+	for (T const* node: _nodes)
+		writeReference(node);
+}
+
+template <class T>
+void ASTBinaryWriter::writeReferences(set<T const*> const& _nodes)
+{
+	// Sets of nodes are ordered by their addresses, which differ between compilations.
+	vector<T const*> nodes(_nodes.begin(), _nodes.end());
+	sort(nodes.begin(), nodes.end(), [&](T const* _a, T const* _b) {
+		return m_nodeIndices.at(_a) < m_nodeIndices.at(_b);
+	});
+	writeReferences(nodes);
+}
+
+void ASTBinaryWriter::writeType(Type const* _type)
+{
+	if (!_type)
+	{
+		writeNumber(0);
+		return;
+	}
+	writeNumber(unsigned(_type->category()) + 1);
+	switch (_type->category())
+	{
+	case Type::Category::Address:
+		writeNumber(unsigned(dynamic_cast<AddressType const&>(*_type).stateMutability()));
+		break;
+	case Type::Category::Integer:
+	{
+		auto const& integer = dynamic_cast<IntegerType const&>(*_type);
+		writeNumber(integer.numBits());
+		writeBool(integer.isSigned());
+		break;
+	}
+	case Type::Category::RationalNumber:
+	{
+		auto const& number = dynamic_cast<RationalNumberType const&>(*_type);
+		writeInteger(number.value().numerator());
+		writeInteger(number.value().denominator());
+		writeType(number.compatibleBytesType());
+		break;
+	}
+	case Type::Category::StringLiteral:
+		writeString(dynamic_cast<StringLiteralType const&>(*_type).value());
+		break;
+	case Type::Category::Bool:
+	case Type::Category::InaccessibleDynamic:
+		break;
+	case Type::Category::FixedPoint:
+	{
+		auto const& fixedPoint = dynamic_cast<FixedPointType const&>(*_type);
+		writeNumber(fixedPoint.numBits());
+		writeNumber(fixedPoint.fractionalDigits());
+		writeBool(fixedPoint.isSigned());
+		break;
+	}
+	case Type::Category::Array:
+	{
+		auto const& array = dynamic_cast<ArrayType const&>(*_type);
+		writeNumber(unsigned(array.location()));
+		writeBool(array.isPointer());
+		writeBool(array.isByteArray());
+		if (array.isByteArray())
+			writeBool(array.isString());
+		else
+		{
+			writeType(array.baseType());
+			writeBool(array.isDynamicallySized());
+			if (!array.isDynamicallySized())
+				writeInteger(bigint(array.length()));
+		}
+		break;
+	}
+	case Type::Category::ArraySlice:
+		writeType(&dynamic_cast<ArraySliceType const&>(*_type).arrayType());
+		break;
+	case Type::Category::FixedBytes:
+		writeNumber(dynamic_cast<FixedBytesType const&>(*_type).numBytes());
+		break;
+	case Type::Category::Contract:
+	{
+		auto const& contract = dynamic_cast<ContractType const&>(*_type);
+		writeReference(&contract.contractDefinition());
+		writeBool(contract.isSuper());
+		break;
+	}
+	case Type::Category::Struct:
+	{
+		auto const& structType = dynamic_cast<StructType const&>(*_type);
+		writeReference(&structType.structDefinition());
+		writeNumber(unsigned(structType.location()));
+		writeBool(structType.isPointer());
+		break;
+	}
+	case Type::Category::Function:
+	{
+		// The parameters include the bound "self", whose name does not matter.
+		auto const& function = dynamic_cast<FunctionType const&>(*_type);
+		writeNumber(unsigned(function.kind()));
+		writeNumber(unsigned(function.stateMutability()));
+		writeBool(function.takesArbitraryParameters());
+		writeBool(function.gasSet());
+		writeBool(function.valueSet());
+		writeBool(function.bound());
+		if (function.bound())
+			writeType(function.selfType());
+		writeTypes(function.parameterTypes());
+		for (string const& name: function.parameterNames())
+			writeString(name);
+		writeTypes(function.returnParameterTypes());
+		for (string const& name: function.returnParameterNames())
+			writeString(name);
+		writeReference(function.hasDeclaration() ? &function.declaration() : nullptr);
+		break;
+	}
+	case Type::Category::Enum:
+		writeReference(&dynamic_cast<EnumType const&>(*_type).enumDefinition());
+		break;
+	case Type::Category::Tuple:
+		writeTypes(dynamic_cast<TupleType const&>(*_type).components());
+		break;
+	case Type::Category::Mapping:
+	{
+		auto const& mapping = dynamic_cast<MappingType const&>(*_type);
+		writeType(mapping.keyType());
+		writeType(mapping.valueType());
+		break;
+	}
+	case Type::Category::TypeType:
+		writeType(dynamic_cast<TypeType const&>(*_type).actualType());
+		break;
+	case Type::Category::Modifier:
+		writeTypes(dynamic_cast<ModifierType const&>(*_type).parameterTypes());
+		break;
+	case Type::Category::Magic:
+	{
+		auto const& magic = dynamic_cast<MagicType const&>(*_type);
+		writeNumber(unsigned(magic.kind()));
+		if (magic.kind() == MagicType::Kind::MetaType)
+			writeType(magic.typeArgument());
+		break;
+	}
+	case Type::Category::Module:
+		writeReference(&dynamic_cast<ModuleType const&>(*_type).sourceUnit());
+		break;
+	}
+}
+
+void ASTBinaryWriter::writeTypes(vector<Type const*> const& _types)
+{
+	writeNumber(_types.size());
+	for (Type const* type: _types)
+		writeType(type);
+}
+
+void ASTBinaryWriter::writeNode(ASTNode const* _node)
+{
+	if (_node)
+		_node->accept(*this);
+	else
+		writeNumber(uint8_t(NodeType::Null));
+}
+
+void ASTBinaryWriter::writeHeader(ASTNode const& _node, uint8_t _type)
+{
+	writeNumber(_type);
+	writeNumber(_node.id() - m_firstID);
+	writeLocation(_node.location());
+}
+
+void ASTBinaryWriter::writeNumber(uint64_t _value)
+{
+	while (_value >= 0x80)
+	{
+		m_data.push_back(char(0x80 | (_value & 0x7f)));
+		_value >>= 7;
+	}
+	m_data.push_back(char(_value));
+}
+
+void ASTBinaryWriter::writeSignedNumber(int64_t _value)
+{
+	writeNumber((uint64_t(_value) << 1) ^ uint64_t(_value >> 63));
+}
+
+void ASTBinaryWriter::writeInteger(bigint const& _value)
+{
+	bytes const magnitude = toCompactBigEndian(_value < 0 ? bigint(-_value) : _value);
+	writeBool(_value < 0);
+	writeString(string(magnitude.begin(), magnitude.end()));
+}
+
+void ASTBinaryWriter::writeString(string_view _value)
+{
+	writeNumber(_value.size());
+	m_data += _value;
+}
+
+void ASTBinaryWriter::writeOptionalString(ASTPointer<ASTString> const& _value)
+{
+	writeBool(bool(_value));
+	if (_value)
+		writeString(*_value);
+}
+
+void ASTBinaryWriter::writeLocation(SourceLocation const& _location)
+{
+	writeBool(bool(_location.source));
+	writeSignedNumber(_location.start);
+	writeSignedNumber(_location.end);
+}
+
+bool ASTBinaryWriter::visit(SourceUnit const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::SourceUnit));
+	writeNodes(_node.nodes());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(PragmaDirective const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::PragmaDirective));
+	writeNumber(_node.tokens().size());
+	for (Token token: _node.tokens())
+		writeNumber(unsigned(token));
+	writeNumber(_node.literals().size());
+	for (ASTString const& literal: _node.literals())
+		writeString(literal);
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ImportDirective const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ImportDirective));
+	writeString(_node.path());
+	writeString(_node.name());
+	writeNumber(_node.symbolAliases().size());
+	for (auto const& symbolAlias: _node.symbolAliases())
+	{
+		writeNode(symbolAlias.symbol.get());
+		writeOptionalString(symbolAlias.alias);
+		writeLocation(symbolAlias.location);
+	}
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ContractDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ContractDefinition));
+	writeString(_node.name());
+	writeOptionalString(_node.documentation());
+	writeNodes(_node.baseContracts());
+	writeNodes(_node.subNodes());
+	writeNumber(unsigned(_node.contractKind()));
+	writeBool(_node.abstract());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(InheritanceSpecifier const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::InheritanceSpecifier));
+	writeNode(&_node.name());
+	writeBool(_node.arguments());
+	if (_node.arguments())
+		writeNodes(*_node.arguments());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(UsingForDirective const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::UsingForDirective));
+	writeNode(&_node.libraryName());
+	writeNode(_node.typeName());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(StructDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::StructDefinition));
+	writeString(_node.name());
+	writeNodes(_node.members());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(EnumDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::EnumDefinition));
+	writeString(_node.name());
+	writeNodes(_node.members());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(EnumValue const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::EnumValue));
+	writeString(_node.name());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ParameterList const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ParameterList));
+	writeNodes(_node.parameters());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(OverrideSpecifier const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::OverrideSpecifier));
+	writeNodes(_node.overrides());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(FunctionDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::FunctionDefinition));
+	writeString(_node.name());
+	writeNumber(unsigned(_node.noVisibilitySpecified() ? Visibility::Default : _node.visibility()));
+	writeNumber(unsigned(_node.stateMutability()));
+	writeNumber(unsigned(_node.kind()));
+	writeBool(_node.markedVirtual());
+	writeNode(_node.overrides().get());
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.parameterList());
+	writeNodes(_node.modifiers());
+	writeNode(_node.returnParameterList().get());
+	writeNode(_node.isImplemented() ? &_node.body() : nullptr);
+	return false;
+}
+
+bool ASTBinaryWriter::visit(VariableDeclaration const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::VariableDeclaration));
+	writeNode(_node.typeName());
+	writeString(_node.name());
+	writeNode(_node.value().get());
+	writeNumber(unsigned(_node.noVisibilitySpecified() ? Visibility::Default : _node.visibility()));
+	writeBool(_node.isStateVariable());
+	writeBool(_node.isIndexed());
+	writeBool(_node.isConstant());
+	writeNode(_node.overrides().get());
+	writeNumber(unsigned(_node.referenceLocation()));
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ModifierDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ModifierDefinition));
+	writeString(_node.name());
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.parameterList());
+	writeBool(_node.markedVirtual());
+	writeNode(_node.overrides().get());
+	writeNode(&_node.body());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ModifierInvocation const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ModifierInvocation));
+	writeNode(_node.name().get());
+	writeBool(_node.arguments());
+	if (_node.arguments())
+		writeNodes(*_node.arguments());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(EventDefinition const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::EventDefinition));
+	writeString(_node.name());
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.parameterList());
+	writeBool(_node.isAnonymous());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ElementaryTypeName const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ElementaryTypeName));
+	writeNumber(unsigned(_node.typeName().token()));
+	writeNumber(_node.typeName().firstNumber());
+	writeNumber(_node.typeName().secondNumber());
+	writeBool(_node.stateMutability().has_value());
+	if (_node.stateMutability())
+		writeNumber(unsigned(*_node.stateMutability()));
+	return false;
+}
+
+bool ASTBinaryWriter::visit(UserDefinedTypeName const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::UserDefinedTypeName));
+	writeNumber(_node.namePath().size());
+	for (ASTString const& name: _node.namePath())
+		writeString(name);
+	return false;
+}
+
+bool ASTBinaryWriter::visit(FunctionTypeName const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::FunctionTypeName));
+	writeNode(_node.parameterTypeList().get());
+	writeNode(_node.returnParameterTypeList().get());
+	writeNumber(unsigned(_node.visibility()));
+	writeNumber(unsigned(_node.stateMutability()));
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Mapping const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Mapping));
+	writeNode(&_node.keyType());
+	writeNode(&_node.valueType());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ArrayTypeName const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ArrayTypeName));
+	writeNode(&_node.baseType());
+	writeNode(_node.length());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(InlineAssembly const& _node)
+{
+	// The assembly block is parsed again from the source, which is part of the encoding.
+	writeHeader(_node, uint8_t(NodeType::InlineAssembly));
+	writeOptionalString(_node.documentation());
+	writeSignedNumber(_node.operations().location.start);
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Block const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Block));
+	writeOptionalString(_node.documentation());
+	writeNodes(_node.statements());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(PlaceholderStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::PlaceholderStatement));
+	writeOptionalString(_node.documentation());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(IfStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::IfStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.condition());
+	writeNode(&_node.trueStatement());
+	writeNode(_node.falseStatement());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(TryCatchClause const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::TryCatchClause));
+	writeString(_node.errorName());
+	writeNode(_node.parameters());
+	writeNode(&_node.block());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(TryStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::TryStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.externalCall());
+	writeNodes(_node.clauses());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(WhileStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::WhileStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.condition());
+	writeNode(&_node.body());
+	writeBool(_node.isDoWhile());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ForStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ForStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(_node.initializationExpression());
+	writeNode(_node.condition());
+	writeNode(_node.loopExpression());
+	writeNode(&_node.body());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Continue const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Continue));
+	writeOptionalString(_node.documentation());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Break const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Break));
+	writeOptionalString(_node.documentation());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Return const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Return));
+	writeOptionalString(_node.documentation());
+	writeNode(_node.expression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Throw const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Throw));
+	writeOptionalString(_node.documentation());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(EmitStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::EmitStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.eventCall());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(VariableDeclarationStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::VariableDeclarationStatement));
+	writeOptionalString(_node.documentation());
+	writeNodes(_node.declarations());
+	writeNode(_node.initialValue());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ExpressionStatement const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ExpressionStatement));
+	writeOptionalString(_node.documentation());
+	writeNode(&_node.expression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Conditional const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Conditional));
+	writeNode(&_node.condition());
+	writeNode(&_node.trueExpression());
+	writeNode(&_node.falseExpression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Assignment const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Assignment));
+	writeNode(&_node.leftHandSide());
+	writeNumber(unsigned(_node.assignmentOperator()));
+	writeNode(&_node.rightHandSide());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(TupleExpression const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::TupleExpression));
+	writeNodes(_node.components());
+	writeBool(_node.isInlineArray());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(UnaryOperation const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::UnaryOperation));
+	writeNumber(unsigned(_node.getOperator()));
+	writeNode(&_node.subExpression());
+	writeBool(_node.isPrefixOperation());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(BinaryOperation const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::BinaryOperation));
+	writeNode(&_node.leftExpression());
+	writeNumber(unsigned(_node.getOperator()));
+	writeNode(&_node.rightExpression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(FunctionCall const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::FunctionCall));
+	writeNode(&_node.expression());
+	writeNodes(_node.arguments());
+	writeNumber(_node.names().size());
+	for (auto const& name: _node.names())
+		writeString(*name);
+	return false;
+}
+
+bool ASTBinaryWriter::visit(NewExpression const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::NewExpression));
+	writeNode(&_node.typeName());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(MemberAccess const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::MemberAccess));
+	writeNode(&_node.expression());
+	writeString(_node.memberName());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(IndexAccess const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::IndexAccess));
+	writeNode(&_node.baseExpression());
+	writeNode(_node.indexExpression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(IndexRangeAccess const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::IndexRangeAccess));
+	writeNode(&_node.baseExpression());
+	writeNode(_node.startExpression());
+	writeNode(_node.endExpression());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Identifier const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Identifier));
+	writeString(_node.name());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(ElementaryTypeNameExpression const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::ElementaryTypeNameExpression));
+	writeNode(&_node.type());
+	return false;
+}
+
+bool ASTBinaryWriter::visit(Literal const& _node)
+{
+	writeHeader(_node, uint8_t(NodeType::Literal));
+	writeNumber(unsigned(_node.token()));
+	writeString(_node.value());
+	writeNumber(unsigned(int(_node.subDenomination())));
+	return false;
+}
+
+ASTBinaryReader::ASTBinaryReader(
+	string const& _data,
+	shared_ptr<Scanner> _scanner,
+	EVMVersion _evmVersion,
+	ASTArena* _arena
+):
+	m_data(_data),
+	m_scanner(std::move(_scanner)),
+	m_evmVersion(_evmVersion),
+	m_arena(_arena)
+{
+}
+
+string ASTBinaryReader::sourceName(string const& _data)
+{
+	return ASTBinaryReader(_data, nullptr, EVMVersion(), nullptr).readSource().first;
+}
+
+string ASTBinaryReader::sourceContent(string const& _data)
+{
+	return ASTBinaryReader(_data, nullptr, EVMVersion(), nullptr).readSource().second;
+}
+
+ASTPointer<SourceUnit> ASTBinaryReader::read(
+	string const& _data,
+	shared_ptr<Scanner> const& _scanner,
+	EVMVersion _evmVersion,
+	ASTArena* _arena
+)
+{
+	ASTBinaryReader reader(_data, _scanner, _evmVersion, _arena);
+	if (reader.readSource().second != _scanner->source())
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Source does not match the encoded AST."));
+	// The annotations are restored by readAnnotations once the imported sources are known.
+	reader.readString();
+	reader.m_firstID = ASTNode::lastID();
+	reader.m_idCount = reader.readNumber();
+	if (reader.m_idCount > numeric_limits<size_t>::max() - reader.m_firstID)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid AST encoding."));
+	ASTPointer<SourceUnit> sourceUnit = reader.readNode<SourceUnit>();
+	if (reader.m_position != _data.size())
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid AST encoding."));
+	ASTNode::resetID(reader.m_firstID + reader.m_idCount);
+	return sourceUnit;
+}
+
+bool ASTBinaryReader::readAnnotations(string const& _data, SourceUnit const& _sourceUnit, ASTBinaryContext const& _context)
+{
+	ASTBinaryReader reader(_data, nullptr, _context.evmVersion, nullptr);
+	string const sourceName = reader.readSource().first;
+	string const annotations = reader.readString();
+	if (annotations.empty())
+		return false;
+
+	ASTBinaryReader annotationReader(annotations, nullptr, _context.evmVersion, nullptr);
+	annotationReader.m_context = &_context;
+	if (!annotationReader.readDependencies(_sourceUnit, sourceName))
+		return false;
+	for (ASTNode const* node: annotationReader.sourceNodes(0))
+		annotationReader.readAnnotation(*node);
+	if (annotationReader.m_position != annotations.size())
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid AST annotation encoding."));
+	return true;
+}
+
+pair<string, string> ASTBinaryReader::readSource()
+{
+	if (readString() != c_magic)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Not an AST encoding."));
+	if (readString() != VersionString)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("AST was encoded by a different compiler version."));
+	string name = readString();
+	string content = readString();
+	return {std::move(name), std::move(content)};
+}
+
+bool ASTBinaryReader::readDependencies(SourceUnit const& _sourceUnit, string const& _sourceName)
+{
+	if (readString() != m_context->evmVersion.name())
+		return false;
+
+	set<string> const imported = importedSources(_sourceUnit, _sourceName, *m_context);
+	if (readCount() != imported.size())
+		return false;
+	m_sourceUnits = {&_sourceUnit};
+	for (string const& name: imported)
+	{
+		auto source = m_context->sources.find(name);
+		if (
+			readString() != name ||
+			source == m_context->sources.end() ||
+			!source->second.ast ||
+			readString() != source->second.keccak256.hex()
+		)
+			return false;
+		m_sourceUnits.push_back(source->second.ast);
+	}
+
+	vector<ImportDirective const*> const imports = ASTNode::filteredNodes<ImportDirective>(_sourceUnit.nodes());
+	if (readCount() != imports.size())
+		return false;
+	for (ImportDirective const* import: imports)
+		if (readString() != import->annotation().absolutePath)
+			return false;
+
+	m_nodes.resize(m_sourceUnits.size());
+	return true;
+}
+
+vector<ASTNode const*> const& ASTBinaryReader::sourceNodes(size_t _sourceIndex)
+{
+	if (!m_nodes.at(_sourceIndex))
+		m_nodes[_sourceIndex] = nodesInOrder(*m_sourceUnits.at(_sourceIndex));
+	return *m_nodes[_sourceIndex];
+}
+
+void ASTBinaryReader::readAnnotation(ASTNode const& _node)
+{
+	if (auto sourceUnit = dynamic_cast<SourceUnit const*>(&_node))
+	{
+		set<ExperimentalFeature> features;
+		for (size_t count = readCount(); count > 0; --count)
+			features.insert(readEnum(ExperimentalFeature::TestOnlyAnalysis));
+		sourceUnit->annotation().experimentalFeatures = std::move(features);
+	}
+	else if (auto contract = dynamic_cast<ContractDefinition const*>(&_node))
+	{
+		ContractDefinitionAnnotation& annotation = contract->annotation();
+		annotation.unimplementedFunctions = readReferences<FunctionDefinition>();
+		annotation.linearizedBaseContracts = readReferences<ContractDefinition>();
+		vector<ContractDefinition const*> dependencies = readReferences<ContractDefinition>();
+		annotation.contractDependencies = set<ContractDefinition const*>(dependencies.begin(), dependencies.end());
+		annotation.baseConstructorArguments.clear();
+		for (size_t count = readCount(); count > 0; --count)
+		{
+			auto constructor = readReference<FunctionDefinition>();
+			auto arguments = readReference<ASTNode>();
+			if (!constructor || !arguments)
+				BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid base constructor arguments."));
+			annotation.baseConstructorArguments[constructor] = arguments;
+		}
+	}
+	else if (auto callable = dynamic_cast<CallableDeclaration const*>(&_node))
+	{
+		vector<CallableDeclaration const*> baseFunctions = readReferences<CallableDeclaration>();
+		callable->annotation().baseFunctions = set<CallableDeclaration const*>(baseFunctions.begin(), baseFunctions.end());
+	}
+	else if (auto variable = dynamic_cast<VariableDeclaration const*>(&_node))
+	{
+		variable->annotation().type = readType();
+		vector<CallableDeclaration const*> baseFunctions = readReferences<CallableDeclaration>();
+		variable->annotation().baseFunctions = set<CallableDeclaration const*>(baseFunctions.begin(), baseFunctions.end());
+	}
+	else if (auto inlineAssembly = dynamic_cast<InlineAssembly const*>(&_node))
+		readAssemblyAnnotation(*inlineAssembly);
+	else if (auto returnStatement = dynamic_cast<Return const*>(&_node))
+		returnStatement->annotation().functionReturnParameters = readReference<ParameterList>();
+	else if (auto typeName = dynamic_cast<TypeName const*>(&_node))
+	{
+		typeName->annotation().type = readType();
+		if (auto userDefinedTypeName = dynamic_cast<UserDefinedTypeName const*>(typeName))
+			userDefinedTypeName->annotation().referencedDeclaration = readReference<Declaration>();
+	}
+	else if (auto expression = dynamic_cast<Expression const*>(&_node))
+	{
+		ExpressionAnnotation& annotation = expression->annotation();
+		annotation.type = readType();
+		annotation.isConstant = readBool();
+		annotation.isPure = readBool();
+		annotation.isLValue = readBool();
+		annotation.lValueRequested = readBool();
+		annotation.arguments.reset();
+		if (readBool())
+		{
+			FuncCallArguments arguments;
+			arguments.types = readTypes();
+			arguments.names.resize(readCount());
+			for (auto& name: arguments.names)
+				name = readStringPointer();
+			annotation.arguments = std::move(arguments);
+		}
+		if (auto identifier = dynamic_cast<Identifier const*>(expression))
+		{
+			identifier->annotation().referencedDeclaration = readReference<Declaration>();
+			identifier->annotation().overloadedDeclarations = readReferences<Declaration>();
+		}
+		else if (auto memberAccess = dynamic_cast<MemberAccess const*>(expression))
+			memberAccess->annotation().referencedDeclaration = readReference<Declaration>();
+		else if (auto binaryOperation = dynamic_cast<BinaryOperation const*>(expression))
+			binaryOperation->annotation().commonType = readType();
+		else if (auto functionCall = dynamic_cast<FunctionCall const*>(expression))
+		{
+			functionCall->annotation().kind = readEnum(FunctionCallKind::StructConstructorCall);
+			functionCall->annotation().tryCall = readBool();
+		}
+	}
+}
+
+void ASTBinaryReader::readAssemblyAnnotation(InlineAssembly const& _inlineAssembly)
+{
+	AssemblyIdentifierCollector collector;
+	collector(_inlineAssembly.operations());
+
+	InlineAssemblyAnnotation& annotation = _inlineAssembly.annotation();
+	annotation.externalReferences.clear();
+	for (size_t count = readCount(); count > 0; --count)
+	{
+		int start = int(readSignedNumber());
+		int end = int(readSignedNumber());
+		auto identifier = collector.identifiers.find({start, end});
+		if (identifier == collector.identifiers.end())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid inline assembly reference."));
+		InlineAssemblyAnnotation::ExternalIdentifierInfo& info = annotation.externalReferences[identifier->second];
+		info.declaration = readReference<Declaration>();
+		if (!info.declaration)
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid inline assembly reference."));
+		info.isSlot = readBool();
+		info.isOffset = readBool();
+		info.valueSize = readBool() ? 1 : size_t(-1);
+	}
+
+	// Analyse the block again with the restored references, like the type checker does.
+	yul::ExternalIdentifierAccess::Resolver resolver = [&](yul::Identifier const& _identifier, yul::IdentifierContext, bool)
+	{
+		auto reference = annotation.externalReferences.find(&_identifier);
+		return reference == annotation.externalReferences.end() ? size_t(-1) : reference->second.valueSize;
+	};
+	annotation.analysisInfo = make_shared<yul::AsmAnalysisInfo>();
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	bool success = false;
+	try
+	{
+		yul::AsmAnalyzer analyzer(*annotation.analysisInfo, errorReporter, _inlineAssembly.dialect(), resolver);
+		success = analyzer.analyze(_inlineAssembly.operations());
+	}
+	catch (FatalError const&)
+	{
+	}
+	if (!success)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid inline assembly references."));
+}
+
+ASTNode const* ASTBinaryReader::readReference()
+{
+	ReferenceKind kind = readEnum(ReferenceKind::Super);
+	switch (kind)
+	{
+	case ReferenceKind::Null:
+		return nullptr;
+	case ReferenceKind::Node:
+	{
+		size_t sourceIndex = readNumber();
+		if (sourceIndex >= m_sourceUnits.size())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+		vector<ASTNode const*> const& nodes = sourceNodes(sourceIndex);
+		size_t index = readNumber();
+		if (index >= nodes.size())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+		return nodes[index];
+	}
+	case ReferenceKind::MagicVariable:
+	{
+		if (!m_context->globalContext)
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+		if (!m_magicVariables)
+			m_magicVariables = m_context->globalContext->declarations();
+		size_t index = readNumber();
+		if (index >= m_magicVariables->size())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+		return (*m_magicVariables)[index];
+	}
+	case ReferenceKind::This:
+	case ReferenceKind::Super:
+	{
+		auto contract = readReference<ContractDefinition>();
+		if (!contract || !m_context->globalContext)
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+		m_context->globalContext->setCurrentContract(*contract);
+		if (kind == ReferenceKind::Super)
+			return m_context->globalContext->currentSuper();
+		return m_context->globalContext->currentThis();
+	}
+	}
+	solAssert(false, "");
+	return nullptr;
+}
+
+template <class T>
+T const* ASTBinaryReader::readReference()
+{
+	ASTNode const* node = readReference();
+	auto result = dynamic_cast<T const*>(node);
+	if (node && !result)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Unexpected reference type."));
+	return result;
+}
+
+template <class T>
+vector<T const*> ASTBinaryReader::readReferences()
+{
+	vector<T const*> nodes(readCount());
+	for (T const*& node: nodes)
+	{
+		node = readReference<T>();
+		if (!node)
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid reference in AST encoding."));
+	}
+	return nodes;
+}
+
+Type const* ASTBinaryReader::readType()
+{
+	uint64_t encodedCategory = readNumber();
+	if (encodedCategory == 0)
+		return nullptr;
+	if (encodedCategory - 1 > uint64_t(Type::Category::InaccessibleDynamic))
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid type category."));
+	auto invalidType = []() {
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid type in AST encoding."));
+	};
+	auto readRequiredType = [&]() {
+		Type const* type = readType();
+		if (!type)
+			invalidType();
+		return type;
+	};
+
+	switch (static_cast<Type::Category>(encodedCategory - 1))
+	{
+	case Type::Category::Address:
+	{
+		auto stateMutability = readEnum(StateMutability::Payable);
+		if (stateMutability == StateMutability::Payable)
+			return TypeProvider::payableAddress();
+		if (stateMutability != StateMutability::NonPayable)
+			invalidType();
+		return TypeProvider::address();
+	}
+	case Type::Category::Integer:
+	{
+		uint64_t bits = readNumber();
+		bool isSigned = readBool();
+		if (bits < 8 || bits > 256 || bits % 8 != 0)
+			invalidType();
+		return TypeProvider::integer(unsigned(bits), isSigned ? IntegerType::Modifier::Signed : IntegerType::Modifier::Unsigned);
+	}
+	case Type::Category::RationalNumber:
+	{
+		bigint numerator = readInteger(c_maxRationalBytes);
+		bigint denominator = readInteger(c_maxRationalBytes);
+		if (denominator <= 0)
+			invalidType();
+		Type const* compatibleBytesType = readType();
+		if (compatibleBytesType && compatibleBytesType->category() != Type::Category::FixedBytes)
+			invalidType();
+		return TypeProvider::rationalNumber(rational(numerator, denominator), compatibleBytesType);
+	}
+	case Type::Category::StringLiteral:
+		return TypeProvider::stringLiteral(readString());
+	case Type::Category::Bool:
+		return TypeProvider::boolean();
+	case Type::Category::FixedPoint:
+	{
+		uint64_t bits = readNumber();
+		uint64_t digits = readNumber();
+		bool isSigned = readBool();
+		if (bits < 8 || bits > 256 || bits % 8 != 0 || digits > 80)
+			invalidType();
+		return TypeProvider::fixedPoint(
+			unsigned(bits),
+			unsigned(digits),
+			isSigned ? FixedPointType::Modifier::Signed : FixedPointType::Modifier::Unsigned
+		);
+	}
+	case Type::Category::Array:
+	{
+		auto location = readEnum(DataLocation::Memory);
+		bool isPointer = readBool();
+		ArrayType const* array = nullptr;
+		if (readBool())
+			array = TypeProvider::array(location, readBool());
+		else
+		{
+			Type const* baseType = readRequiredType();
+			if (readBool())
+				array = TypeProvider::array(location, baseType);
+			else
+			{
+				bigint length = readInteger(32);
+				if (length < 0)
+					invalidType();
+				array = TypeProvider::array(location, baseType, u256(length));
+			}
+		}
+		return TypeProvider::withLocation(array, location, isPointer);
+	}
+	case Type::Category::ArraySlice:
+	{
+		auto array = dynamic_cast<ArrayType const*>(readRequiredType());
+		if (!array)
+			invalidType();
+		return TypeProvider::arraySlice(*array);
+	}
+	case Type::Category::FixedBytes:
+	{
+		uint64_t bytes = readNumber();
+		if (bytes < 1 || bytes > 32)
+			invalidType();
+		return TypeProvider::fixedBytes(unsigned(bytes));
+	}
+	case Type::Category::Contract:
+	{
+		auto contract = readReference<ContractDefinition>();
+		if (!contract)
+			invalidType();
+		return TypeProvider::contract(*contract, readBool());
+	}
+	case Type::Category::Struct:
+	{
+		auto structDefinition = readReference<StructDefinition>();
+		if (!structDefinition)
+			invalidType();
+		auto location = readEnum(DataLocation::Memory);
+		bool isPointer = readBool();
+		return TypeProvider::withLocation(TypeProvider::structType(*structDefinition, location), location, isPointer);
+	}
+	case Type::Category::Function:
+	{
+		auto kind = readEnum(FunctionType::Kind::MetaType);
+		auto stateMutability = readEnum(StateMutability::Payable);
+		bool arbitraryParameters = readBool();
+		bool gasSet = readBool();
+		bool valueSet = readBool();
+		bool bound = readBool();
+		TypePointers parameterTypes;
+		strings parameterNames;
+		if (bound)
+		{
+			parameterTypes.push_back(readRequiredType());
+			parameterNames.emplace_back();
+		}
+		for (Type const* type: readTypes())
+			parameterTypes.push_back(type);
+		for (size_t i = parameterNames.size(); i < parameterTypes.size(); ++i)
+			parameterNames.push_back(readString());
+		TypePointers returnParameterTypes = readTypes();
+		strings returnParameterNames(returnParameterTypes.size());
+		for (string& name: returnParameterNames)
+			name = readString();
+		auto declaration = readReference<Declaration>();
+		return TypeProvider::function(
+			parameterTypes,
+			returnParameterTypes,
+			std::move(parameterNames),
+			std::move(returnParameterNames),
+			kind,
+			arbitraryParameters,
+			stateMutability,
+			declaration,
+			gasSet,
+			valueSet,
+			bound
+		);
+	}
+	case Type::Category::Enum:
+	{
+		auto enumDefinition = readReference<EnumDefinition>();
+		if (!enumDefinition)
+			invalidType();
+		return TypeProvider::enumType(*enumDefinition);
+	}
+	case Type::Category::Tuple:
+		return TypeProvider::tuple(readTypes(true));
+	case Type::Category::Mapping:
+	{
+		Type const* keyType = readRequiredType();
+		Type const* valueType = readRequiredType();
+		return TypeProvider::mapping(keyType, valueType);
+	}
+	case Type::Category::TypeType:
+		return TypeProvider::typeType(readRequiredType());
+	case Type::Category::Modifier:
+		return TypeProvider::modifier(readTypes());
+	case Type::Category::Magic:
+	{
+		auto kind = readEnum(MagicType::Kind::MetaType);
+		if (kind != MagicType::Kind::MetaType)
+			return TypeProvider::magic(kind);
+		Type const* typeArgument = readRequiredType();
+		if (typeArgument->category() != Type::Category::Contract)
+			invalidType();
+		return TypeProvider::meta(typeArgument);
+	}
+	case Type::Category::Module:
+	{
+		auto sourceUnit = readReference<SourceUnit>();
+		if (!sourceUnit)
+			invalidType();
+		return TypeProvider::module(*sourceUnit);
+	}
+	case Type::Category::InaccessibleDynamic:
+		return TypeProvider::inaccessibleDynamic();
+	}
+	solAssert(false, "");
+	return nullptr;
+}
+
+vector<Type const*> ASTBinaryReader::readTypes(bool _allowNull)
+{
+	vector<Type const*> types(readCount());
+	for (Type const*& type: types)
+	{
+		type = readType();
+		if (!type && !_allowNull)
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid type in AST encoding."));
+	}
+	return types;
+}
+
+template <class T>
+ASTPointer<T> ASTBinaryReader::readNode()
+{
+	ASTPointer<T> node = readOptionalNode<T>();
+	if (!node)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Missing node in AST encoding."));
+	return node;
+}
+
+template <class T>
+ASTPointer<T> ASTBinaryReader::readOptionalNode()
+{
+	ASTPointer<ASTNode> node = readNode();
+	ASTPointer<T> result = dynamic_pointer_cast<T>(node);
+	if (node && !result)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Unexpected node type."));
+	return result;
+}
+
+template <class T>
+vector<ASTPointer<T>> ASTBinaryReader::readNodes(bool _allowNull)
+{
+	vector<ASTPointer<T>> nodes(readCount());
+	for (auto& node: nodes)
+		node = _allowNull ? readOptionalNode<T>() : readNode<T>();
+	return nodes;
+}
+
+template <class T>
+unique_ptr<vector<ASTPointer<T>>> ASTBinaryReader::readOptionalNodes()
+{
+	if (!readBool())
+		return nullptr;
+	return make_unique<vector<ASTPointer<T>>>(readNodes<T>());
+}
+
+template <class T, class... Args>
+ASTPointer<T> ASTBinaryReader::create(size_t _id, SourceLocation const& _location, Args&&... _args)
+{
+	ASTPointer<T> node = m_arena ?
+		ASTNode::createInArena<T>(*m_arena, _location, std::forward<Args>(_args)...) :
+		make_shared<T>(_location, std::forward<Args>(_args)...);
+	// The node got the next ID from the counter, move it to the encoded one.
+	ASTNode::shiftIDs({node.get()}, m_firstID + _id - node->id());
+	return node;
+}
+
+ASTPointer<ASTNode> ASTBinaryReader::readNode()
+{
+	auto type = readEnum(NodeType::Literal);
+	if (type == NodeType::Null)
+		return nullptr;
+	size_t id = readNumber();
+	if (id == 0 || id > m_idCount || !m_usedIDs.insert(id).second)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid node ID in AST encoding."));
+	SourceLocation location = readLocation();
+	auto invalidNode = []() {
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid node in AST encoding."));
+	};
+
+	switch (type)
+	{
+	case NodeType::SourceUnit:
+	{
+		auto nodes = readNodes<ASTNode>();
+		for (auto const& node: nodes)
+			if (
+				!dynamic_cast<PragmaDirective const*>(node.get()) &&
+				!dynamic_cast<ImportDirective const*>(node.get()) &&
+				!dynamic_cast<ContractDefinition const*>(node.get())
+			)
+				invalidNode();
+		return create<SourceUnit>(id, location, nodes);
+	}
+	case NodeType::PragmaDirective:
+	{
+		vector<Token> tokens(readCount());
+		for (Token& token: tokens)
+			token = readEnum(c_lastToken);
+		vector<ASTString> literals(readCount());
+		for (ASTString& literal: literals)
+			literal = readString();
+		return create<PragmaDirective>(id, location, tokens, literals);
+	}
+	case NodeType::ImportDirective:
+	{
+		auto path = readStringPointer();
+		auto unitAlias = readStringPointer();
+		ImportDirective::SymbolAliasList symbolAliases(readCount());
+		for (auto& symbolAlias: symbolAliases)
+		{
+			symbolAlias.symbol = readNode<Identifier>();
+			symbolAlias.alias = readOptionalString();
+			symbolAlias.location = readLocation();
+		}
+		return create<ImportDirective>(id, location, path, unitAlias, std::move(symbolAliases));
+	}
+	case NodeType::ContractDefinition:
+	{
+		auto name = readStringPointer();
+		auto documentation = readOptionalString();
+		auto baseContracts = readNodes<InheritanceSpecifier>();
+		auto subNodes = readNodes<ASTNode>();
+		for (auto const& node: subNodes)
+			if (
+				!dynamic_cast<FunctionDefinition const*>(node.get()) &&
+				!dynamic_cast<StructDefinition const*>(node.get()) &&
+				!dynamic_cast<EnumDefinition const*>(node.get()) &&
+				!dynamic_cast<VariableDeclaration const*>(node.get()) &&
+				!dynamic_cast<ModifierDefinition const*>(node.get()) &&
+				!dynamic_cast<EventDefinition const*>(node.get()) &&
+				!dynamic_cast<UsingForDirective const*>(node.get())
+			)
+				invalidNode();
+		auto contractKind = readEnum(ContractDefinition::ContractKind::Library);
+		bool abstract = readBool();
+		return create<ContractDefinition>(id, location, name, documentation, baseContracts, subNodes, contractKind, abstract);
+	}
+	case NodeType::InheritanceSpecifier:
+	{
+		auto baseName = readNode<UserDefinedTypeName>();
+		auto arguments = readOptionalNodes<Expression>();
+		return create<InheritanceSpecifier>(id, location, baseName, std::move(arguments));
+	}
+	case NodeType::UsingForDirective:
+	{
+		auto libraryName = readNode<UserDefinedTypeName>();
+		auto typeName = readOptionalNode<TypeName>();
+		return create<UsingForDirective>(id, location, libraryName, typeName);
+	}
+	case NodeType::StructDefinition:
+	{
+		auto name = readStringPointer();
+		auto members = readNodes<VariableDeclaration>();
+		return create<StructDefinition>(id, location, name, members);
+	}
+	case NodeType::EnumDefinition:
+	{
+		auto name = readStringPointer();
+		auto members = readNodes<EnumValue>();
+		return create<EnumDefinition>(id, location, name, members);
+	}
+	case NodeType::EnumValue:
+	{
+		auto name = readStringPointer();
+		return create<EnumValue>(id, location, name);
+	}
+	case NodeType::ParameterList:
+	{
+		auto parameters = readNodes<VariableDeclaration>();
+		return create<ParameterList>(id, location, parameters);
+	}
+	case NodeType::OverrideSpecifier:
+	{
+		auto overrides = readNodes<UserDefinedTypeName>();
+		return create<OverrideSpecifier>(id, location, overrides);
+	}
+	case NodeType::FunctionDefinition:
+	{
+		auto name = readStringPointer();
+		auto visibility = readEnum(Visibility::External);
+		auto stateMutability = readEnum(StateMutability::Payable);
+		auto kind = readEnum(c_lastToken);
+		if (kind != Token::Constructor && kind != Token::Function && kind != Token::Fallback && kind != Token::Receive)
+			invalidNode();
+		bool isVirtual = readBool();
+		auto overrides = readOptionalNode<OverrideSpecifier>();
+		auto documentation = readOptionalString();
+		auto parameters = readNode<ParameterList>();
+		auto modifiers = readNodes<ModifierInvocation>();
+		auto returnParameters = readOptionalNode<ParameterList>();
+		auto body = readOptionalNode<Block>();
+		return create<FunctionDefinition>(
+			id,
+			location,
+			name,
+			visibility,
+			stateMutability,
+			kind,
+			isVirtual,
+			overrides,
+			documentation,
+			parameters,
+			modifiers,
+			returnParameters,
+			body
+		);
+	}
+	case NodeType::VariableDeclaration:
+	{
+		auto typeName = readOptionalNode<TypeName>();
+		auto name = readStringPointer();
+		auto value = readOptionalNode<Expression>();
+		auto visibility = readEnum(Visibility::External);
+		bool isStateVariable = readBool();
+		bool isIndexed = readBool();
+		bool isConstant = readBool();
+		auto overrides = readOptionalNode<OverrideSpecifier>();
+		auto referenceLocation = readEnum(VariableDeclaration::Location::CallData);
+		return create<VariableDeclaration>(
+			id,
+			location,
+			typeName,
+			name,
+			value,
+			visibility,
+			isStateVariable,
+			isIndexed,
+			isConstant,
+			overrides,
+			referenceLocation
+		);
+	}
+	case NodeType::ModifierDefinition:
+	{
+		auto name = readStringPointer();
+		auto documentation = readOptionalString();
+		auto parameters = readNode<ParameterList>();
+		bool isVirtual = readBool();
+		auto overrides = readOptionalNode<OverrideSpecifier>();
+		auto body = readNode<Block>();
+		return create<ModifierDefinition>(id, location, name, documentation, parameters, isVirtual, overrides, body);
+	}
+	case NodeType::ModifierInvocation:
+	{
+		auto name = readNode<Identifier>();
+		auto arguments = readOptionalNodes<Expression>();
+		return create<ModifierInvocation>(id, location, name, std::move(arguments));
+	}
+	case NodeType::EventDefinition:
+	{
+		auto name = readStringPointer();
+		auto documentation = readOptionalString();
+		auto parameters = readNode<ParameterList>();
+		bool anonymous = readBool();
+		return create<EventDefinition>(id, location, name, documentation, parameters, anonymous);
+	}
+	case NodeType::ElementaryTypeName:
+	{
+		auto token = readEnum(c_lastToken);
+		uint64_t firstNumber = readNumber();
+		uint64_t secondNumber = readNumber();
+		if (firstNumber > 256 || secondNumber > 80 || !validElementaryTypeName(token, unsigned(firstNumber), unsigned(secondNumber)))
+			invalidNode();
+		optional<StateMutability> stateMutability;
+		if (readBool())
+		{
+			if (token != Token::Address)
+				invalidNode();
+			stateMutability = readEnum(StateMutability::Payable);
+		}
+		return create<ElementaryTypeName>(
+			id,
+			location,
+			ElementaryTypeNameToken(token, unsigned(firstNumber), unsigned(secondNumber)),
+			stateMutability
+		);
+	}
+	case NodeType::UserDefinedTypeName:
+	{
+		vector<ASTString> namePath(readCount());
+		for (ASTString& name: namePath)
+			name = readString();
+		return create<UserDefinedTypeName>(id, location, namePath);
+	}
+	case NodeType::FunctionTypeName:
+	{
+		auto parameterTypes = readNode<ParameterList>();
+		auto returnTypes = readNode<ParameterList>();
+		auto visibility = readEnum(Visibility::External);
+		auto stateMutability = readEnum(StateMutability::Payable);
+		return create<FunctionTypeName>(id, location, parameterTypes, returnTypes, visibility, stateMutability);
+	}
+	case NodeType::Mapping:
+	{
+		auto keyType = readNode<ElementaryTypeName>();
+		auto valueType = readNode<TypeName>();
+		return create<Mapping>(id, location, keyType, valueType);
+	}
+	case NodeType::ArrayTypeName:
+	{
+		auto baseType = readNode<TypeName>();
+		auto length = readOptionalNode<Expression>();
+		return create<ArrayTypeName>(id, location, baseType, length);
+	}
+	case NodeType::InlineAssembly:
+	{
+		auto documentation = readOptionalString();
+		int64_t blockStart = readSignedNumber();
+		if (blockStart < 0 || size_t(blockStart) >= m_scanner->source().size())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid inline assembly location."));
+		yul::Dialect const& dialect = yul::EVMDialect::strictAssemblyForEVM(m_evmVersion);
+		ErrorList errors;
+		ErrorReporter errorReporter(errors);
+		m_scanner->setPosition(size_t(blockStart));
+		shared_ptr<yul::Block> block = yul::Parser(errorReporter, dialect).parse(m_scanner, true);
+		if (!block || !Error::containsOnlyWarnings(errors))
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid inline assembly block."));
+		return create<InlineAssembly>(id, location, documentation, dialect, block);
+	}
+	case NodeType::Block:
+	{
+		auto documentation = readOptionalString();
+		auto statements = readNodes<Statement>();
+		return create<Block>(id, location, documentation, statements);
+	}
+	case NodeType::PlaceholderStatement:
+	{
+		auto documentation = readOptionalString();
+		return create<PlaceholderStatement>(id, location, documentation);
+	}
+	case NodeType::IfStatement:
+	{
+		auto documentation = readOptionalString();
+		auto condition = readNode<Expression>();
+		auto trueBody = readNode<Statement>();
+		auto falseBody = readOptionalNode<Statement>();
+		return create<IfStatement>(id, location, documentation, condition, trueBody, falseBody);
+	}
+	case NodeType::TryCatchClause:
+	{
+		auto errorName = readStringPointer();
+		auto parameters = readOptionalNode<ParameterList>();
+		auto block = readNode<Block>();
+		return create<TryCatchClause>(id, location, errorName, parameters, block);
+	}
+	case NodeType::TryStatement:
+	{
+		auto documentation = readOptionalString();
+		auto externalCall = readNode<Expression>();
+		auto clauses = readNodes<TryCatchClause>();
+		return create<TryStatement>(id, location, documentation, externalCall, clauses);
+	}
+	case NodeType::WhileStatement:
+	{
+		auto documentation = readOptionalString();
+		auto condition = readNode<Expression>();
+		auto body = readNode<Statement>();
+		bool isDoWhile = readBool();
+		return create<WhileStatement>(id, location, documentation, condition, body, isDoWhile);
+	}
+	case NodeType::ForStatement:
+	{
+		auto documentation = readOptionalString();
+		auto initExpression = readOptionalNode<Statement>();
+		auto condition = readOptionalNode<Expression>();
+		auto loopExpression = readOptionalNode<ExpressionStatement>();
+		auto body = readNode<Statement>();
+		return create<ForStatement>(id, location, documentation, initExpression, condition, loopExpression, body);
+	}
+	case NodeType::Continue:
+	{
+		auto documentation = readOptionalString();
+		return create<Continue>(id, location, documentation);
+	}
+	case NodeType::Break:
+	{
+		auto documentation = readOptionalString();
+		return create<Break>(id, location, documentation);
+	}
+	case NodeType::Return:
+	{
+		auto documentation = readOptionalString();
+		auto expression = readOptionalNode<Expression>();
+		return create<Return>(id, location, documentation, expression);
+	}
+	case NodeType::Throw:
+	{
+		auto documentation = readOptionalString();
+		return create<Throw>(id, location, documentation);
+	}
+	case NodeType::EmitStatement:
+	{
+		auto documentation = readOptionalString();
+		auto eventCall = readNode<FunctionCall>();
+		return create<EmitStatement>(id, location, documentation, eventCall);
+	}
+	case NodeType::VariableDeclarationStatement:
+	{
+		auto documentation = readOptionalString();
+		auto variables = readNodes<VariableDeclaration>(true);
+		auto initialValue = readOptionalNode<Expression>();
+		return create<VariableDeclarationStatement>(id, location, documentation, variables, initialValue);
+	}
+	case NodeType::ExpressionStatement:
+	{
+		auto documentation = readOptionalString();
+		auto expression = readNode<Expression>();
+		return create<ExpressionStatement>(id, location, documentation, expression);
+	}
+	case NodeType::Conditional:
+	{
+		auto condition = readNode<Expression>();
+		auto trueExpression = readNode<Expression>();
+		auto falseExpression = readNode<Expression>();
+		return create<Conditional>(id, location, condition, trueExpression, falseExpression);
+	}
+	case NodeType::Assignment:
+	{
+		auto leftHandSide = readNode<Expression>();
+		auto assignmentOperator = readEnum(c_lastToken);
+		if (!TokenTraits::isAssignmentOp(assignmentOperator))
+			invalidNode();
+		auto rightHandSide = readNode<Expression>();
+		return create<Assignment>(id, location, leftHandSide, assignmentOperator, rightHandSide);
+	}
+	case NodeType::TupleExpression:
+	{
+		auto components = readNodes<Expression>(true);
+		bool isArray = readBool();
+		return create<TupleExpression>(id, location, components, isArray);
+	}
+	case NodeType::UnaryOperation:
+	{
+		auto unaryOperator = readEnum(c_lastToken);
+		if (!TokenTraits::isUnaryOp(unaryOperator))
+			invalidNode();
+		auto subExpression = readNode<Expression>();
+		bool isPrefix = readBool();
+		return create<UnaryOperation>(id, location, unaryOperator, subExpression, isPrefix);
+	}
+	case NodeType::BinaryOperation:
+	{
+		auto left = readNode<Expression>();
+		auto binaryOperator = readEnum(c_lastToken);
+		if (!TokenTraits::isBinaryOp(binaryOperator) && !TokenTraits::isCompareOp(binaryOperator))
+			invalidNode();
+		auto right = readNode<Expression>();
+		return create<BinaryOperation>(id, location, left, binaryOperator, right);
+	}
+	case NodeType::FunctionCall:
+	{
+		auto expression = readNode<Expression>();
+		auto arguments = readNodes<Expression>();
+		vector<ASTPointer<ASTString>> names(readCount());
+		for (auto& name: names)
+			name = readStringPointer();
+		return create<FunctionCall>(id, location, expression, arguments, names);
+	}
+	case NodeType::NewExpression:
+	{
+		auto typeName = readNode<TypeName>();
+		return create<NewExpression>(id, location, typeName);
+	}
+	case NodeType::MemberAccess:
+	{
+		auto expression = readNode<Expression>();
+		auto memberName = readStringPointer();
+		return create<MemberAccess>(id, location, expression, memberName);
+	}
+	case NodeType::IndexAccess:
+	{
+		auto base = readNode<Expression>();
+		auto index = readOptionalNode<Expression>();
+		return create<IndexAccess>(id, location, base, index);
+	}
+	case NodeType::IndexRangeAccess:
+	{
+		auto base = readNode<Expression>();
+		auto start = readOptionalNode<Expression>();
+		auto end = readOptionalNode<Expression>();
+		return create<IndexRangeAccess>(id, location, base, start, end);
+	}
+	case NodeType::Identifier:
+	{
+		auto name = readStringPointer();
+		return create<Identifier>(id, location, name);
+	}
+	case NodeType::ElementaryTypeNameExpression:
+	{
+		auto elementaryType = readNode<ElementaryTypeName>();
+		return create<ElementaryTypeNameExpression>(id, location, elementaryType);
+	}
+	case NodeType::Literal:
+	{
+		auto token = readEnum(c_lastToken);
+		auto value = readStringPointer();
+		auto subDenominationToken = readEnum(c_lastToken);
+		if (
+			token != Token::TrueLiteral && token != Token::FalseLiteral && token != Token::Number &&
+			token != Token::StringLiteral && token != Token::HexStringLiteral
+		)
+			invalidNode();
+		if (subDenominationToken != Token::Illegal && !(
+			token == Token::Number && (
+				TokenTraits::isEtherSubdenomination(subDenominationToken) ||
+				TokenTraits::isTimeSubdenomination(subDenominationToken)
+			)
+		))
+			invalidNode();
+		auto subDenomination = static_cast<Literal::SubDenomination>(subDenominationToken);
+		return create<Literal>(id, location, token, value, subDenomination);
+	}
+	default:
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Unknown node type."));
+	}
+}
+
+uint64_t ASTBinaryReader::readNumber()
+{
+	uint64_t value = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7)
+	{
+		if (m_position >= m_data.size())
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Truncated AST encoding."));
+		uint8_t byte = uint8_t(m_data[m_position++]);
+		value |= uint64_t(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid number in AST encoding."));
+}
+
+int64_t ASTBinaryReader::readSignedNumber()
+{
+	uint64_t value = readNumber();
+	return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+bigint ASTBinaryReader::readInteger(size_t _maxBytes)
+{
+	bool negative = readBool();
+	string const magnitude = readString();
+	if (magnitude.size() > _maxBytes)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid integer in AST encoding."));
+	bigint value = fromBigEndian<bigint>(magnitude);
+	return negative ? bigint(-value) : value;
+}
+
+size_t ASTBinaryReader::readCount()
+{
+	uint64_t count = readNumber();
+	if (count > m_data.size() - m_position)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Truncated AST encoding."));
+	return size_t(count);
+}
+
+bool ASTBinaryReader::readBool()
+{
+	uint64_t value = readNumber();
+	if (value > 1)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid boolean in AST encoding."));
+	return value == 1;
+}
+
+string ASTBinaryReader::readString()
+{
+	uint64_t size = readNumber();
+	if (size > m_data.size() - m_position)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Truncated AST encoding."));
+	string value = m_data.substr(m_position, size);
+	m_position += size;
+	return value;
+}
+
+ASTPointer<ASTString> ASTBinaryReader::readOptionalString()
+{
+	if (!readBool())
+		return nullptr;
+	return readStringPointer();
+}
+
+SourceLocation ASTBinaryReader::readLocation()
+{
+	bool hasSource = readBool();
+	int64_t start = readSignedNumber();
+	int64_t end = readSignedNumber();
+	int64_t sourceSize = int64_t(m_scanner->source().size());
+	if (
+		start < -1 || start > sourceSize ||
+		end < -1 || end > sourceSize ||
+		(start >= 0 && end >= 0 && start > end)
+	)
+		BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid source location in AST encoding."));
+	return SourceLocation{int(start), int(end), hasSource ? CharStreamReference(m_scanner->charStream()) : CharStreamReference()};
+}
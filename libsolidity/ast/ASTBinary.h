@@ -0,0 +1,305 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Compact binary encoding of the AST of a source unit.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTArena.h>
+#include <libsolidity/ast/ASTVisitor.h>
+
+#include <liblangutil/EVMVersion.h>
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/FixedHash.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace langutil
+{
+class Scanner;
+struct SourceLocation;
+}
+
+namespace dev
+{
+namespace solidity
+{
+
+class GlobalContext;
+class Type;
+
+DEV_SIMPLE_EXCEPTION(ASTBinaryError);
+
+/**
+ * The sources and settings the annotations of an encoded source unit refer to.
+ */
+struct ASTBinaryContext
+{
+	struct Source
+	{
+		SourceUnit const* ast = nullptr;
+		h256 keccak256;
+	};
+
+	langutil::EVMVersion evmVersion;
+	/// The parsed sources by their names.
+	std::map<std::string, Source> sources;
+	/// Provides the magic variables like "msg" and "this" that identifiers can refer to.
+	GlobalContext* globalContext = nullptr;
+};
+
+/**
+ * Encodes a source unit together with its source, such that ASTBinaryReader can recreate it
+ * without parsing. The encoding is only valid for the compiler version that produced it.
+ * The annotations of an analysed source unit can be included, such that the recreated AST does
+ * not have to be analysed again as long as the sources it imports do not change.
+ */
+class ASTBinaryWriter: private ASTConstVisitor
+{
+public:
+	/// @returns the encoding of @a _sourceUnit, which was parsed from @a _source named @a _sourceName.
+	/// If @a _context is given, @a _sourceUnit was analysed without errors in that context and
+	/// its annotations are encoded as well, apart from the doc tags and those set when
+	/// declarations are registered.
+	static std::string write(
+		SourceUnit const& _sourceUnit,
+		std::string const& _sourceName,
+		std::string_view _source,
+		ASTBinaryContext const* _context = nullptr
+	);
+
+private:
+	ASTBinaryWriter() = default;
+
+	/// @returns the encoding of the annotations of @a _sourceUnit named @a _sourceName.
+	static std::string writeAnnotations(
+		SourceUnit const& _sourceUnit,
+		std::string const& _sourceName,
+		ASTBinaryContext const& _context
+	);
+	void writeAnnotation(ASTNode const& _node);
+	/// Writes a reference to a node of the source unit or of a source it imports, or to a magic variable.
+	void writeReference(ASTNode const* _node);
+	template <class T>
+	void writeReferences(std::vector<T const*> const& _nodes);
+	/// Writes references to all nodes in @a _nodes in the order of their position in the sources.
+	template <class T>
+	void writeReferences(std::set<T const*> const& _nodes);
+	void writeType(Type const* _type);
+	void writeTypes(std::vector<Type const*> const& _types);
+
+	void writeNode(ASTNode const* _node);
+	template <class T>
+	void writeNodes(std::vector<ASTPointer<T>> const& _nodes)
+	{
+		writeNumber(_nodes.size());
+		for (auto const& node: _nodes)
+			writeNode(node.get());
+	}
+	void writeHeader(ASTNode const& _node, uint8_t _type);
+	void writeNumber(uint64_t _value);
+	void writeSignedNumber(int64_t _value);
+	/// Writes the sign and the big endian bytes of @a _value.
+	void writeInteger(bigint const& _value);
+	void writeBool(bool _value) { m_data.push_back(char(_value)); }
+	void writeString(std::string_view _value);
+	void writeOptionalString(ASTPointer<ASTString> const& _value);
+	void writeLocation(langutil::SourceLocation const& _location);
+
+	bool visit(SourceUnit const& _node) override;
+	bool visit(PragmaDirective const& _node) override;
+	bool visit(ImportDirective const& _node) override;
+	bool visit(ContractDefinition const& _node) override;
+	bool visit(InheritanceSpecifier const& _node) override;
+	bool visit(UsingForDirective const& _node) override;
+	bool visit(StructDefinition const& _node) override;
+	bool visit(EnumDefinition const& _node) override;
+	bool visit(EnumValue const& _node) override;
+	bool visit(ParameterList const& _node) override;
+	bool visit(OverrideSpecifier const& _node) override;
+	bool visit(FunctionDefinition const& _node) override;
+	bool visit(VariableDeclaration const& _node) override;
+	bool visit(ModifierDefinition const& _node) override;
+	bool visit(ModifierInvocation const& _node) override;
+	bool visit(EventDefinition const& _node) override;
+	bool visit(ElementaryTypeName const& _node) override;
+	bool visit(UserDefinedTypeName const& _node) override;
+	bool visit(FunctionTypeName const& _node) override;
+	bool visit(Mapping const& _node) override;
+	bool visit(ArrayTypeName const& _node) override;
+	bool visit(InlineAssembly const& _node) override;
+	bool visit(Block const& _node) override;
+	bool visit(PlaceholderStatement const& _node) override;
+	bool visit(IfStatement const& _node) override;
+	bool visit(TryCatchClause const& _node) override;
+	bool visit(TryStatement const& _node) override;
+	bool visit(WhileStatement const& _node) override;
+	bool visit(ForStatement const& _node) override;
+	bool visit(Continue const& _node) override;
+	bool visit(Break const& _node) override;
+	bool visit(Return const& _node) override;
+	bool visit(Throw const& _node) override;
+	bool visit(EmitStatement const& _node) override;
+	bool visit(VariableDeclarationStatement const& _node) override;
+	bool visit(ExpressionStatement const& _node) override;
+	bool visit(Conditional const& _node) override;
+	bool visit(Assignment const& _node) override;
+	bool visit(TupleExpression const& _node) override;
+	bool visit(UnaryOperation const& _node) override;
+	bool visit(BinaryOperation const& _node) override;
+	bool visit(FunctionCall const& _node) override;
+	bool visit(NewExpression const& _node) override;
+	bool visit(MemberAccess const& _node) override;
+	bool visit(IndexAccess const& _node) override;
+	bool visit(IndexRangeAccess const& _node) override;
+	bool visit(Identifier const& _node) override;
+	bool visit(ElementaryTypeNameExpression const& _node) override;
+	bool visit(Literal const& _node) override;
+
+	/// The ID the encoded IDs are relative to.
+	size_t m_firstID = 0;
+	ASTBinaryContext const* m_context = nullptr;
+	/// The index of the source and the position in its AST of each node annotations can refer to.
+	std::unordered_map<ASTNode const*, std::pair<size_t, size_t>> m_nodeIndices;
+	std::string m_data;
+};
+
+/**
+ * Recreates a source unit from the output of ASTBinaryWriter. The nodes get the IDs a parser
+ * started at the current ID counter would have assigned to them.
+ * All functions throw ASTBinaryError if the data is malformed or was produced by a
+ * different compiler version. The annotations are trusted to be those the analysis computed,
+ * only their form is checked.
+ */
+class ASTBinaryReader
+{
+public:
+	/// @returns the name of the source encoded in @a _data.
+	static std::string sourceName(std::string const& _data);
+	/// @returns the content of the source encoded in @a _data.
+	static std::string sourceContent(std::string const& _data);
+
+	/// @returns the source unit encoded in @a _data. Its source locations refer to the source
+	/// of @a _scanner, which has to be the one returned by sourceContent.
+	/// The nodes are allocated from @a _arena, if given, which has to outlive them.
+	static ASTPointer<SourceUnit> read(
+		std::string const& _data,
+		std::shared_ptr<langutil::Scanner> const& _scanner,
+		langutil::EVMVersion _evmVersion,
+		ASTArena* _arena = nullptr
+	);
+
+	/// Restores the annotations encoded in @a _data to @a _sourceUnit, which was recreated from it
+	/// and is part of @a _context. The declarations still have to be registered.
+	/// @returns false without changing any annotation if none are encoded or if they were computed
+	/// for different imported sources or settings, then @a _sourceUnit has to be analysed.
+	static bool readAnnotations(std::string const& _data, SourceUnit const& _sourceUnit, ASTBinaryContext const& _context);
+
+private:
+	ASTBinaryReader(
+		std::string const& _data,
+		std::shared_ptr<langutil::Scanner> _scanner,
+		langutil::EVMVersion _evmVersion,
+		ASTArena* _arena
+	);
+
+	/// Reads the header and @returns the name and content of the source.
+	std::pair<std::string, std::string> readSource();
+
+	/// @returns false if the annotations were computed for different imported sources or settings.
+	bool readDependencies(SourceUnit const& _sourceUnit, std::string const& _sourceName);
+	/// @returns the nodes of the source unit with index @a _sourceIndex in m_sourceUnits in the order they are visited.
+	std::vector<ASTNode const*> const& sourceNodes(size_t _sourceIndex);
+	void readAnnotation(ASTNode const& _node);
+	/// Restores the external references of @a _inlineAssembly and analyses it again.
+	void readAssemblyAnnotation(InlineAssembly const& _inlineAssembly);
+	ASTNode const* readReference();
+	template <class T>
+	T const* readReference();
+	template <class T>
+	std::vector<T const*> readReferences();
+	Type const* readType();
+	std::vector<Type const*> readTypes(bool _allowNull = false);
+
+	ASTPointer<ASTNode> readNode();
+	/// Reads a node that has to be present.
+	template <class T>
+	ASTPointer<T> readNode();
+	template <class T>
+	ASTPointer<T> readOptionalNode();
+	template <class T>
+	std::vector<ASTPointer<T>> readNodes(bool _allowNull = false);
+	template <class T>
+	std::unique_ptr<std::vector<ASTPointer<T>>> readOptionalNodes();
+	/// Creates a node from @a _args and gives it the ID @a _id relative to the first ID.
+	template <class T, class... Args>
+	ASTPointer<T> create(size_t _id, langutil::SourceLocation const& _location, Args&&... _args);
+
+	uint64_t readNumber();
+	int64_t readSignedNumber();
+	/// Reads an integer of at most @a _maxBytes bytes written by ASTBinaryWriter::writeInteger.
+	bigint readInteger(size_t _maxBytes);
+	/// Reads the number of elements of a list, each of which is encoded in at least one byte.
+	size_t readCount();
+	bool readBool();
+	std::string readString();
+	ASTPointer<ASTString> readStringPointer() { return std::make_shared<ASTString>(readString()); }
+	ASTPointer<ASTString> readOptionalString();
+	langutil::SourceLocation readLocation();
+	/// Reads an enum value, which must not be larger than @a _max.
+	template <class E>
+	E readEnum(E _max)
+	{
+		uint64_t value = readNumber();
+		if (value > uint64_t(_max))
+			BOOST_THROW_EXCEPTION(ASTBinaryError() << errinfo_comment("Invalid enum value in AST encoding."));
+		return static_cast<E>(value);
+	}
+
+	std::string const& m_data;
+	size_t m_position = 0;
+	std::shared_ptr<langutil::Scanner> m_scanner;
+	langutil::EVMVersion m_evmVersion;
+	ASTArena* m_arena = nullptr;
+	/// The ID the encoded IDs are relative to.
+	size_t m_firstID = 0;
+	/// The number of IDs the encoded nodes span.
+	size_t m_idCount = 0;
+	/// The encoded IDs of the nodes read so far.
+	std::set<size_t> m_usedIDs;
+
+	ASTBinaryContext const* m_context = nullptr;
+	/// The source units annotations can refer to, the first one is the one being read.
+	std::vector<SourceUnit const*> m_sourceUnits;
+	/// The nodes of each of m_sourceUnits in the order they are visited, computed on first use.
+	std::vector<std::optional<std::vector<ASTNode const*>>> m_nodes;
+	/// The magic variables of the global context, computed on first use.
+	std::optional<std::vector<Declaration const*>> m_magicVariables;
+};
+
+}
+}
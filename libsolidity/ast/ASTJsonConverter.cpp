@@ -130,10 +130,10 @@ void ASTJsonConverter::setJsonNode(
 
 size_t ASTJsonConverter::sourceIndexFromLocation(SourceLocation const& _location) const
 {
-	if (_location.source && m_sourceIndices.count(_location.source->name()))
-		return m_sourceIndices.at(_location.source->name());
-	else
-		return size_t(-1);
+	if (CharStream const* source = _location.source.get())
+		if (m_sourceIndices.count(source->name()))
+			return m_sourceIndices.at(source->name());
+	return size_t(-1);
 }
 
 string ASTJsonConverter::sourceLocationToString(SourceLocation const& _location) const
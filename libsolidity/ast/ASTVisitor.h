@@ -23,6 +23,7 @@
 #pragma once
 
 #include <libsolidity/ast/AST.h>
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <vector>
@@ -328,5 +329,136 @@ private:
 	std::function<void(ASTNode const&, ASTNode const&)> m_onEdge;
 };
 
+/**
+ * Visitor that runs several visitors in a single traversal of the AST.
+ * For each node, the visitors are called in the order they were given. Every visitor sees the
+ * same calls as if it traversed the AST on its own, i.e. if it does not descend into a node,
+ * it is not called for the children of that node.
+ * If @a _activeVisitors is given, it is queried before each call and returns how many of the
+ * visitors, counted from the first one, are still called. Visitors that were stopped this way
+ * are not called again, not even to end the visits of the current nodes.
+ */
+class CompositeASTConstVisitor: public ASTConstVisitor
+{
+public:
+	explicit CompositeASTConstVisitor(
+		std::vector<ASTConstVisitor*> const& _visitors,
+		std::function<size_t()> _activeVisitors = {}
+	):
+		m_activeVisitors(std::move(_activeVisitors))
+	{
+		for (ASTConstVisitor* visitor: _visitors)
+			m_visitors.push_back({visitor, 0});
+		m_active = m_visitors.size();
+	}
+
+#define SOLIDITY_FORWARD_VISIT(NodeType) \
+	bool visit(NodeType const& _node) override { return forwardVisit(_node); } \
+	void endVisit(NodeType const& _node) override { forwardEndVisit(_node); }
+	SOLIDITY_FORWARD_VISIT(SourceUnit)
+	SOLIDITY_FORWARD_VISIT(PragmaDirective)
+	SOLIDITY_FORWARD_VISIT(ImportDirective)
+	SOLIDITY_FORWARD_VISIT(ContractDefinition)
+	SOLIDITY_FORWARD_VISIT(InheritanceSpecifier)
+	SOLIDITY_FORWARD_VISIT(StructDefinition)
+	SOLIDITY_FORWARD_VISIT(UsingForDirective)
+	SOLIDITY_FORWARD_VISIT(EnumDefinition)
+	SOLIDITY_FORWARD_VISIT(EnumValue)
+	SOLIDITY_FORWARD_VISIT(ParameterList)
+	SOLIDITY_FORWARD_VISIT(OverrideSpecifier)
+	SOLIDITY_FORWARD_VISIT(FunctionDefinition)
+	SOLIDITY_FORWARD_VISIT(VariableDeclaration)
+	SOLIDITY_FORWARD_VISIT(ModifierDefinition)
+	SOLIDITY_FORWARD_VISIT(ModifierInvocation)
+	SOLIDITY_FORWARD_VISIT(EventDefinition)
+	SOLIDITY_FORWARD_VISIT(ElementaryTypeName)
+	SOLIDITY_FORWARD_VISIT(UserDefinedTypeName)
+	SOLIDITY_FORWARD_VISIT(FunctionTypeName)
+	SOLIDITY_FORWARD_VISIT(Mapping)
+	SOLIDITY_FORWARD_VISIT(ArrayTypeName)
+	SOLIDITY_FORWARD_VISIT(Block)
+	SOLIDITY_FORWARD_VISIT(PlaceholderStatement)
+	SOLIDITY_FORWARD_VISIT(IfStatement)
+	SOLIDITY_FORWARD_VISIT(TryCatchClause)
+	SOLIDITY_FORWARD_VISIT(TryStatement)
+	SOLIDITY_FORWARD_VISIT(WhileStatement)
+	SOLIDITY_FORWARD_VISIT(ForStatement)
+	SOLIDITY_FORWARD_VISIT(Continue)
+	SOLIDITY_FORWARD_VISIT(InlineAssembly)
+	SOLIDITY_FORWARD_VISIT(Break)
+	SOLIDITY_FORWARD_VISIT(Return)
+	SOLIDITY_FORWARD_VISIT(Throw)
+	SOLIDITY_FORWARD_VISIT(EmitStatement)
+	SOLIDITY_FORWARD_VISIT(VariableDeclarationStatement)
+	SOLIDITY_FORWARD_VISIT(ExpressionStatement)
+	SOLIDITY_FORWARD_VISIT(Conditional)
+	SOLIDITY_FORWARD_VISIT(Assignment)
+	SOLIDITY_FORWARD_VISIT(TupleExpression)
+	SOLIDITY_FORWARD_VISIT(UnaryOperation)
+	SOLIDITY_FORWARD_VISIT(BinaryOperation)
+	SOLIDITY_FORWARD_VISIT(FunctionCall)
+	SOLIDITY_FORWARD_VISIT(NewExpression)
+	SOLIDITY_FORWARD_VISIT(MemberAccess)
+	SOLIDITY_FORWARD_VISIT(IndexAccess)
+	SOLIDITY_FORWARD_VISIT(IndexRangeAccess)
+	SOLIDITY_FORWARD_VISIT(Identifier)
+	SOLIDITY_FORWARD_VISIT(ElementaryTypeNameExpression)
+	SOLIDITY_FORWARD_VISIT(Literal)
+#undef SOLIDITY_FORWARD_VISIT
+
+private:
+	struct Entry
+	{
+		ASTConstVisitor* visitor;
+		/// Depth of the node whose children the visitor skips, zero if it is not skipping.
+		size_t skippedAt;
+	};
+
+	template <class NodeType>
+	bool forwardVisit(NodeType const& _node)
+	{
+		m_depth++;
+		bool descend = false;
+		for (size_t i = 0; i < activeVisitors(); ++i)
+		{
+			Entry& entry = m_visitors[i];
+			if (entry.skippedAt == 0)
+			{
+				if (entry.visitor->visit(_node))
+					descend = true;
+				else
+					entry.skippedAt = m_depth;
+			}
+		}
+		return descend;
+	}
+	template <class NodeType>
+	void forwardEndVisit(NodeType const& _node)
+	{
+		for (size_t i = 0; i < activeVisitors(); ++i)
+		{
+			Entry& entry = m_visitors[i];
+			if (entry.skippedAt == 0 || entry.skippedAt == m_depth)
+			{
+				entry.skippedAt = 0;
+				entry.visitor->endVisit(_node);
+			}
+		}
+		m_depth--;
+	}
+	size_t activeVisitors()
+	{
+		if (m_activeVisitors)
+			m_active = std::min(m_active, m_activeVisitors());
+		return m_active;
+	}
+
+	std::vector<Entry> m_visitors;
+	std::function<size_t()> m_activeVisitors;
+	/// Number of visitors, counted from the first one, that are still called.
+	size_t m_active = 0;
+	size_t m_depth = 0;
+};
+
 }
 }
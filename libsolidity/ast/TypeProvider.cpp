@@ -20,137 +20,137 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <algorithm>
+#include <mutex>
+#include <typeinfo>
+
 using namespace std;
 using namespace dev;
 using namespace solidity;
 
-BoolType const TypeProvider::m_boolean{};
-InaccessibleDynamicType const TypeProvider::m_inaccessibleDynamic{};
-
-/// The string and bytes unique_ptrs are initialized when they are first used because
-/// they rely on `byte` being available which we cannot guarantee in the static init context.
-unique_ptr<ArrayType> TypeProvider::m_bytesStorage;
-unique_ptr<ArrayType> TypeProvider::m_bytesMemory;
-unique_ptr<ArrayType> TypeProvider::m_bytesCalldata;
-unique_ptr<ArrayType> TypeProvider::m_stringStorage;
-unique_ptr<ArrayType> TypeProvider::m_stringMemory;
-
-TupleType const TypeProvider::m_emptyTuple{};
-AddressType const TypeProvider::m_payableAddress{StateMutability::Payable};
-AddressType const TypeProvider::m_address{StateMutability::NonPayable};
-
-array<unique_ptr<IntegerType>, 32> const TypeProvider::m_intM{{
-	{make_unique<IntegerType>(8 * 1, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 2, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 3, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 4, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 5, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 6, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 7, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 8, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 9, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 10, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 11, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 12, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 13, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 14, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 15, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 16, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 17, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 18, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 19, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 20, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 21, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 22, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 23, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 24, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 25, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 26, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 27, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 28, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 29, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 30, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 31, IntegerType::Modifier::Signed)},
-	{make_unique<IntegerType>(8 * 32, IntegerType::Modifier::Signed)}
-}};
-
-array<unique_ptr<IntegerType>, 32> const TypeProvider::m_uintM{{
-	{make_unique<IntegerType>(8 * 1, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 2, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 3, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 4, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 5, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 6, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 7, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 8, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 9, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 10, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 11, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 12, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 13, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 14, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 15, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 16, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 17, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 18, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 19, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 20, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 21, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 22, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 23, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 24, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 25, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 26, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 27, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 28, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 29, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 30, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 31, IntegerType::Modifier::Unsigned)},
-	{make_unique<IntegerType>(8 * 32, IntegerType::Modifier::Unsigned)}
-}};
-
-array<unique_ptr<FixedBytesType>, 32> const TypeProvider::m_bytesM{{
-	{make_unique<FixedBytesType>(1)},
-	{make_unique<FixedBytesType>(2)},
-	{make_unique<FixedBytesType>(3)},
-	{make_unique<FixedBytesType>(4)},
-	{make_unique<FixedBytesType>(5)},
-	{make_unique<FixedBytesType>(6)},
-	{make_unique<FixedBytesType>(7)},
-	{make_unique<FixedBytesType>(8)},
-	{make_unique<FixedBytesType>(9)},
-	{make_unique<FixedBytesType>(10)},
-	{make_unique<FixedBytesType>(11)},
-	{make_unique<FixedBytesType>(12)},
-	{make_unique<FixedBytesType>(13)},
-	{make_unique<FixedBytesType>(14)},
-	{make_unique<FixedBytesType>(15)},
-	{make_unique<FixedBytesType>(16)},
-	{make_unique<FixedBytesType>(17)},
-	{make_unique<FixedBytesType>(18)},
-	{make_unique<FixedBytesType>(19)},
-	{make_unique<FixedBytesType>(20)},
-	{make_unique<FixedBytesType>(21)},
-	{make_unique<FixedBytesType>(22)},
-	{make_unique<FixedBytesType>(23)},
-	{make_unique<FixedBytesType>(24)},
-	{make_unique<FixedBytesType>(25)},
-	{make_unique<FixedBytesType>(26)},
-	{make_unique<FixedBytesType>(27)},
-	{make_unique<FixedBytesType>(28)},
-	{make_unique<FixedBytesType>(29)},
-	{make_unique<FixedBytesType>(30)},
-	{make_unique<FixedBytesType>(31)},
-	{make_unique<FixedBytesType>(32)}
-}};
-
-array<unique_ptr<MagicType>, 4> const TypeProvider::m_magics{{
-	{make_unique<MagicType>(MagicType::Kind::Block)},
-	{make_unique<MagicType>(MagicType::Kind::Message)},
-	{make_unique<MagicType>(MagicType::Kind::Transaction)},
-	{make_unique<MagicType>(MagicType::Kind::ABI)}
+namespace
+{
+/// @returns the types @a _type is composed of.
+TypePointers componentTypes(Type const& _type)
+{
+	switch (_type.category())
+	{
+	case Type::Category::Array:
+		return {dynamic_cast<ArrayType const&>(_type).baseType()};
+	case Type::Category::Mapping:
+	{
+		auto const& mapping = dynamic_cast<MappingType const&>(_type);
+		return {mapping.keyType(), mapping.valueType()};
+	}
+	case Type::Category::Tuple:
+		return dynamic_cast<TupleType const&>(_type).components();
+	case Type::Category::Function:
+	{
+		auto const& function = dynamic_cast<FunctionType const&>(_type);
+		TypePointers components = function.parameterTypes() + function.returnParameterTypes();
+		if (function.bound())
+			components.push_back(function.selfType());
+		return components;
+	}
+	case Type::Category::Modifier:
+		return dynamic_cast<ModifierType const&>(_type).parameterTypes();
+	case Type::Category::TypeType:
+		return {dynamic_cast<TypeType const&>(_type).actualType()};
+	case Type::Category::Magic:
+	{
+		auto const& magic = dynamic_cast<MagicType const&>(_type);
+		if (magic.kind() == MagicType::Kind::MetaType)
+			return {magic.typeArgument()};
+		return {};
+	}
+	default:
+		return {};
+	}
+}
+
+/// @returns true if @a _type refers to any of the AST nodes in @a _nodes, directly or
+/// through the types it is composed of.
+bool refersTo(Type const& _type, set<ASTNode const*> const& _nodes)
+{
+	ASTNode const* node = nullptr;
+	if (auto contract = dynamic_cast<ContractType const*>(&_type))
+		node = &contract->contractDefinition();
+	else if (auto structType = dynamic_cast<StructType const*>(&_type))
+		node = &structType->structDefinition();
+	else if (auto enumType = dynamic_cast<EnumType const*>(&_type))
+		node = &enumType->enumDefinition();
+	else if (auto module = dynamic_cast<ModuleType const*>(&_type))
+		node = &module->sourceUnit();
+	else if (auto function = dynamic_cast<FunctionType const*>(&_type))
+		if (function->hasDeclaration())
+			node = &function->declaration();
+	if (node && _nodes.count(node))
+		return true;
+	for (Type const* component: componentTypes(_type))
+		if (component && refersTo(*component, _nodes))
+			return true;
+	return false;
+}
+
+/// @returns true if @a _type is a rational number type or is composed of one at any depth.
+bool containsRationalNumber(Type const& _type)
+{
+	if (_type.category() == Type::Category::RationalNumber)
+		return true;
+	for (Type const* component: componentTypes(_type))
+		if (component && containsRationalNumber(*component))
+			return true;
+	return false;
+}
+
+/// @returns a string that is equal for two types if and only if they cannot be distinguished,
+/// or an empty string if the type should not be shared.
+string identity(Type const& _type)
+{
+	// Rational numbers with different compatible bytes types have the same identifier,
+	// and so do types composed of them, e.g. the type of the tuple (0x12, 1).
+	if (containsRationalNumber(_type))
+		return {};
+
+	string id = _type.richIdentifier();
+	if (auto function = dynamic_cast<FunctionType const*>(&_type))
+	{
+		// The identifier of function types does not cover the names and the declaration.
+		id += "_names(" + boost::algorithm::join(function->parameterNames(), ",") + ")";
+		id += "(" + boost::algorithm::join(function->returnParameterNames(), ",") + ")";
+		if (function->takesArbitraryParameters())
+			id += "_arbitrary";
+		if (function->hasDeclaration())
+			id += "_declaration" + to_string(function->declaration().id());
+	}
+	return id;
+}
+}
+
+thread_local TypeProvider* TypeProvider::s_current = nullptr;
+
+TypeProvider::TypeProvider()
+{
+	for (unsigned i = 0; i < 32; ++i)
+	{
+		m_intM[i] = make_unique<IntegerType>(8 * (i + 1), IntegerType::Modifier::Signed);
+		m_uintM[i] = make_unique<IntegerType>(8 * (i + 1), IntegerType::Modifier::Unsigned);
+		m_bytesM[i] = make_unique<FixedBytesType>(i + 1);
+	}
 	// MetaType is stored separately
-}};
+	m_magics = {{
+		make_unique<MagicType>(MagicType::Kind::Block),
+		make_unique<MagicType>(MagicType::Kind::Message),
+		make_unique<MagicType>(MagicType::Kind::Transaction),
+		make_unique<MagicType>(MagicType::Kind::ABI)
+	}};
+}
+
+TypeProvider& TypeProvider::threadInstance()
+{
+	static thread_local TypeProvider provider;
+	return provider;
+}
 
 inline void clearCache(Type const& type)
 {
@@ -174,32 +174,111 @@ inline void clearCaches(Container& container)
 
 void TypeProvider::reset()
 {
-	clearCache(m_boolean);
-	clearCache(m_inaccessibleDynamic);
-	clearCache(m_bytesStorage);
-	clearCache(m_bytesMemory);
-	clearCache(m_bytesCalldata);
-	clearCache(m_stringStorage);
-	clearCache(m_stringMemory);
-	clearCache(m_emptyTuple);
-	clearCache(m_payableAddress);
-	clearCache(m_address);
-	clearCaches(instance().m_intM);
-	clearCaches(instance().m_uintM);
-	clearCaches(instance().m_bytesM);
-	clearCaches(instance().m_magics);
-
-	instance().m_generalTypes.clear();
-	instance().m_stringLiteralTypes.clear();
-	instance().m_ufixedMxN.clear();
-	instance().m_fixedMxN.clear();
+	invalidateCaches();
+
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	provider.m_generalTypes.clear();
+	provider.m_sharedTypes.clear();
+	provider.m_stringLiteralTypes.clear();
+	provider.m_ufixedMxN.clear();
+	provider.m_fixedMxN.clear();
+}
+
+void TypeProvider::invalidateCaches()
+{
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	clearCache(provider.m_boolean);
+	clearCache(provider.m_inaccessibleDynamic);
+	clearCache(provider.m_bytesStorage);
+	clearCache(provider.m_bytesMemory);
+	clearCache(provider.m_bytesCalldata);
+	clearCache(provider.m_stringStorage);
+	clearCache(provider.m_stringMemory);
+	clearCache(provider.m_emptyTuple);
+	clearCache(provider.m_payableAddress);
+	clearCache(provider.m_address);
+	clearCaches(provider.m_intM);
+	clearCaches(provider.m_uintM);
+	clearCaches(provider.m_bytesM);
+	clearCaches(provider.m_magics);
+	clearCaches(provider.m_generalTypes);
+	for (auto const& type: provider.m_stringLiteralTypes)
+		clearCache(type.second);
+	for (auto const& type: provider.m_ufixedMxN)
+		clearCache(type.second);
+	for (auto const& type: provider.m_fixedMxN)
+		clearCache(type.second);
+}
+
+void TypeProvider::removeTypesReferringTo(set<ASTNode const*> const& _nodes)
+{
+	// Afterwards, the member lists of the remaining types do not refer to the removed types.
+	invalidateCaches();
+
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	set<Type const*> removed;
+	for (auto const& type: provider.m_generalTypes)
+		if (refersTo(*type, _nodes))
+			removed.insert(type.get());
+	if (removed.empty())
+		return;
+	auto& sharedTypes = provider.m_sharedTypes;
+	for (auto it = sharedTypes.begin(); it != sharedTypes.end();)
+		if (removed.count(it->second))
+			it = sharedTypes.erase(it);
+		else
+			++it;
+	auto& generalTypes = provider.m_generalTypes;
+	generalTypes.erase(
+		remove_if(
+			generalTypes.begin(),
+			generalTypes.end(),
+			[&](unique_ptr<Type> const& _type) { return removed.count(_type.get()) > 0; }
+		),
+		generalTypes.end()
+	);
+}
+
+size_t TypeProvider::typeCount()
+{
+	TypeProvider const& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	return
+		provider.m_generalTypes.size() +
+		provider.m_stringLiteralTypes.size() +
+		provider.m_ufixedMxN.size() +
+		provider.m_fixedMxN.size();
 }
 
 template <typename T, typename... Args>
 inline T const* TypeProvider::createAndGet(Args&& ... _args)
 {
-	instance().m_generalTypes.emplace_back(make_unique<T>(std::forward<Args>(_args)...));
-	return static_cast<T const*>(instance().m_generalTypes.back().get());
+	// The type is constructed before acquiring the lock, because constructors
+	// can request further types.
+	return share(make_unique<T>(std::forward<Args>(_args)...));
+}
+
+template <typename T>
+T const* TypeProvider::share(unique_ptr<T> _type)
+{
+	string id = identity(*_type);
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!id.empty())
+	{
+		auto [it, inserted] = provider.m_sharedTypes.emplace(move(id), _type.get());
+		if (!inserted)
+		{
+			solAssert(typeid(*it->second) == typeid(*_type), "Shared types of equal identity differ.");
+			return static_cast<T const*>(it->second);
+		}
+	}
+	T const* result = _type.get();
+	provider.m_generalTypes.emplace_back(move(_type));
+	return result;
 }
 
 Type const* TypeProvider::fromElementaryTypeName(ElementaryTypeNameToken const& _type, std::optional<StateMutability> _stateMutability)
@@ -304,37 +383,47 @@ TypePointer TypeProvider::fromElementaryTypeName(string const& _name)
 
 ArrayType const* TypeProvider::bytesStorage()
 {
-	if (!m_bytesStorage)
-		m_bytesStorage = make_unique<ArrayType>(DataLocation::Storage, false);
-	return m_bytesStorage.get();
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!provider.m_bytesStorage)
+		provider.m_bytesStorage = make_unique<ArrayType>(DataLocation::Storage, false);
+	return provider.m_bytesStorage.get();
 }
 
 ArrayType const* TypeProvider::bytesMemory()
 {
-	if (!m_bytesMemory)
-		m_bytesMemory = make_unique<ArrayType>(DataLocation::Memory, false);
-	return m_bytesMemory.get();
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!provider.m_bytesMemory)
+		provider.m_bytesMemory = make_unique<ArrayType>(DataLocation::Memory, false);
+	return provider.m_bytesMemory.get();
 }
 
 ArrayType const* TypeProvider::bytesCalldata()
 {
-	if (!m_bytesCalldata)
-		m_bytesCalldata = make_unique<ArrayType>(DataLocation::CallData, false);
-	return m_bytesCalldata.get();
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!provider.m_bytesCalldata)
+		provider.m_bytesCalldata = make_unique<ArrayType>(DataLocation::CallData, false);
+	return provider.m_bytesCalldata.get();
 }
 
 ArrayType const* TypeProvider::stringStorage()
 {
-	if (!m_stringStorage)
-		m_stringStorage = make_unique<ArrayType>(DataLocation::Storage, true);
-	return m_stringStorage.get();
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!provider.m_stringStorage)
+		provider.m_stringStorage = make_unique<ArrayType>(DataLocation::Storage, true);
+	return provider.m_stringStorage.get();
 }
 
 ArrayType const* TypeProvider::stringMemory()
 {
-	if (!m_stringMemory)
-		m_stringMemory = make_unique<ArrayType>(DataLocation::Memory, true);
-	return m_stringMemory.get();
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	if (!provider.m_stringMemory)
+		provider.m_stringMemory = make_unique<ArrayType>(DataLocation::Memory, true);
+	return provider.m_stringMemory.get();
 }
 
 TypePointer TypeProvider::forLiteral(Literal const& _literal)
@@ -375,16 +464,20 @@ RationalNumberType const* TypeProvider::rationalNumber(Literal const& _literal)
 
 StringLiteralType const* TypeProvider::stringLiteral(string const& literal)
 {
-	auto i = instance().m_stringLiteralTypes.find(literal);
-	if (i != instance().m_stringLiteralTypes.end())
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	auto i = provider.m_stringLiteralTypes.find(literal);
+	if (i != provider.m_stringLiteralTypes.end())
 		return i->second.get();
 	else
-		return instance().m_stringLiteralTypes.emplace(literal, make_unique<StringLiteralType>(literal)).first->second.get();
+		return provider.m_stringLiteralTypes.emplace(literal, make_unique<StringLiteralType>(literal)).first->second.get();
 }
 
 FixedPointType const* TypeProvider::fixedPoint(unsigned m, unsigned n, FixedPointType::Modifier _modifier)
 {
-	auto& map = _modifier == FixedPointType::Modifier::Unsigned ? instance().m_ufixedMxN : instance().m_fixedMxN;
+	TypeProvider& provider = instance();
+	lock_guard<mutex> lock(provider.m_mutex);
+	auto& map = _modifier == FixedPointType::Modifier::Unsigned ? provider.m_ufixedMxN : provider.m_fixedMxN;
 
 	auto i = map.find(make_pair(m, n));
 	if (i != map.end())
@@ -399,7 +492,7 @@ FixedPointType const* TypeProvider::fixedPoint(unsigned m, unsigned n, FixedPoin
 TupleType const* TypeProvider::tuple(vector<Type const*> members)
 {
 	if (members.empty())
-		return &m_emptyTuple;
+		return emptyTuple();
 
 	return createAndGet<TupleType>(move(members));
 }
@@ -409,8 +502,7 @@ ReferenceType const* TypeProvider::withLocation(ReferenceType const* _type, Data
 	if (_type->location() == _location && _type->isPointer() == _isPointer)
 		return _type;
 
-	instance().m_generalTypes.emplace_back(_type->copyForLocation(_location, _isPointer));
-	return static_cast<ReferenceType const*>(instance().m_generalTypes.back().get());
+	return share(_type->copyForLocation(_location, _isPointer));
 }
 
 FunctionType const* TypeProvider::function(FunctionDefinition const& _function, bool _isInternal)
@@ -545,10 +637,15 @@ ModifierType const* TypeProvider::modifier(ModifierDefinition const& _def)
 	return createAndGet<ModifierType>(_def);
 }
 
+ModifierType const* TypeProvider::modifier(TypePointers _parameterTypes)
+{
+	return createAndGet<ModifierType>(std::move(_parameterTypes));
+}
+
 MagicType const* TypeProvider::magic(MagicType::Kind _kind)
 {
 	solAssert(_kind != MagicType::Kind::MetaType, "MetaType is handled separately");
-	return m_magics.at(static_cast<size_t>(_kind)).get();
+	return instance().m_magics.at(static_cast<size_t>(_kind)).get();
 }
 
 MagicType const* TypeProvider::meta(Type const* _type)
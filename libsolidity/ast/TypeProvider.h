@@ -22,7 +22,10 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <unordered_map>
 #include <utility>
 
 namespace dev
@@ -34,25 +37,62 @@ namespace solidity
  * API for accessing the Solidity Type System.
  *
  * This is the Solidity Compiler's type provider. Use it to request for types. The caller does
- * <b>not</b> own the types.
+ * <b>not</b> own the types. Requesting a type that is indistinguishable from an existing one
+ * returns the existing one, so that lazily computed data like member lists is shared.
  *
  * It is not recommended to explicitly instantiate types unless you really know what and why
  * you are doing it.
+ *
+ * The static functions operate on the instance that is current on the calling thread, see
+ * ScopedInstance. Types of different instances must not be mixed.
  */
 class TypeProvider
 {
 public:
-	TypeProvider() = default;
-	TypeProvider(TypeProvider&&) = default;
+	TypeProvider();
 	TypeProvider(TypeProvider const&) = delete;
-	TypeProvider& operator=(TypeProvider&&) = default;
 	TypeProvider& operator=(TypeProvider const&) = delete;
 	~TypeProvider() = default;
 
+	/// Makes a type provider the current one of the calling thread for the lifetime of this
+	/// object, so that independent compilations can run on different threads.
+	class ScopedInstance
+	{
+	public:
+		explicit ScopedInstance(TypeProvider& _provider): m_previous(s_current) { s_current = &_provider; }
+		~ScopedInstance() { s_current = m_previous; }
+		ScopedInstance(ScopedInstance const&) = delete;
+		ScopedInstance& operator=(ScopedInstance const&) = delete;
+
+	private:
+		TypeProvider* m_previous;
+	};
+
+	/// @returns the current type provider of the calling thread. Unless one is set via
+	/// ScopedInstance, this is a default instance owned by the thread.
+	static TypeProvider& instance()
+	{
+		if (s_current)
+			return *s_current;
+		return threadInstance();
+	}
+
 	/// Resets state of this TypeProvider to initial state, wiping all mutable types.
 	/// This invalidates all dangling pointers to types provided by this TypeProvider.
 	static void reset();
 
+	/// Clears the lazily computed data (e.g. member lists) of all types, but keeps the types.
+	/// Has to be called if AST nodes this data may refer to are destroyed.
+	static void invalidateCaches();
+
+	/// Destroys all types that refer to any of the AST nodes in @a _nodes, directly or through
+	/// the types they are composed of, and clears the caches of all other types.
+	/// Has to be called before these AST nodes are destroyed.
+	static void removeTypesReferringTo(std::set<ASTNode const*> const& _nodes);
+
+	/// @returns the number of types created since the last reset, excluding the predefined ones.
+	static size_t typeCount();
+
 	/// @name Factory functions
 	/// Factory functions that convert an AST @ref TypeName to a Type.
 	static Type const* fromElementaryTypeName(ElementaryTypeNameToken const& _type, std::optional<StateMutability> _stateMutability = {});
@@ -62,10 +102,10 @@ public:
 	static TypePointer fromElementaryTypeName(std::string const& _name);
 
 	/// @returns boolean type.
-	static BoolType const* boolean() noexcept { return &m_boolean; }
+	static BoolType const* boolean() noexcept { return &instance().m_boolean; }
 
 	static FixedBytesType const* byte() { return fixedBytes(1); }
-	static FixedBytesType const* fixedBytes(unsigned m) { return m_bytesM.at(m - 1).get(); }
+	static FixedBytesType const* fixedBytes(unsigned m) { return instance().m_bytesM.at(m - 1).get(); }
 
 	static ArrayType const* bytesStorage();
 	static ArrayType const* bytesMemory();
@@ -84,16 +124,16 @@ public:
 
 	static ArraySliceType const* arraySlice(ArrayType const& _arrayType);
 
-	static AddressType const* payableAddress() noexcept { return &m_payableAddress; }
-	static AddressType const* address() noexcept { return &m_address; }
+	static AddressType const* payableAddress() noexcept { return &instance().m_payableAddress; }
+	static AddressType const* address() noexcept { return &instance().m_address; }
 
 	static IntegerType const* integer(unsigned _bits, IntegerType::Modifier _modifier)
 	{
 		solAssert((_bits % 8) == 0, "");
 		if (_modifier == IntegerType::Modifier::Unsigned)
-			return m_uintM.at(_bits / 8 - 1).get();
+			return instance().m_uintM.at(_bits / 8 - 1).get();
 		else
-			return m_intM.at(_bits / 8 - 1).get();
+			return instance().m_intM.at(_bits / 8 - 1).get();
 	}
 	static IntegerType const* uint(unsigned _bits) { return integer(_bits, IntegerType::Modifier::Unsigned); }
 
@@ -107,7 +147,7 @@ public:
 	/// @returns a tuple type with the given members.
 	static TupleType const* tuple(std::vector<Type const*> members);
 
-	static TupleType const* emptyTuple() noexcept { return &m_emptyTuple; }
+	static TupleType const* emptyTuple() noexcept { return &instance().m_emptyTuple; }
 
 	static ReferenceType const* withLocation(ReferenceType const* _type, DataLocation _location, bool _isPointer);
 
@@ -170,7 +210,7 @@ public:
 
 	static ContractType const* contract(ContractDefinition const& _contract, bool _isSuper = false);
 
-	static InaccessibleDynamicType const* inaccessibleDynamic() noexcept { return &m_inaccessibleDynamic; }
+	static InaccessibleDynamicType const* inaccessibleDynamic() noexcept { return &instance().m_inaccessibleDynamic; }
 
 	/// @returns the type of an enum instance for given definition, there is one distinct type per enum definition.
 	static EnumType const* enumType(EnumDefinition const& _enum);
@@ -184,6 +224,9 @@ public:
 
 	static ModifierType const* modifier(ModifierDefinition const& _modifierDef);
 
+	/// @returns the type of a modifier with the given parameter types.
+	static ModifierType const* modifier(TypePointers _parameterTypes);
+
 	static MagicType const* magic(MagicType::Kind _kind);
 
 	static MagicType const* meta(Type const* _type);
@@ -191,38 +234,47 @@ public:
 	static MappingType const* mapping(Type const* _keyType, Type const* _valueType);
 
 private:
-	/// Global TypeProvider instance.
-	static TypeProvider& instance()
-	{
-		static TypeProvider _provider;
-		return _provider;
-	}
+	/// @returns the default instance of the calling thread.
+	static TypeProvider& threadInstance();
 
 	template <typename T, typename... Args>
 	static inline T const* createAndGet(Args&& ... _args);
+	/// Takes ownership of @a _type, unless an indistinguishable type already exists, in
+	/// which case that one is returned and @a _type is destroyed.
+	template <typename T>
+	static T const* share(std::unique_ptr<T> _type);
+
+	/// The instance set by the innermost ScopedInstance of the calling thread, if any.
+	static thread_local TypeProvider* s_current;
+
+	/// Guards the lists of types, which can be extended concurrently when contracts are
+	/// compiled in parallel.
+	mutable std::mutex m_mutex;
 
-	static BoolType const m_boolean;
-	static InaccessibleDynamicType const m_inaccessibleDynamic;
+	BoolType const m_boolean{};
+	InaccessibleDynamicType const m_inaccessibleDynamic{};
 
 	/// These are lazy-initialized because they depend on `byte` being available.
-	static std::unique_ptr<ArrayType> m_bytesStorage;
-	static std::unique_ptr<ArrayType> m_bytesMemory;
-	static std::unique_ptr<ArrayType> m_bytesCalldata;
-	static std::unique_ptr<ArrayType> m_stringStorage;
-	static std::unique_ptr<ArrayType> m_stringMemory;
-
-	static TupleType const m_emptyTuple;
-	static AddressType const m_payableAddress;
-	static AddressType const m_address;
-	static std::array<std::unique_ptr<IntegerType>, 32> const m_intM;
-	static std::array<std::unique_ptr<IntegerType>, 32> const m_uintM;
-	static std::array<std::unique_ptr<FixedBytesType>, 32> const m_bytesM;
-	static std::array<std::unique_ptr<MagicType>, 4> const m_magics;        ///< MagicType's except MetaType
+	std::unique_ptr<ArrayType> m_bytesStorage;
+	std::unique_ptr<ArrayType> m_bytesMemory;
+	std::unique_ptr<ArrayType> m_bytesCalldata;
+	std::unique_ptr<ArrayType> m_stringStorage;
+	std::unique_ptr<ArrayType> m_stringMemory;
+
+	TupleType const m_emptyTuple{};
+	AddressType const m_payableAddress{StateMutability::Payable};
+	AddressType const m_address{StateMutability::NonPayable};
+	std::array<std::unique_ptr<IntegerType>, 32> m_intM;
+	std::array<std::unique_ptr<IntegerType>, 32> m_uintM;
+	std::array<std::unique_ptr<FixedBytesType>, 32> m_bytesM;
+	std::array<std::unique_ptr<MagicType>, 4> m_magics;        ///< MagicType's except MetaType
 
 	std::map<std::pair<unsigned, unsigned>, std::unique_ptr<FixedPointType>> m_ufixedMxN{};
 	std::map<std::pair<unsigned, unsigned>, std::unique_ptr<FixedPointType>> m_fixedMxN{};
 	std::map<std::string, std::unique_ptr<StringLiteralType>> m_stringLiteralTypes{};
 	std::vector<std::unique_ptr<Type>> m_generalTypes{};
+	/// The types in m_generalTypes that can be shared, by their identity.
+	std::unordered_map<std::string, Type const*> m_sharedTypes{};
 };
 
 } // namespace solidity
@@ -43,6 +43,7 @@
 #include <boost/range/algorithm/copy.hpp>
 
 #include <limits>
+#include <mutex>
 
 using namespace std;
 using namespace dev;
@@ -52,6 +53,15 @@ using namespace dev::solidity;
 namespace
 {
 
+/// Maximum number of bits of the numerator and denominator of rational constants.
+/// This bounds the cost of the arithmetic on constants during type checking.
+size_t const c_rationalBitsMax = 4096;
+/// Maximum number of decimal digits before and after the radix point of a number literal,
+/// not counting leading and trailing zeros, respectively. Literals with more digits cannot
+/// denote a rational constant within the precision limit in practice: Its numerator has at most
+/// 1234 digits and its denominator is at least 2 ** k, where k is the number of decimal places.
+size_t const c_literalDigitsMax = 1234 + c_rationalBitsMax + 1;
+
 /// Check whether (_base ** _exp) fits into 4096 bits.
 bool fitsPrecisionExp(bigint const& _base, bigint const& _exp)
 {
@@ -60,7 +70,7 @@ bool fitsPrecisionExp(bigint const& _base, bigint const& _exp)
 
 	solAssert(_base > 0, "");
 
-	size_t const bitsMax = 4096;
+	size_t const bitsMax = c_rationalBitsMax;
 
 	unsigned mostSignificantBaseBit = boost::multiprecision::msb(_base);
 	if (mostSignificantBaseBit == 0) // _base == 1
@@ -86,7 +96,7 @@ bool fitsPrecisionBaseX(
 
 	solAssert(_mantissa > 0, "");
 
-	size_t const bitsMax = 4096;
+	size_t const bitsMax = c_rationalBitsMax;
 
 	unsigned mostSignificantMantissaBit = boost::multiprecision::msb(_mantissa);
 	if (mostSignificantMantissaBit > bitsMax) // _mantissa >= 2 ^ 4096
@@ -109,6 +119,17 @@ bool fitsPrecisionBase2(bigint const& _mantissa, uint32_t _expBase2)
 	return fitsPrecisionBaseX(_mantissa, 1.0, _expBase2);
 }
 
+/// Checks whether the numerator and denominator of _value fit into 4096 bits.
+bool fitsPrecision(rational const& _value)
+{
+	return
+		_value.numerator() == 0 ||
+		max(
+			boost::multiprecision::msb(abs(_value.numerator())),
+			boost::multiprecision::msb(abs(_value.denominator()))
+		) <= c_rationalBitsMax;
+}
+
 /// Checks whether _value fits into IntegerType _type.
 BoolResult fitsIntegerType(bigint const& _value, IntegerType const& _type)
 {
@@ -150,6 +171,7 @@ Result<TypePointers> transformParametersToExternal(TypePointers const& _paramete
 
 void Type::clearCache() const
 {
+	lock_guard<mutex> lock(m_cacheMutex);
 	m_members.clear();
 }
 
@@ -197,33 +219,81 @@ pair<u256, unsigned> const* StorageOffsets::offset(size_t _index) const
 		return nullptr;
 }
 
+MemberList::MemberList(MemberMap _members):
+	m_memberTypes(move(_members))
+{
+	indexMembers();
+}
+
 void MemberList::combine(MemberList const & _other)
 {
 	m_memberTypes += _other.m_memberTypes;
+	indexMembers();
+}
+
+TypePointer MemberList::memberType(string const& _name) const
+{
+	size_t position = firstPosition(_name);
+	if (position == npos)
+		return nullptr;
+	solAssert(m_nextPositions[position] == npos, "Requested member type by non-unique name.");
+	return m_memberTypes[position].type;
+}
+
+MemberList::MemberMap MemberList::membersByName(string const& _name) const
+{
+	MemberMap members;
+	for (size_t position = firstPosition(_name); position != npos; position = m_nextPositions[position])
+		members.push_back(m_memberTypes[position]);
+	return members;
+}
+
+void MemberList::indexMembers()
+{
+	m_firstPositions = make_unique<unordered_map<string, size_t>>();
+	m_nextPositions.assign(m_memberTypes.size(), npos);
+	// Walk backwards so that every member is linked to the next one of the same name.
+	for (size_t position = m_memberTypes.size(); position-- > 0;)
+	{
+		auto [it, inserted] = m_firstPositions->emplace(m_memberTypes[position].name, position);
+		if (!inserted)
+		{
+			m_nextPositions[position] = it->second;
+			it->second = position;
+		}
+	}
+}
+
+size_t MemberList::firstPosition(string const& _name) const
+{
+	auto it = m_firstPositions->find(_name);
+	return it == m_firstPositions->end() ? npos : it->second;
 }
 
 pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name) const
 {
-	if (!m_storageOffsets)
+	shared_ptr<StorageOffsets const> offsets = atomic_load(&m_storageOffsets);
+	if (!offsets)
 	{
 		TypePointers memberTypes;
 		memberTypes.reserve(m_memberTypes.size());
 		for (auto const& member: m_memberTypes)
 			memberTypes.push_back(member.type);
-		m_storageOffsets.reset(new StorageOffsets());
-		m_storageOffsets->computeOffsets(memberTypes);
+		auto computed = make_shared<StorageOffsets>();
+		computed->computeOffsets(memberTypes);
+		// Another thread might have computed the offsets in the meantime, keep the first result.
+		if (atomic_compare_exchange_strong(&m_storageOffsets, &offsets, shared_ptr<StorageOffsets const>(computed)))
+			offsets = move(computed);
 	}
-	for (size_t index = 0; index < m_memberTypes.size(); ++index)
-		if (m_memberTypes[index].name == _name)
-			return m_storageOffsets->offset(index);
-	return nullptr;
+	size_t position = firstPosition(_name);
+	return position == npos ? nullptr : offsets->offset(position);
 }
 
 u256 const& MemberList::storageSize() const
 {
 	// trigger lazy computation
 	memberStorageOffset("");
-	return m_storageOffsets->storageSize();
+	return atomic_load(&m_storageOffsets)->storageSize();
 }
 
 /// Helper functions for type identifier
@@ -307,14 +377,21 @@ TypePointer Type::commonType(Type const* _a, Type const* _b)
 
 MemberList const& Type::members(ContractDefinition const* _currentScope) const
 {
-	if (!m_members[_currentScope])
 	{
-		MemberList::MemberMap members = nativeMembers(_currentScope);
-		if (_currentScope)
-			members += boundFunctions(*this, *_currentScope);
-		m_members[_currentScope] = make_unique<MemberList>(move(members));
+		lock_guard<mutex> lock(m_cacheMutex);
+		auto it = m_members.find(_currentScope);
+		if (it != m_members.end())
+			return *it->second;
 	}
-	return *m_members[_currentScope];
+	MemberList::MemberMap members = nativeMembers(_currentScope);
+	if (_currentScope)
+		members += boundFunctions(*this, *_currentScope);
+	auto memberList = make_unique<MemberList>(move(members));
+	lock_guard<mutex> lock(m_cacheMutex);
+	unique_ptr<MemberList>& entry = m_members[_currentScope];
+	if (!entry)
+		entry = move(memberList);
+	return *entry;
 }
 
 TypePointer Type::fullEncodingType(bool _inLibraryCall, bool _encoderV2, bool) const
@@ -355,17 +432,9 @@ MemberList::MemberMap Type::boundFunctions(Type const& _type, ContractDefinition
 			auto const& library = dynamic_cast<ContractDefinition const&>(
 				*ufd->libraryName().annotation().referencedDeclaration
 			);
-			for (FunctionDefinition const* function: library.definedFunctions())
-			{
-				if (!function->isVisibleAsLibraryMember() || seenFunctions.count(function))
-					continue;
-				seenFunctions.insert(function);
-				if (function->parameters().empty())
-					continue;
-				FunctionTypePointer fun = FunctionType(*function, false).asCallableFunction(true, true);
-				if (_type.isImplicitlyConvertibleTo(*fun->selfType()))
+			for (auto const& [function, fun]: library.attachableFunctions())
+				if (seenFunctions.insert(function).second && _type.isImplicitlyConvertibleTo(*fun->selfType()))
 					members.emplace_back(function->name(), fun, function);
-			}
 		}
 	return members;
 }
@@ -718,7 +787,17 @@ tuple<bool, rational> RationalNumberType::parseRational(string const& _value)
 	rational value;
 	try
 	{
+		// Bound the cost of the conversion below.
 		auto radixPoint = find(_value.begin(), _value.end(), '.');
+		auto integerBegin = find_if(_value.begin(), radixPoint, [](char _c) { return _c != '0'; });
+		auto fractionalEnd = radixPoint == _value.end() ?
+			radixPoint :
+			find_if(_value.rbegin(), make_reverse_iterator(radixPoint + 1), [](char _c) { return _c != '0'; }).base();
+		if (
+			size_t(radixPoint - integerBegin) > c_literalDigitsMax ||
+			size_t(fractionalEnd - radixPoint) > c_literalDigitsMax + 1
+		)
+			return make_tuple(false, rational(0));
 
 		if (radixPoint != _value.end())
 		{
@@ -731,17 +810,18 @@ tuple<bool, rational> RationalNumberType::parseRational(string const& _value)
 			// Only decimal notation allowed here, leading zeros would switch to octal.
 			auto fractionalBegin = find_if_not(
 				radixPoint + 1,
-				_value.end(),
+				fractionalEnd,
 				[](char const& a) { return a == '0'; }
 			);
 
 			rational numerator;
 			rational denominator(1);
 
-			denominator = bigint(string(fractionalBegin, _value.end()));
+			// Trailing zeros do not change the value.
+			denominator = bigint(string(fractionalBegin, fractionalEnd));
 			denominator /= boost::multiprecision::pow(
 				bigint(10),
-				distance(radixPoint + 1, _value.end())
+				distance(radixPoint + 1, fractionalEnd)
 			);
 			numerator = bigint(string(_value.begin(), radixPoint));
 			value = numerator + denominator;
@@ -770,6 +850,9 @@ tuple<bool, rational> RationalNumberType::isValidLiteral(Literal const& _literal
 		if (boost::starts_with(valueString, "0x"))
 		{
 			// process as hex
+			size_t significantDigits = valueString.size() - min(valueString.find_first_not_of('0', 2), valueString.size());
+			if (significantDigits > c_rationalBitsMax / 4 + 1)
+				return make_tuple(false, rational(0));
 			value = bigint(valueString);
 		}
 		else if (expPoint != valueString.end())
@@ -785,7 +868,11 @@ tuple<bool, rational> RationalNumberType::isValidLiteral(Literal const& _literal
 			if (value == 0)
 				return make_tuple(true, rational(0));
 
-			bigint exp = bigint(string(expPoint + 1, valueString.end()));
+			string expString(expPoint + 1, valueString.end());
+			// Avoid converting exponents that are out of range anyway.
+			if (expString.size() - min(expString.find_first_not_of("-0"), expString.size()) > 10)
+				return make_tuple(false, rational(0));
+			bigint exp = bigint(expString);
 
 			if (exp > numeric_limits<int32_t>::max() || exp < numeric_limits<int32_t>::min())
 				return make_tuple(false, rational(0));
@@ -856,6 +943,8 @@ tuple<bool, rational> RationalNumberType::isValidLiteral(Literal const& _literal
 			break;
 	}
 
+	if (!fitsPrecision(value))
+		return make_tuple(false, rational(0));
 
 	return make_tuple(true, value);
 }
@@ -1107,7 +1196,7 @@ TypeResult RationalNumberType::binaryOperatorResult(Token _operator, Type const*
 		}
 
 		// verify that numerator and denominator fit into 4096 bit after every operation
-		if (value.numerator() != 0 && max(boost::multiprecision::msb(abs(value.numerator())), boost::multiprecision::msb(abs(value.denominator()))) > 4096)
+		if (!fitsPrecision(value))
 			return TypeResult::err("Precision of rational constants is limited to 4096 bits.");
 
 		return TypeResult{TypeProvider::rationalNumber(value)};
@@ -1541,6 +1630,7 @@ void ArrayType::clearCache() const
 {
 	Type::clearCache();
 
+	lock_guard<mutex> lock(m_cacheMutex);
 	m_interfaceType.reset();
 	m_interfaceType_library.reset();
 }
@@ -1623,6 +1713,8 @@ string ArrayType::richIdentifier() const
 
 bool ArrayType::operator==(Type const& _other) const
 {
+	if (this == &_other)
+		return true;
 	if (_other.category() != category())
 		return false;
 	ArrayType const& other = dynamic_cast<ArrayType const&>(_other);
@@ -1815,11 +1907,14 @@ TypePointer ArrayType::decodingType() const
 
 TypeResult ArrayType::interfaceType(bool _inLibrary) const
 {
-	if (_inLibrary && m_interfaceType_library.has_value())
-		return *m_interfaceType_library;
+	{
+		lock_guard<mutex> lock(m_cacheMutex);
+		if (_inLibrary && m_interfaceType_library.has_value())
+			return *m_interfaceType_library;
 
-	if (!_inLibrary && m_interfaceType.has_value())
-		return *m_interfaceType;
+		if (!_inLibrary && m_interfaceType.has_value())
+			return *m_interfaceType;
+	}
 
 	TypeResult result{TypePointer{}};
 	TypeResult baseInterfaceType = m_baseType->interfaceType(_inLibrary);
@@ -1838,12 +1933,11 @@ TypeResult ArrayType::interfaceType(bool _inLibrary) const
 	else
 		result = TypeProvider::array(DataLocation::Memory, baseInterfaceType, m_length);
 
-	if (_inLibrary)
-		m_interfaceType_library = result;
-	else
-		m_interfaceType = result;
-
-	return result;
+	lock_guard<mutex> lock(m_cacheMutex);
+	optional<TypeResult>& cached = _inLibrary ? m_interfaceType_library : m_interfaceType;
+	if (!cached.has_value())
+		cached = result;
+	return *cached;
 }
 
 u256 ArrayType::memoryDataSize() const
@@ -1964,8 +2058,15 @@ MemberList::MemberMap ContractType::nativeMembers(ContractDefinition const* _con
 
 FunctionType const* ContractType::newExpressionType() const
 {
+	{
+		lock_guard<mutex> lock(m_cacheMutex);
+		if (m_constructorType)
+			return m_constructorType;
+	}
+	FunctionType const* constructorType = FunctionType::newExpressionType(m_contract);
+	lock_guard<mutex> lock(m_cacheMutex);
 	if (!m_constructorType)
-		m_constructorType = FunctionType::newExpressionType(m_contract);
+		m_constructorType = constructorType;
 	return m_constructorType;
 }
 
@@ -1993,6 +2094,7 @@ void StructType::clearCache() const
 {
 	Type::clearCache();
 
+	lock_guard<mutex> lock(m_cacheMutex);
 	m_interfaceType.reset();
 	m_interfaceType_library.reset();
 }
@@ -2131,17 +2233,36 @@ MemberList::MemberMap StructType::nativeMembers(ContractDefinition const*) const
 	return members;
 }
 
+bool StructType::recursive() const
+{
+	if (optional<bool> known = knownRecursive())
+		return *known;
+
+	interfaceType(false);
+
+	return knownRecursive().value();
+}
+
+optional<bool> StructType::knownRecursive() const
+{
+	lock_guard<mutex> lock(m_cacheMutex);
+	return m_recursive;
+}
+
 TypeResult StructType::interfaceType(bool _inLibrary) const
 {
-	if (_inLibrary && m_interfaceType_library.has_value())
-		return *m_interfaceType_library;
+	{
+		lock_guard<mutex> lock(m_cacheMutex);
+		if (_inLibrary && m_interfaceType_library.has_value())
+			return *m_interfaceType_library;
 
-	if (!_inLibrary && m_interfaceType.has_value())
-		return *m_interfaceType;
+		if (!_inLibrary && m_interfaceType.has_value())
+			return *m_interfaceType;
+	}
 
 	TypeResult result{TypePointer{}};
 
-	m_recursive = false;
+	bool recursive = false;
 
 	auto visitor = [&](
 		StructDefinition const& _struct,
@@ -2169,11 +2290,11 @@ TypeResult StructType::interfaceType(bool _inLibrary) const
 
 			if (StructType const* innerStruct = dynamic_cast<StructType const*>(memberType))
 				if (
-					innerStruct->m_recursive == true ||
+					(innerStruct != this && innerStruct->knownRecursive() == true) ||
 					_cycleDetector.run(innerStruct->structDefinition())
 				)
 				{
-					m_recursive = true;
+					recursive = true;
 					if (_inLibrary && location() == DataLocation::Storage)
 						continue;
 					else
@@ -2193,31 +2314,41 @@ TypeResult StructType::interfaceType(bool _inLibrary) const
 		}
 	};
 
-	m_recursive = m_recursive.value() || (CycleDetector<StructDefinition>(visitor).run(structDefinition()) != nullptr);
+	recursive = recursive || (CycleDetector<StructDefinition>(visitor).run(structDefinition()) != nullptr);
 
 	std::string const recursiveErrMsg = "Recursive type not allowed for public or external contract functions.";
 
 	if (_inLibrary)
 	{
-		if (!result.message().empty())
-			m_interfaceType_library = result;
-		else if (location() == DataLocation::Storage)
-			m_interfaceType_library = this;
-		else
-			m_interfaceType_library = TypeProvider::withLocation(this, DataLocation::Memory, true);
+		TypeResult libraryType = result;
+		if (result.message().empty())
+		{
+			if (location() == DataLocation::Storage)
+				libraryType = this;
+			else
+				libraryType = TypeProvider::withLocation(this, DataLocation::Memory, true);
+		}
 
-		if (m_recursive.value())
+		lock_guard<mutex> lock(m_cacheMutex);
+		m_recursive = recursive;
+		if (!m_interfaceType_library.has_value())
+			m_interfaceType_library = libraryType;
+		if (recursive && !m_interfaceType.has_value())
 			m_interfaceType = TypeResult::err(recursiveErrMsg);
 
 		return *m_interfaceType_library;
 	}
 
-	if (m_recursive.value())
-		m_interfaceType = TypeResult::err(recursiveErrMsg);
-	else if (!result.message().empty())
-		m_interfaceType = result;
-	else
-		m_interfaceType = TypeProvider::withLocation(this, DataLocation::Memory, true);
+	TypeResult interfaceType = result;
+	if (recursive)
+		interfaceType = TypeResult::err(recursiveErrMsg);
+	else if (result.message().empty())
+		interfaceType = TypeProvider::withLocation(this, DataLocation::Memory, true);
+
+	lock_guard<mutex> lock(m_cacheMutex);
+	m_recursive = recursive;
+	if (!m_interfaceType.has_value())
+		m_interfaceType = interfaceType;
 
 	return *m_interfaceType;
 }
@@ -2743,6 +2874,8 @@ string FunctionType::richIdentifier() const
 
 bool FunctionType::operator==(Type const& _other) const
 {
+	if (this == &_other)
+		return true;
 	if (_other.category() != category())
 		return false;
 	FunctionType const& other = dynamic_cast<FunctionType const&>(_other);
@@ -3313,6 +3446,8 @@ string MappingType::richIdentifier() const
 
 bool MappingType::operator==(Type const& _other) const
 {
+	if (this == &_other)
+		return true;
 	if (_other.category() != category())
 		return false;
 	MappingType const& other = dynamic_cast<MappingType const&>(_other);
@@ -3356,6 +3491,8 @@ string TypeType::richIdentifier() const
 
 bool TypeType::operator==(Type const& _other) const
 {
+	if (this == &_other)
+		return true;
 	if (_other.category() != category())
 		return false;
 	TypeType const& other = dynamic_cast<TypeType const&>(_other);
@@ -33,11 +33,14 @@
 
 #include <boost/rational.hpp>
 
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 namespace dev
 {
@@ -108,28 +111,11 @@ public:
 
 	using MemberMap = std::vector<Member>;
 
-	explicit MemberList(MemberMap const& _members): m_memberTypes(_members) {}
+	explicit MemberList(MemberMap _members);
 
 	void combine(MemberList const& _other);
-	TypePointer memberType(std::string const& _name) const
-	{
-		TypePointer type = nullptr;
-		for (auto const& it: m_memberTypes)
-			if (it.name == _name)
-			{
-				solAssert(!type, "Requested member type by non-unique name.");
-				type = it.type;
-			}
-		return type;
-	}
-	MemberMap membersByName(std::string const& _name) const
-	{
-		MemberMap members;
-		for (auto const& it: m_memberTypes)
-			if (it.name == _name)
-				members.push_back(it);
-		return members;
-	}
+	TypePointer memberType(std::string const& _name) const;
+	MemberMap membersByName(std::string const& _name) const;
 	/// @returns the offset of the given member in storage slots and bytes inside a slot or
 	/// a nullptr if the member is not part of storage.
 	std::pair<u256, unsigned> const* memberStorageOffset(std::string const& _name) const;
@@ -140,8 +126,20 @@ public:
 	MemberMap::const_iterator end() const { return m_memberTypes.end(); }
 
 private:
+	/// Rebuilds the name index from m_memberTypes.
+	void indexMembers();
+	/// @returns the position of the first member called @a _name or npos if there is none.
+	size_t firstPosition(std::string const& _name) const;
+
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
 	MemberMap m_memberTypes;
-	mutable std::unique_ptr<StorageOffsets> m_storageOffsets;
+	/// Position of the first member of each name in m_memberTypes.
+	std::unique_ptr<std::unordered_map<std::string, size_t>> m_firstPositions;
+	/// Position of the next member with the same name for each member, or npos.
+	std::vector<size_t> m_nextPositions;
+	/// Lazily computed, accessed atomically since member lists are shared between threads.
+	mutable std::shared_ptr<StorageOffsets const> m_storageOffsets;
 };
 
 static_assert(std::is_nothrow_move_constructible<MemberList>::value, "MemberList should be noexcept move constructible");
@@ -341,6 +339,10 @@ protected:
 
 	/// List of member types (parameterised by scape), will be lazy-initialized.
 	mutable std::map<ContractDefinition const*, std::unique_ptr<MemberList>> m_members;
+	/// Guards the lazily computed caches of this type, which are shared between threads when
+	/// contracts are compiled in parallel. Cache entries are computed without holding it, because
+	/// they can require the cache entries of other types, and only the first result is stored.
+	mutable std::mutex m_cacheMutex;
 };
 
 /**
@@ -515,6 +517,11 @@ public:
 	/// If the integer part does not fit, returns an empty pointer.
 	FixedPointType const* fixedPointType() const;
 
+	/// @returns the value of the number.
+	rational const& value() const { return m_value; }
+	/// @returns the bytes type the number can be explicitly converted to, if any.
+	Type const* compatibleBytesType() const { return m_compatibleBytesType; }
+
 	/// @returns true if the value is not an integer.
 	bool isFractional() const { return m_value.denominator() != 1; }
 
@@ -893,15 +900,7 @@ public:
 	Type const* encodingType() const override;
 	TypeResult interfaceType(bool _inLibrary) const override;
 
-	bool recursive() const
-	{
-		if (m_recursive.has_value())
-			return m_recursive.value();
-
-		interfaceType(false);
-
-		return m_recursive.value();
-	}
+	bool recursive() const;
 
 	std::unique_ptr<ReferenceType> copyForLocation(DataLocation _location, bool _isPointer) const override;
 
@@ -926,6 +925,9 @@ public:
 	void clearCache() const override;
 
 private:
+	/// @returns whether this struct is recursive if that is known already.
+	std::optional<bool> knownRecursive() const;
+
 	StructDefinition const& m_struct;
 	// Caches for interfaceType(bool)
 	mutable std::optional<TypeResult> m_interfaceType;
@@ -1332,6 +1334,7 @@ class ModifierType: public Type
 {
 public:
 	explicit ModifierType(ModifierDefinition const& _modifier);
+	explicit ModifierType(TypePointers _parameterTypes): m_parameterTypes(std::move(_parameterTypes)) {}
 
 	Category category() const override { return Category::Modifier; }
 
@@ -1345,6 +1348,8 @@ public:
 	bool operator==(Type const& _other) const override;
 	std::string toString(bool _short) const override;
 
+	TypePointers const& parameterTypes() const { return m_parameterTypes; }
+
 private:
 	TypePointers m_parameterTypes;
 };
@@ -1372,6 +1377,8 @@ public:
 
 	std::string toString(bool _short) const override;
 
+	SourceUnit const& sourceUnit() const { return m_sourceUnit; }
+
 private:
 	SourceUnit const& m_sourceUnit;
 };
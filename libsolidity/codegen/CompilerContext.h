@@ -338,6 +338,8 @@ private:
 	ABIFunctions m_abiFunctions;
 	/// The queue of low-level functions to generate.
 	std::queue<std::tuple<std::string, unsigned, unsigned, std::function<void(CompilerContext&)>>> m_lowLevelFunctionGenerationQueue;
+	/// The sources of the generated inline assembly, kept alive for the source locations referring to them.
+	std::vector<std::shared_ptr<langutil::CharStream>> m_generatedSources;
 };
 
 }
@@ -0,0 +1,68 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <libsolidity/interface/ArtifactCache.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace fs = boost::filesystem;
+
+optional<Json::Value> ArtifactCache::load(h256 const& _key) const
+{
+	string content = readFileAsString((fs::path(m_directory) / (_key.hex() + ".json")).string());
+	Json::Value artifacts;
+	if (content.empty() || !jsonParseStrict(content, artifacts) || !artifacts.isObject())
+		return {};
+	return artifacts;
+}
+
+void ArtifactCache::store(h256 const& _key, Json::Value const& _artifacts) const
+{
+	// Write to a uniquely named file first and rename it afterwards, so that concurrent
+	// readers never see partially written entries.
+	boost::system::error_code error;
+	fs::create_directories(m_directory, error);
+	if (error)
+		return;
+	fs::path target = fs::path(m_directory) / (_key.hex() + ".json");
+	fs::path temporary = fs::path(m_directory) / fs::unique_path(_key.hex() + "-%%%%-%%%%-%%%%.tmp", error);
+	if (error)
+		return;
+
+	{
+		ofstream file(temporary.string(), ios::binary);
+		file << jsonCompactPrint(_artifacts);
+		if (!file)
+		{
+			file.close();
+			fs::remove(temporary, error);
+			return;
+		}
+	}
+	fs::rename(temporary, target, error);
+	if (error)
+		fs::remove(temporary, error);
+}
@@ -0,0 +1,58 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Directory-based cache of per-contract compilation artifacts.
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <json/json.h>
+
+#include <optional>
+#include <string>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Stores compilation artifacts as one JSON file per key inside a directory. The key is
+ * expected to capture everything the artifacts depend on, i.e. entries are never invalidated.
+ * The cache is best-effort: entries that cannot be read are treated as missing and
+ * failures to write are ignored.
+ */
+class ArtifactCache
+{
+public:
+	explicit ArtifactCache(std::string _directory): m_directory(std::move(_directory)) {}
+
+	/// @returns the artifacts stored under @a _key, if present and readable.
+	std::optional<Json::Value> load(h256 const& _key) const;
+
+	/// Stores @a _artifacts under @a _key, replacing any existing entry.
+	/// Safe to be called concurrently from multiple threads and processes.
+	void store(h256 const& _key, Json::Value const& _artifacts) const;
+
+private:
+	std::string m_directory;
+};
+
+}
+}
@@ -37,10 +37,13 @@
 #include <libsolidity/analysis/ViewPureChecker.h>
 
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTBinary.h>
+#include <libsolidity/ast/ASTVisitor.h>
 #include <libsolidity/ast/TypeProvider.h>
 #include <libsolidity/codegen/Compiler.h>
 #include <libsolidity/formal/ModelChecker.h>
 #include <libsolidity/interface/ABI.h>
+#include <libsolidity/interface/ArtifactCache.h>
 #include <libsolidity/interface/Natspec.h>
 #include <libsolidity/interface/GasEstimator.h>
 #include <libsolidity/interface/StorageLayout.h>
@@ -66,12 +69,118 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
 using namespace std;
 using namespace dev;
 using namespace langutil;
 using namespace dev::solidity;
 
-static int g_compilerStackCounts = 0;
+namespace
+{
+
+/// The type providers used by a compiler stack. Every compiler stack resets its type provider,
+/// so no two of them may use the same one at a time.
+set<TypeProvider const*> g_usedTypeProviders;
+mutex g_usedTypeProvidersMutex;
+
+/// @returns a thread that runs @a _work with @a _typeProvider and the YulString repository of
+/// the calling thread, so that all workers of a compiler stack share them.
+thread startWorker(TypeProvider& _typeProvider, function<void()> _work)
+{
+	yul::YulStringRepository& yulStrings = yul::YulStringRepository::instance();
+	return thread([&_typeProvider, &yulStrings, work = move(_work)]() {
+		TypeProvider::ScopedInstance typeProviderScope(_typeProvider);
+		yul::YulStringRepository::ScopedInstance yulStringsScope(yulStrings);
+		work();
+	});
+}
+
+/// Contracts that create other contracts embed (and re-optimise) their assemblies, so
+/// contracts that share a dependency have to be compiled together, in the same order as in
+/// the sequential case.
+/// @returns the indices of @a _contracts grouped such that no two groups share a dependency.
+/// Groups are ordered by their first contract and keep the relative order of their contracts.
+vector<vector<size_t>> dependencyGroups(vector<ContractDefinition const*> const& _contracts)
+{
+	vector<size_t> group(_contracts.size());
+	for (size_t i = 0; i < _contracts.size(); ++i)
+		group[i] = i;
+	function<size_t(size_t)> findGroup = [&](size_t _index) {
+		if (group[_index] != _index)
+			group[_index] = findGroup(group[_index]);
+		return group[_index];
+	};
+
+	map<ContractDefinition const*, size_t> firstUser;
+	for (size_t i = 0; i < _contracts.size(); ++i)
+	{
+		set<ContractDefinition const*> dependencies;
+		vector<ContractDefinition const*> toVisit{_contracts[i]};
+		while (!toVisit.empty())
+		{
+			ContractDefinition const* contract = toVisit.back();
+			toVisit.pop_back();
+			if (!dependencies.insert(contract).second)
+				continue;
+			for (auto const* dependency: contract->annotation().contractDependencies)
+				toVisit.push_back(dependency);
+		}
+		for (ContractDefinition const* dependency: dependencies)
+		{
+			auto it = firstUser.find(dependency);
+			if (it == firstUser.end())
+				firstUser[dependency] = i;
+			else
+				group[findGroup(i)] = findGroup(it->second);
+		}
+	}
+
+	vector<vector<size_t>> groups;
+	map<size_t, size_t> groupIndex;
+	for (size_t i = 0; i < _contracts.size(); ++i)
+	{
+		size_t root = findGroup(i);
+		if (!groupIndex.count(root))
+		{
+			groupIndex[root] = groups.size();
+			groups.emplace_back();
+		}
+		groups[groupIndex[root]].push_back(i);
+	}
+	return groups;
+}
+
+/// Prepares the nodes of an AST that are kept when one of its elements is parsed again after
+/// an edit: Moves their locations behind the edit and drops the results of their analysis.
+class KeptNodesUpdater: public ASTVisitor
+{
+public:
+	KeptNodesUpdater(ASTNode const& _replaced, int _editEnd, int _delta):
+		m_replaced(_replaced), m_editEnd(_editEnd), m_delta(_delta) {}
+
+protected:
+	bool visitNode(ASTNode& _node) override
+	{
+		if (&_node == &m_replaced)
+			return false;
+		_node.shiftLocation(m_editEnd, m_delta);
+		_node.resetAnalysis();
+		return true;
+	}
+
+private:
+	ASTNode const& m_replaced;
+	int m_editEnd;
+	int m_delta;
+};
+
+}
 
 CompilerStack::CompilerStack(ReadCallback::Callback const& _readFile):
 	m_readFile{_readFile},
@@ -79,18 +188,26 @@ CompilerStack::CompilerStack(ReadCallback::Callback const& _readFile):
 	m_generateIR{false},
 	m_generateEwasm{false},
 	m_errorList{},
-	m_errorReporter{m_errorList}
+	m_errorReporter{m_errorList},
+	m_typeProvider{&TypeProvider::instance()}
 {
-	// Because TypeProvider is currently a singleton API, we must ensure that
-	// no more than one entity is actually using it at a time.
-	solAssert(g_compilerStackCounts == 0, "You shall not have another CompilerStack aside me.");
-	++g_compilerStackCounts;
+	// Because TypeProvider is a singleton API per thread, we must ensure that
+	// no more than one entity is actually using a provider at a time.
+	{
+		lock_guard<mutex> lock(g_usedTypeProvidersMutex);
+		solAssert(g_usedTypeProviders.insert(m_typeProvider).second, "You shall not have another CompilerStack aside me.");
+	}
+	// Types created outside of a compiler stack might be shared with new AST nodes using the same IDs.
+	TypeProvider::reset();
 }
 
 CompilerStack::~CompilerStack()
 {
-	--g_compilerStackCounts;
+	// The stack might be destroyed on a thread with a different type provider.
+	TypeProvider::ScopedInstance typeProviderScope(*m_typeProvider);
 	TypeProvider::reset();
+	lock_guard<mutex> lock(g_usedTypeProvidersMutex);
+	g_usedTypeProviders.erase(m_typeProvider);
 }
 
 std::optional<CompilerStack::Remapping> CompilerStack::parseRemapping(string const& _remapping)
@@ -129,6 +246,36 @@ void CompilerStack::setEVMVersion(langutil::EVMVersion _version)
 	m_evmVersion = _version;
 }
 
+void CompilerStack::setParallelism(unsigned _parallelism)
+{
+	if (m_stackState >= ParsingPerformed)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set parallelism before parsing."));
+	if (_parallelism == 0)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parallelism has to be at least one."));
+	m_parallelism = _parallelism;
+}
+
+void CompilerStack::allowConcurrentReads(bool _allow)
+{
+	if (m_stackState >= ParsingPerformed)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must allow concurrent reads before parsing."));
+	m_concurrentReads = _allow;
+}
+
+void CompilerStack::enableStatistics(bool _enable)
+{
+	if (m_stackState >= ParsingPerformed)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must enable statistics before parsing."));
+	m_statisticsEnabled = _enable;
+}
+
+void CompilerStack::setCacheDirectory(string _directory)
+{
+	if (m_stackState >= ParsingPerformed)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set cache directory before parsing."));
+	m_cacheDirectory = std::move(_directory);
+}
+
 void CompilerStack::setSMTSolverChoice(smt::SMTSolverChoice _enabledSMTSolvers)
 {
 	if (m_stackState >= ParsingPerformed)
@@ -201,27 +348,270 @@ void CompilerStack::reset(bool _keepSettings)
 		m_enabledSMTSolvers = smt::SMTSolverChoice::All();
 		m_generateIR = false;
 		m_generateEwasm = false;
+		m_documentationAnalysis = true;
+		m_contractPipelines.reset();
 		m_revertStrings = RevertStrings::Default;
 		m_optimiserSettings = OptimiserSettings::minimal();
 		m_metadataLiteralSources = false;
 		m_metadataHash = MetadataHash::IPFS;
+		m_parallelism = 1;
+		m_concurrentReads = false;
+		m_statisticsEnabled = false;
+		m_cacheDirectory.clear();
 	}
 	m_globalContext.reset();
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
 	m_errorReporter.clear();
+	m_unaffectedErrors.clear();
+	m_statistics = StatisticsCollector{};
+	m_lastNodeID = 0;
+	TypeProvider::ScopedInstance typeProviderScope(*m_typeProvider);
 	TypeProvider::reset();
 }
 
 void CompilerStack::setSources(StringMap _sources)
+{
+	vector<CharStream> sources;
+	for (auto& source: _sources)
+		sources.emplace_back(/*content*/std::move(source.second), /*name*/source.first);
+	setSourceStreams(std::move(sources));
+}
+
+void CompilerStack::setSourceStreams(vector<CharStream> _sources)
 {
 	if (m_stackState == SourcesSet)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Cannot change sources once set."));
 	if (m_stackState != Empty)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must set sources before parsing."));
-	for (auto source: _sources)
-		m_sources[source.first].scanner = make_shared<Scanner>(CharStream(/*content*/std::move(source.second), /*name*/source.first));
+	for (CharStream& source: _sources)
+	{
+		string name = source.name();
+		m_sources[name].scanner = make_shared<Scanner>(std::move(source));
+	}
+	m_stackState = SourcesSet;
+}
+
+void CompilerStack::updateSources(StringMap _changedSources)
+{
+	vector<CharStream> changedSources;
+	for (auto& source: _changedSources)
+		changedSources.emplace_back(std::move(source.second), source.first);
+	updateSourceStreams(std::move(changedSources));
+}
+
+void CompilerStack::updateSourceStreams(vector<CharStream> _changedSources)
+{
+	if (m_stackState < ParsingPerformed)
+	{
+		for (CharStream& source: _changedSources)
+		{
+			string name = source.name();
+			m_sources[name].scanner = make_shared<Scanner>(std::move(source));
+		}
+		m_stackState = SourcesSet;
+		return;
+	}
+
+	map<string, CharStream*> changedSources;
+	set<string> changedNames;
+	for (CharStream& source: _changedSources)
+	{
+		changedSources[source.name()] = &source;
+		changedNames.insert(source.name());
+	}
+	invalidateSources(changedNames);
+	for (auto const& changed: changedSources)
+	{
+		Source& source = m_sources[changed.first];
+		source.reset();
+		source.scanner = make_shared<Scanner>(std::move(*changed.second));
+	}
+	m_stackState = SourcesSet;
+}
+
+void CompilerStack::editSource(string const& _sourceName, size_t _start, size_t _end, string const& _replacement)
+{
+	auto it = m_sources.find(_sourceName);
+	if (it == m_sources.end())
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Given source file not found."));
+	Source& source = it->second;
+	if (_start > _end || _end > source.scanner->source().size())
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Invalid edit range."));
+
+	// The AST is dropped with those of the affected sources and restored if it can be kept.
+	// The arena is declared first, such that it outlives the AST if that is dropped.
+	unique_ptr<ASTArena> arena;
+	shared_ptr<SourceUnit> ast;
+	if (source.cleanlyParsed && source.ast)
+	{
+		arena = std::move(source.arena);
+		ast = source.ast;
+	}
+	if (m_stackState >= ParsingPerformed || source.ast)
+		invalidateSources({_sourceName});
+	source.encodedAST.clear();
+	source.keccak256HashCached = h256{};
+	source.swarmHashCached = h256{};
+	source.ipfsUrlCached.clear();
+	source.scanner->applyEdit(_start, _end, _replacement);
+	if (ast && reparseEditedElement(source, *ast, _start, _end, _replacement.size()))
+	{
+		source.ast = std::move(ast);
+		source.arena = std::move(arena);
+		source.edited = true;
+	}
+	else
+		source.cleanlyParsed = false;
+	m_stackState = SourcesSet;
+}
+
+bool CompilerStack::reparseEditedElement(
+	Source const& _source,
+	SourceUnit& _ast,
+	size_t _start,
+	size_t _end,
+	size_t _replacementLength
+)
+{
+	int const start = int(_start);
+	int const end = int(_end);
+	int const delta = int(_replacementLength) - (end - start);
+	auto enclosesEdit = [&](ASTPointer<ASTNode> const& _node) {
+		return _node->location().start <= start && end <= _node->location().end;
+	};
+
+	vector<ASTPointer<ASTNode>> const nodes = _ast.nodes();
+	auto element = find_if(nodes.begin(), nodes.end(), enclosesEdit);
+	if (element == nodes.end())
+		return false;
+	ASTNode* replaced = element->get();
+	ContractDefinition* contract = dynamic_cast<ContractDefinition*>(replaced);
+	auto subNode = contract ?
+		find_if(contract->subNodes().begin(), contract->subNodes().end(), enclosesEdit) :
+		nodes.end();
+	bool const inContract = contract && subNode != contract->subNodes().end();
+	if (inContract)
+		replaced = subNode->get();
+	SourceLocation const previousLocation = replaced->location();
+
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	ASTNode::resetID(m_lastNodeID);
+	_source.scanner->setPosition(size_t(previousLocation.start));
+	ASTPointer<ASTNode> newElement = Parser(errorReporter, m_evmVersion).parseElement(
+		_source.scanner,
+		inContract,
+		_source.arena.get()
+	);
+	m_lastNodeID = ASTNode::lastID();
+	// The element has to end where the edited one ended, otherwise it consumed tokens
+	// of the following elements or missed some of its own.
+	if (
+		!newElement ||
+		!errors.empty() ||
+		newElement->location().start != previousLocation.start ||
+		newElement->location().end != previousLocation.end + delta
+	)
+		return false;
+
+	// All other nodes are kept, but move behind the edit and have to be analysed again.
+	KeptNodesUpdater updater(*replaced, previousLocation.end, delta);
+	_ast.accept(updater);
+	if (inContract)
+		contract->replaceSubNode(size_t(subNode - contract->subNodes().begin()), newElement);
+	else
+		_ast.replaceNode(size_t(element - nodes.begin()), newElement);
+	return true;
+}
+
+set<string> CompilerStack::invalidateSources(set<string> const& _changedSources)
+{
+	// All sources that (transitively) import a changed source are affected as well.
+	set<string> affected = _changedSources;
+	map<string, set<string>> importers;
+	for (auto const& source: m_sources)
+		if (m_hasError || !source.second.ast)
+			affected.insert(source.first);
+		else
+			for (auto const* import: ASTNode::filteredNodes<ImportDirective>(source.second.ast->nodes()))
+				importers[import->annotation().absolutePath].insert(source.first);
+	vector<string> toVisit(affected.begin(), affected.end());
+	while (!toVisit.empty())
+	{
+		string path = toVisit.back();
+		toVisit.pop_back();
+		for (string const& importer: importers[path])
+			if (affected.insert(importer).second)
+				toVisit.push_back(importer);
+	}
+
+	// Drop everything that refers to the ASTs of the affected sources.
+	set<ASTNode const*> removedNodes;
+	SimpleASTVisitor collector(
+		[&](ASTNode const& _node)
+		{
+			removedNodes.insert(&_node);
+			if (auto contract = dynamic_cast<ContractDefinition const*>(&_node))
+				if (m_globalContext)
+					m_globalContext->removeContract(*contract);
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	for (string const& path: affected)
+		if (m_sources.count(path) && m_sources[path].ast)
+			m_sources[path].ast->accept(collector);
+	for (auto it = m_scopes.begin(); it != m_scopes.end();)
+		if (removedNodes.count(it->first))
+			it = m_scopes.erase(it);
+		else
+			++it;
+	m_contracts.clear();
+	TypeProvider::removeTypesReferringTo(removedNodes);
+
+	m_unaffectedErrors.clear();
+	for (auto const& error: m_errorReporter.errors())
+		if (SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error))
+			if (location->source && !affected.count(location->source->name()))
+				m_unaffectedErrors.push_back(error);
+	m_errorReporter.clear();
+
+	for (string const& path: affected)
+	{
+		Source& source = m_sources[path];
+		source.ast.reset();
+		source.arena.reset();
+		source.analysed = false;
+		source.documentationAnalysed = false;
+		source.edited = false;
+	}
+
+	m_sourceOrder.clear();
+	m_hasError = false;
+	return affected;
+}
+
+void CompilerStack::addEncodedAST(string const& _encodedAST)
+{
+	if (m_stackState > SourcesSet)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must add sources before parsing."));
+	string name;
+	string content;
+	try
+	{
+		name = ASTBinaryReader::sourceName(_encodedAST);
+		content = ASTBinaryReader::sourceContent(_encodedAST);
+	}
+	catch (ASTBinaryError const& _error)
+	{
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment(*boost::get_error_info<errinfo_comment>(_error)));
+	}
+	Source& source = m_sources[name];
+	source.reset();
+	source.scanner = make_shared<Scanner>(CharStream(std::move(content), name));
+	source.encodedAST = _encodedAST;
 	m_stackState = SourcesSet;
 }
 
@@ -229,36 +619,98 @@ bool CompilerStack::parse()
 {
 	if (m_stackState != SourcesSet)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must call parse only after the SourcesSet state."));
+	solAssert(&TypeProvider::instance() == m_typeProvider, "Compiler stack used with another type provider.");
+	m_statistics = StatisticsCollector{};
+	for (auto& contract: m_contracts)
+		contract.second.statistics = StatisticsCollector{};
+	ScopedStatisticsCollector collector(statisticsCollector());
+	ScopedPhase phase("parsing");
 	m_errorReporter.clear();
-	ASTNode::resetID();
+	// Sources kept by updateSources() still use their node IDs and types kept by the type provider
+	// are identified by them, so IDs are only reused after reset(). The IDs are dispensed per thread
+	// and the previous run might have been on a different thread.
+	ASTNode::resetID(m_lastNodeID);
 
 	if (SemVerVersion{string(VersionString)}.isPrerelease())
 		m_errorReporter.warning("This is a pre-release compiler version, please do not use it in production.");
+	m_errorReporter.append(m_unaffectedErrors);
+
+	// Sources edited in place keep their AST, but its annotations were reset.
+	for (auto& s: m_sources)
+		if (s.second.ast && s.second.edited)
+		{
+			string const& path = s.first;
+			s.second.edited = false;
+			s.second.ast->annotation().path = path;
+			for (auto& newSource: loadMissingSources(*s.second.ast, path, m_readFile))
+				m_sources[newSource.first].scanner = make_shared<Scanner>(CharStream(std::move(newSource.second), newSource.first));
+		}
+
+	// Encoded sources are recreated first, the sources they import are parsed with the others.
+	for (auto& s: m_sources)
+		if (!s.second.ast && !s.second.encodedAST.empty())
+		{
+			string const& path = s.first;
+			Source& source = s.second;
+			source.arena = make_unique<ASTArena>();
+			try
+			{
+				source.ast = ASTBinaryReader::read(source.encodedAST, source.scanner, m_evmVersion, source.arena.get());
+			}
+			catch (ASTBinaryError const& _error)
+			{
+				m_errorReporter.parserError(
+					SourceLocation{-1, -1, source.scanner->charStream()},
+					"Invalid encoded AST: " + *boost::get_error_info<errinfo_comment>(_error)
+				);
+				continue;
+			}
+			source.ast->annotation().path = path;
+			for (auto& newSource: loadMissingSources(*source.ast, path, m_readFile))
+				m_sources[newSource.first].scanner = make_shared<Scanner>(CharStream(std::move(newSource.second), newSource.first));
+		}
 
 	vector<string> sourcesToParse;
 	for (auto const& s: m_sources)
-		sourcesToParse.push_back(s.first);
-	for (size_t i = 0; i < sourcesToParse.size(); ++i)
-	{
-		string const& path = sourcesToParse[i];
-		Source& source = m_sources[path];
-		source.scanner->reset();
-		source.ast = Parser(m_errorReporter, m_evmVersion, m_parserErrorRecovery).parse(source.scanner);
-		if (!source.ast)
-			solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
-		else
+		if (!s.second.ast && s.second.encodedAST.empty())
+			sourcesToParse.push_back(s.first);
+	if (m_parallelism > 1)
+		parseInParallel(sourcesToParse);
+	else
+		for (size_t i = 0; i < sourcesToParse.size(); ++i)
 		{
-			source.ast->annotation().path = path;
-			for (auto const& newSource: loadMissingSources(*source.ast, path))
+			string const& path = sourcesToParse[i];
+			Source& source = m_sources[path];
+			source.scanner->reset();
+			source.arena = make_unique<ASTArena>();
+			size_t const previousErrors = m_errorReporter.errors().size();
+			source.ast = Parser(m_errorReporter, m_evmVersion, m_parserErrorRecovery).parse(source.scanner, source.arena.get());
+			source.cleanlyParsed = source.ast && m_errorReporter.errors().size() == previousErrors;
+			if (!source.ast)
+				solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
+			else
 			{
-				string const& newPath = newSource.first;
-				string const& newContents = newSource.second;
-				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(newContents, newPath));
-				sourcesToParse.push_back(newPath);
+				source.ast->annotation().path = path;
+				for (auto& newSource: loadMissingSources(*source.ast, path, m_readFile))
+				{
+					string const& newPath = newSource.first;
+					m_sources[newPath].scanner = make_shared<Scanner>(CharStream(std::move(newSource.second), newPath));
+					sourcesToParse.push_back(newPath);
+				}
 			}
 		}
+
+	if (m_statisticsEnabled)
+	{
+		size_t nodes = 0;
+		SimpleASTVisitor counter([&](ASTNode const&) { ++nodes; return true; }, [](ASTNode const&) {});
+		for (auto const& source: m_sources)
+			if (source.second.ast)
+				source.second.ast->accept(counter);
+		m_statistics.counters["astNodes"] = nodes;
 	}
 
+	m_lastNodeID = ASTNode::lastID();
 	m_stackState = ParsingPerformed;
 	if (!Error::containsOnlyWarnings(m_errorReporter.errors()))
 		m_hasError = true;
@@ -269,58 +721,111 @@ bool CompilerStack::analyze()
 {
 	if (m_stackState != ParsingPerformed || m_stackState >= AnalysisPerformed)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Must call analyze only after parsing was performed."));
+	solAssert(&TypeProvider::instance() == m_typeProvider, "Compiler stack used with another type provider.");
+	ScopedStatisticsCollector collector(statisticsCollector());
+	ScopedPhase phase("analysis");
 	resolveImports();
+	if (!m_globalContext)
+		m_globalContext = make_shared<GlobalContext>();
+
+	// Sources kept by updateSources() have already been analysed and their declarations registered.
+	vector<Source const*> sourcesToRegister;
+	for (Source const* source: m_sourceOrder)
+		if (!source->analysed)
+			sourcesToRegister.push_back(source);
+
+	// Encoded sources whose imports did not change get the annotations of their previous analysis.
+	optional<ASTBinaryContext> context;
+	for (auto& s: m_sources)
+	{
+		Source& source = s.second;
+		if (!source.analysed && source.ast && !source.encodedAST.empty() && contains(m_sourceOrder, &source))
+			try
+			{
+				if (!context)
+				{
+					context = encodedASTContext();
+					// Annotations can refer to "this" and "super", which are created in the order
+					// the declarations are registered to give them the same IDs as without loading.
+					for (Source const* registered: sourcesToRegister)
+						if (registered->ast)
+							for (auto contract: ASTNode::filteredNodes<ContractDefinition>(registered->ast->nodes()))
+							{
+								m_globalContext->setCurrentContract(*contract);
+								m_globalContext->currentThis();
+								m_globalContext->currentSuper();
+							}
+				}
+				if (ASTBinaryReader::readAnnotations(source.encodedAST, *source.ast, *context))
+					source.analysed = true;
+			}
+			catch (ASTBinaryError const& _error)
+			{
+				m_errorReporter.parserError(
+					SourceLocation{-1, -1, source.scanner->charStream()},
+					"Invalid encoded AST: " + *boost::get_error_info<errinfo_comment>(_error)
+				);
+				m_hasError = true;
+				return false;
+			}
+	}
+
+	vector<Source const*> sourcesToAnalyse;
+	for (Source const* source: m_sourceOrder)
+		if (!source->analysed)
+			sourcesToAnalyse.push_back(source);
 
 	bool noErrors = true;
 
 	try
 	{
 		SyntaxChecker syntaxChecker(m_errorReporter, m_optimiserSettings.runYulOptimiser);
-		for (Source const* source: m_sourceOrder)
+		for (Source const* source: sourcesToAnalyse)
 			if (source->ast && !syntaxChecker.checkSyntax(*source->ast))
 				noErrors = false;
 
-		DocStringAnalyser docStringAnalyser(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !docStringAnalyser.analyseDocStrings(*source->ast))
-				noErrors = false;
-
-		m_globalContext = make_shared<GlobalContext>();
-		NameAndTypeResolver resolver(*m_globalContext, m_evmVersion, m_scopes, m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !resolver.registerDeclarations(*source->ast))
-				return false;
-
-		map<string, SourceUnit const*> sourceUnitsByName;
-		for (auto& source: m_sources)
-			sourceUnitsByName[source.first] = source.second.ast.get();
-		for (Source const* source: m_sourceOrder)
-			if (source->ast && !resolver.performImports(*source->ast, sourceUnitsByName))
-				return false;
+		// This includes sources kept from a previous run that did not analyse documentation.
+		if (m_documentationAnalysis && !analyseDocumentation(m_errorReporter))
+			noErrors = false;
 
-		// This is the main name and type resolution loop. Needs to be run for every contract, because
-		// the special variables "this" and "super" must be set appropriately.
-		for (Source const* source: m_sourceOrder)
-			if (source->ast)
-				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-				{
-					if (!resolver.resolveNamesAndTypes(*node))
-						return false;
-					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-						// Note that we now reference contracts by their fully qualified names, and
-						// thus contracts can only conflict if declared in the same source file.  This
-						// already causes a double-declaration error elsewhere, so we do not report
-						// an error here and instead silently drop any additional contracts we find.
-						if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
-							m_contracts[contract->fullyQualifiedName()].contract = contract;
-				}
+		{
+			ScopedPhase nameResolutionPhase("nameResolution");
+			NameAndTypeResolver resolver(*m_globalContext, m_evmVersion, m_scopes, m_errorReporter);
+			for (Source const* source: sourcesToRegister)
+				if (source->ast && !resolver.registerDeclarations(*source->ast))
+					return false;
+
+			map<string, SourceUnit const*> sourceUnitsByName;
+			for (auto& source: m_sources)
+				sourceUnitsByName[source.first] = source.second.ast.get();
+			for (Source const* source: sourcesToRegister)
+				if (source->ast && !resolver.performImports(*source->ast, sourceUnitsByName))
+					return false;
+
+			// This is the main name and type resolution loop. Needs to be run for every contract, because
+			// the special variables "this" and "super" must be set appropriately.
+			for (Source const* source: m_sourceOrder)
+				if (source->ast)
+					for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+					{
+						if (!source->analysed && !resolver.resolveNamesAndTypes(*node))
+							return false;
+						if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+							// Note that we now reference contracts by their fully qualified names, and
+							// thus contracts can only conflict if declared in the same source file.  This
+							// already causes a double-declaration error elsewhere, so we do not report
+							// an error here and instead silently drop any additional contracts we find.
+							if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
+								m_contracts[contract->fullyQualifiedName()].contract = contract;
+					}
+		}
 
 		// Next, we check inheritance, overrides, function collisions and other things at
 		// contract or function level.
 		// This also calculates whether a contract is abstract, which is needed by the
 		// type checker.
 		ContractLevelChecker contractLevelChecker(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
+		for (Source const* source: sourcesToAnalyse)
 			if (source->ast)
 				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
@@ -334,69 +839,113 @@ bool CompilerStack::analyze()
 		//
 		// Note: this does not resolve overloaded functions. In order to do that, types of arguments are needed,
 		// which is only done one step later.
-		TypeChecker typeChecker(m_evmVersion, m_errorReporter);
-		for (Source const* source: m_sourceOrder)
-			if (source->ast)
-				for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-					if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-						if (!typeChecker.checkTypeRequirements(*contract))
-							noErrors = false;
-
-		if (noErrors)
 		{
-			// Checks that can only be done when all types of all AST nodes are known.
-			PostTypeChecker postTypeChecker(m_errorReporter);
-			for (Source const* source: m_sourceOrder)
-				if (source->ast && !postTypeChecker.check(*source->ast))
-					noErrors = false;
+			ScopedPhase typeCheckingPhase("typeChecking");
+			TypeChecker typeChecker(m_evmVersion, m_errorReporter);
+			for (Source const* source: sourcesToAnalyse)
+				if (source->ast)
+					for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+						if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
+							if (!typeChecker.checkTypeRequirements(*contract))
+								noErrors = false;
 		}
 
 		if (noErrors)
 		{
+			// The following checks are independent of each other and share a single traversal
+			// of the AST. Their errors are collected separately and reported as if they ran one
+			// after the other, each of them only if the previous ones did not find any errors.
+			// A check is not run anymore as soon as one of the previous checks finds an error.
+			ErrorList postTypeCheckErrors;
+			ErrorList controlFlowErrors;
+			ErrorList staticAnalysisErrors;
+			ErrorReporter postTypeCheckReporter(postTypeCheckErrors);
+			ErrorReporter controlFlowReporter(controlFlowErrors);
+			ErrorReporter staticAnalysisReporter(staticAnalysisErrors);
+
+			// Checks that can only be done when all types of all AST nodes are known.
+			PostTypeChecker postTypeChecker(postTypeCheckReporter);
 			// Control flow graph generator and analyzer. It can check for issues such as
-			// variable is used before it is assigned to.
-			CFG cfg(m_errorReporter);
-			for (Source const* source: m_sourceOrder)
-				if (source->ast && !cfg.constructFlow(*source->ast))
-					noErrors = false;
+			// variable is used before it is assigned to. The analyzer visits each function
+			// after its flow was constructed.
+			CFG cfg(controlFlowReporter);
+			ControlFlowAnalyzer controlFlowAnalyzer(cfg, controlFlowReporter);
+			// Checks for common mistakes. Only generates warnings.
+			StaticAnalyzer staticAnalyzer(staticAnalysisReporter);
 
-			if (noErrors)
+			CompositeASTConstVisitor checkers(
+				{&postTypeChecker, &cfg, &controlFlowAnalyzer, &staticAnalyzer},
+				[&]() -> size_t
+				{
+					if (postTypeCheckReporter.hasErrors())
+						return 1;
+					if (controlFlowReporter.hasErrors())
+						return 3;
+					return 4;
+				}
+			);
+			auto reportErrors = [&]()
 			{
-				ControlFlowAnalyzer controlFlowAnalyzer(cfg, m_errorReporter);
-				for (Source const* source: m_sourceOrder)
-					if (source->ast && !controlFlowAnalyzer.analyze(*source->ast))
-						noErrors = false;
+				for (ErrorList const* errors: {&postTypeCheckErrors, &controlFlowErrors, &staticAnalysisErrors})
+				{
+					m_errorReporter.append(*errors);
+					if (!Error::containsOnlyWarnings(*errors))
+						return false;
+				}
+				return true;
+			};
+			try
+			{
+				for (Source const* source: sourcesToAnalyse)
+					if (source->ast)
+						source->ast->accept(checkers);
 			}
-		}
-
-		if (noErrors)
-		{
-			// Checks for common mistakes. Only generates warnings.
-			StaticAnalyzer staticAnalyzer(m_errorReporter);
-			for (Source const* source: m_sourceOrder)
-				if (source->ast && !staticAnalyzer.analyze(*source->ast))
-					noErrors = false;
+			catch (FatalError const&)
+			{
+				reportErrors();
+				throw;
+			}
+			noErrors = reportErrors();
 		}
 
 		if (noErrors)
 		{
 			// Check for state mutability in every function.
+			// The modifiers of all sources are needed to infer the mutability,
+			// but only the errors of the sources to analyse are reported.
 			vector<ASTPointer<ASTNode>> ast;
 			for (Source const* source: m_sourceOrder)
 				if (source->ast)
 					ast.push_back(source->ast);
 
-			if (!ViewPureChecker(ast, m_errorReporter).check())
-				noErrors = false;
+			ErrorList viewPureErrors;
+			ErrorReporter viewPureErrorReporter(viewPureErrors);
+			ViewPureChecker(ast, viewPureErrorReporter).check();
+			for (auto const& error: viewPureErrors)
+			{
+				SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+				if (location && location->source)
+				{
+					auto source = m_sources.find(location->source->name());
+					if (source != m_sources.end() && source->second.analysed)
+						continue;
+				}
+				m_errorReporter.append({error});
+				if (error->type() != Error::Type::Warning)
+					noErrors = false;
+			}
 		}
 
 		if (noErrors)
 		{
+			ScopedPhase smtCheckingPhase("smtChecking");
 			ModelChecker modelChecker(m_errorReporter, m_smtlib2Responses, m_readFile, m_enabledSMTSolvers);
-			for (Source const* source: m_sourceOrder)
+			for (Source const* source: sourcesToAnalyse)
 				if (source->ast)
 					modelChecker.analyze(*source->ast);
-			m_unhandledSMTLib2Queries += modelChecker.unhandledQueries();
+			for (string const& query: modelChecker.unhandledQueries())
+				if (!contains(m_unhandledSMTLib2Queries, query))
+					m_unhandledSMTLib2Queries.push_back(query);
 		}
 	}
 	catch (FatalError const&)
@@ -406,9 +955,14 @@ bool CompilerStack::analyze()
 		noErrors = false;
 	}
 
+	updateStatisticsCounters();
 	m_stackState = AnalysisPerformed;
 	if (!noErrors)
 		m_hasError = true;
+	else
+		for (auto& source: m_sources)
+			if (contains(m_sourceOrder, &source.second))
+				source.second.analysed = true;
 
 	return !m_hasError;
 }
@@ -446,8 +1000,24 @@ bool CompilerStack::isRequestedContract(ContractDefinition const& _contract) con
 	return false;
 }
 
+CompilerStack::PipelineConfig CompilerStack::pipelineConfig(ContractDefinition const& _contract) const
+{
+	if (!m_contractPipelines)
+	{
+		if (!isRequestedContract(_contract))
+			return {};
+		return {true, m_generateIR || m_generateEwasm, m_generateEwasm};
+	}
+
+	auto it = m_contractPipelines->find(_contract.fullyQualifiedName());
+	if (it == m_contractPipelines->end())
+		return {};
+	return it->second;
+}
+
 bool CompilerStack::compile()
 {
+	solAssert(&TypeProvider::instance() == m_typeProvider, "Compiler stack used with another type provider.");
 	if (m_stackState < AnalysisPerformed)
 		if (!parseAndAnalyze())
 			return false;
@@ -455,24 +1025,169 @@ bool CompilerStack::compile()
 	if (m_hasError)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Called compile with errors."));
 
-	// Only compile contracts individually which have been requested.
-	map<ContractDefinition const*, shared_ptr<Compiler const>> otherCompilers;
+	ScopedStatisticsCollector collector(statisticsCollector());
+	ScopedPhase phase("compilation");
+
+	// Only compile contracts individually for which any stage has been requested.
+	vector<ContractDefinition const*> requestedContracts;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
-				if (isRequestedContract(*contract))
-				{
-					compileContract(*contract, otherCompilers);
-					if (m_generateIR || m_generateEwasm)
-						generateIR(*contract);
-					if (m_generateEwasm)
-						generateEwasm(*contract);
-				}
+				if (!pipelineConfig(*contract).empty())
+					requestedContracts.push_back(contract);
+
+	if (!m_cacheDirectory.empty())
+		requestedContracts = loadCachedArtifacts(requestedContracts);
+
+	// The metadata contains the NatSpec output. Parse the documentation before the contracts
+	// are compiled, possibly in parallel.
+	parseRemainingDocumentation();
+
+	if (m_parallelism > 1 && requestedContracts.size() > 1)
+		compileContractsInParallel(requestedContracts);
+	else
+		compileContracts(requestedContracts);
+
+	updateStatisticsCounters();
 	m_stackState = CompilationSuccessful;
+	if (!m_cacheDirectory.empty())
+		storeCachedArtifacts(contractNames(), sourceCodes());
 	this->link();
 	return true;
 }
 
+bool CompilerStack::compile(vector<string> const& _contractNames, ContractCallback const& _compiled)
+{
+	solAssert(&TypeProvider::instance() == m_typeProvider, "Compiler stack used with another type provider.");
+	if (m_stackState < AnalysisPerformed)
+		if (!parseAndAnalyze())
+			return false;
+
+	if (m_hasError)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Called compile with errors."));
+
+	set<string> const listed(_contractNames.begin(), _contractNames.end());
+	vector<ContractDefinition const*> requestedContracts;
+	for (Source const* source: m_sourceOrder)
+		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+				if (listed.count(contract->fullyQualifiedName()) && !pipelineConfig(*contract).empty())
+					requestedContracts.push_back(contract);
+
+	// Contracts that share a dependency are compiled together, in the same order as by compile(),
+	// such that their outputs do not depend on which contract is requested first.
+	vector<vector<size_t>> groups = dependencyGroups(requestedContracts);
+	map<string, size_t> groupOf;
+	for (size_t g = 0; g < groups.size(); ++g)
+		for (size_t index: groups[g])
+			groupOf[requestedContracts[index]->fullyQualifiedName()] = g;
+	vector<bool> groupCompiled(groups.size(), false);
+
+	parseRemainingDocumentation();
+	StringMap const cacheSourceCodes = m_cacheDirectory.empty() ? StringMap{} : sourceCodes();
+
+	// The accessors of the outputs require this state. It is reset if the compilation fails.
+	m_stackState = CompilationSuccessful;
+	try
+	{
+		for (string const& contractName: _contractNames)
+		{
+			auto groupIt = groupOf.find(contractName);
+			if (groupIt != groupOf.end() && !groupCompiled[groupIt->second])
+			{
+				groupCompiled[groupIt->second] = true;
+				vector<ContractDefinition const*> group;
+				vector<string> groupNames;
+				for (size_t index: groups[groupIt->second])
+				{
+					group.push_back(requestedContracts[index]);
+					groupNames.push_back(requestedContracts[index]->fullyQualifiedName());
+				}
+				{
+					ScopedStatisticsCollector collector(statisticsCollector());
+					ScopedPhase phase("compilation");
+					compileContracts(m_cacheDirectory.empty() ? group : loadCachedArtifacts(group));
+				}
+				if (!m_cacheDirectory.empty())
+					storeCachedArtifacts(groupNames, cacheSourceCodes);
+				// Created contracts that are not part of the group are only needed for compiling it.
+				for (auto& contract: m_contracts)
+					if (contract.second.compiler && !groupOf.count(contract.first))
+						contract.second.releaseGeneratedCode();
+			}
+
+			Contract& contract = m_contracts.at(contractName);
+			contract.object.link(m_libraries);
+			contract.runtimeObject.link(m_libraries);
+			_compiled(contractName);
+			contract.releaseGeneratedCode();
+		}
+	}
+	catch (...)
+	{
+		m_stackState = AnalysisPerformed;
+		throw;
+	}
+
+	updateStatisticsCounters();
+	return true;
+}
+
+void CompilerStack::Contract::releaseGeneratedCode()
+{
+	compiler.reset();
+	object = {};
+	runtimeObject = {};
+	// Assigning an empty string would keep the capacity.
+	string().swap(yulIR);
+	string().swap(yulIROptimized);
+	string().swap(ewasm);
+	ewasmObject = {};
+	metadata.reset();
+	abi.reset();
+	storageLayout.reset();
+	userDocumentation.reset();
+	devDocumentation.reset();
+	sourceMapping.reset();
+	runtimeSourceMapping.reset();
+	cachedArtifacts.reset();
+}
+
+Json::Value CompilerStack::statistics() const
+{
+	if (!m_statisticsEnabled)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Statistics were not enabled."));
+
+	StatisticsCollector total = m_statistics;
+	Json::Value contracts(Json::objectValue);
+	for (auto const& contract: m_contracts)
+		if (contract.second.contract && (!contract.second.statistics.phases.empty() || !contract.second.statistics.counters.empty()))
+		{
+			total.merge(contract.second.statistics);
+			contracts[contract.second.contract->sourceUnitName()][contract.second.contract->name()] =
+				contract.second.statistics.toJson();
+		}
+
+	Json::Value ret = total.toJson();
+	ret["contracts"] = std::move(contracts);
+	return ret;
+}
+
+StatisticsCollector* CompilerStack::statisticsCollector(Contract* _contract)
+{
+	if (!m_statisticsEnabled)
+		return nullptr;
+	return _contract ? &_contract->statistics : &m_statistics;
+}
+
+void CompilerStack::updateStatisticsCounters()
+{
+	if (!m_statisticsEnabled)
+		return;
+	m_statistics.counters["types"] = TypeProvider::typeCount();
+	m_statistics.counters["yulStrings"] = yul::YulStringRepository::instance().size();
+}
+
 void CompilerStack::link()
 {
 	solAssert(m_stackState >= CompilationSuccessful, "");
@@ -633,6 +1348,8 @@ string CompilerStack::assemblyString(string const& _contractName, StringMap _sou
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
 		return currentContract.compiler->assemblyString(_sourceCodes);
+	else if (currentContract.cachedArtifacts)
+		return (*currentContract.cachedArtifacts)["assembly"].asString();
 	else
 		return string();
 }
@@ -646,6 +1363,8 @@ Json::Value CompilerStack::assemblyJSON(string const& _contractName, StringMap c
 	Contract const& currentContract = contract(_contractName);
 	if (currentContract.compiler)
 		return currentContract.compiler->assemblyJSON(_sourceCodes);
+	else if (currentContract.cachedArtifacts)
+		return (*currentContract.cachedArtifacts)["legacyAssembly"];
 	else
 		return Json::Value();
 }
@@ -728,7 +1447,10 @@ Json::Value const& CompilerStack::natspecUser(Contract const& _contract) const
 
 	// caches the result
 	if (!_contract.userDocumentation)
+	{
+		parseRemainingDocumentation();
 		_contract.userDocumentation = make_unique<Json::Value>(Natspec::userDocumentation(*_contract.contract));
+	}
 
 	return *_contract.userDocumentation;
 }
@@ -750,11 +1472,35 @@ Json::Value const& CompilerStack::natspecDev(Contract const& _contract) const
 
 	// caches the result
 	if (!_contract.devDocumentation)
+	{
+		parseRemainingDocumentation();
 		_contract.devDocumentation = make_unique<Json::Value>(Natspec::devDocumentation(*_contract.contract));
+	}
 
 	return *_contract.devDocumentation;
 }
 
+bool CompilerStack::analyseDocumentation(ErrorReporter& _errorReporter) const
+{
+	bool noErrors = true;
+	DocStringAnalyser docStringAnalyser(_errorReporter);
+	for (Source const* source: m_sourceOrder)
+		if (source->ast && !source->documentationAnalysed)
+		{
+			if (!docStringAnalyser.analyseDocStrings(*source->ast))
+				noErrors = false;
+			source->documentationAnalysed = true;
+		}
+	return noErrors;
+}
+
+void CompilerStack::parseRemainingDocumentation() const
+{
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	analyseDocumentation(errorReporter);
+}
+
 Json::Value CompilerStack::methodIdentifiers(string const& _contractName) const
 {
 	if (m_stackState < AnalysisPerformed)
@@ -806,6 +1552,27 @@ SourceUnit const& CompilerStack::ast(string const& _sourceName) const
 	return *source(_sourceName).ast;
 }
 
+string CompilerStack::encodedAST(string const& _sourceName) const
+{
+	SourceUnit const& sourceUnit = ast(_sourceName);
+	Source const& encodedSource = source(_sourceName);
+	if (!encodedSource.analysed)
+		return ASTBinaryWriter::write(sourceUnit, _sourceName, encodedSource.scanner->source());
+	ASTBinaryContext const context = encodedASTContext();
+	return ASTBinaryWriter::write(sourceUnit, _sourceName, encodedSource.scanner->source(), &context);
+}
+
+ASTBinaryContext CompilerStack::encodedASTContext() const
+{
+	ASTBinaryContext context;
+	context.evmVersion = m_evmVersion;
+	for (auto const& source: m_sources)
+		if (source.second.ast)
+			context.sources[source.first] = {source.second.ast.get(), source.second.keccak256()};
+	context.globalContext = m_globalContext.get();
+	return context;
+}
+
 ContractDefinition const& CompilerStack::contractDefinition(string const& _contractName) const
 {
 	if (m_stackState < AnalysisPerformed)
@@ -851,14 +1618,20 @@ tuple<int, int, int, int> CompilerStack::positionFromSourceLocation(SourceLocati
 h256 const& CompilerStack::Source::keccak256() const
 {
 	if (keccak256HashCached == h256{})
-		keccak256HashCached = dev::keccak256(scanner->source());
+	{
+		string_view const source = scanner->source();
+		keccak256HashCached = dev::keccak256(bytesConstRef(reinterpret_cast<uint8_t const*>(source.data()), source.size()));
+	}
 	return keccak256HashCached;
 }
 
 h256 const& CompilerStack::Source::swarmHash() const
 {
 	if (swarmHashCached == h256{})
-		swarmHashCached = dev::bzzr1Hash(scanner->source());
+	{
+		string_view const source = scanner->source();
+		swarmHashCached = dev::bzzr1Hash(bytes(source.begin(), source.end()));
+	}
 	return swarmHashCached;
 }
 
@@ -866,34 +1639,203 @@ string const& CompilerStack::Source::ipfsUrl() const
 {
 	if (ipfsUrlCached.empty())
 		if (scanner->source().size() < 1024 * 256)
-			ipfsUrlCached = "dweb:/ipfs/" + dev::ipfsHashBase58(scanner->source());
+			ipfsUrlCached = "dweb:/ipfs/" + dev::ipfsHashBase58(string(scanner->source()));
 	return ipfsUrlCached;
 }
 
-StringMap CompilerStack::loadMissingSources(SourceUnit const& _ast, std::string const& _sourcePath)
+void CompilerStack::parseInParallel(vector<string> const& _sourcesToParse)
+{
+	struct ParsedSource
+	{
+		shared_ptr<Scanner> scanner;
+		unique_ptr<ASTArena> arena;
+		ASTPointer<SourceUnit> ast;
+		ErrorList errors;
+		/// The nodes created while parsing and the number of IDs they used.
+		vector<ASTNode*> nodes;
+		size_t idCount = 0;
+	};
+
+	// Sources are parsed as soon as they are read and imports are read as soon as they are
+	// found. Afterwards, the sources are processed in the order of the sequential case.
+	mutex queueMutex;
+	condition_variable changed;
+	map<string, ParsedSource> parsedSources;
+	map<string, ReadCallback::Result> readResults;
+	set<string> knownPaths;
+	deque<string> toParse;
+	deque<string> toRead;
+	size_t busy = 0;
+	exception_ptr failure;
+
+	for (auto const& source: m_sources)
+		knownPaths.insert(source.first);
+	for (string const& path: _sourcesToParse)
+	{
+		parsedSources[path].scanner = m_sources.at(path).scanner;
+		toParse.push_back(path);
+	}
+
+	auto parseSource = [&](string const& _path, ParsedSource& _source)
+	{
+		ErrorReporter errorReporter(_source.errors);
+		ASTNode::resetID();
+		ASTNode::startRecording();
+		_source.scanner->reset();
+		try
+		{
+			_source.arena = make_unique<ASTArena>();
+			_source.ast = Parser(errorReporter, m_evmVersion, m_parserErrorRecovery).parse(_source.scanner, _source.arena.get());
+		}
+		catch (...)
+		{
+			ASTNode::stopRecording();
+			throw;
+		}
+		_source.nodes = ASTNode::stopRecording();
+		_source.idCount = ASTNode::lastID();
+
+		vector<string> imports;
+		if (_source.ast)
+		{
+			_source.ast->annotation().path = _path;
+			for (auto const& node: _source.ast->nodes())
+				if (auto import = dynamic_cast<ImportDirective const*>(node.get()))
+					imports.push_back(absoluteImportPath(*import, _path));
+		}
+		return imports;
+	};
+
+	auto worker = [&](bool _mayRead)
+	{
+		unique_lock<mutex> lock(queueMutex);
+		auto done = [&]() { return failure || (toParse.empty() && toRead.empty() && busy == 0); };
+		while (true)
+		{
+			changed.wait(lock, [&]() { return done() || !toParse.empty() || (_mayRead && !toRead.empty()); });
+			if (done())
+				return;
+			++busy;
+			try
+			{
+				if (_mayRead && !toRead.empty())
+				{
+					string path = std::move(toRead.front());
+					toRead.pop_front();
+					lock.unlock();
+					ReadCallback::Result result = m_readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), path);
+					lock.lock();
+					if (result.success)
+					{
+						// Only the success of reading is needed later on, the content belongs to the stream.
+						parsedSources[path].scanner = make_shared<Scanner>(CharStream(std::move(result.responseOrErrorMessage), path));
+						toParse.push_back(path);
+					}
+					readResults[path] = std::move(result);
+				}
+				else
+				{
+					string path = std::move(toParse.front());
+					toParse.pop_front();
+					ParsedSource& source = parsedSources.at(path);
+					lock.unlock();
+					vector<string> imports = parseSource(path, source);
+					lock.lock();
+					for (string const& import: imports)
+						if (knownPaths.insert(import).second)
+						{
+							if (m_readFile)
+								toRead.push_back(import);
+							else
+								readResults[import] = {false, "File not supplied initially."};
+						}
+				}
+			}
+			catch (...)
+			{
+				if (!lock.owns_lock())
+					lock.lock();
+				failure = current_exception();
+			}
+			--busy;
+			changed.notify_all();
+		}
+	};
+
+	// Unless the read callback can be called concurrently, only this thread reads files
+	// and it parses sources only if there is nothing to read.
+	size_t const initialID = ASTNode::lastID();
+	vector<thread> threads;
+	for (size_t i = 1; i < m_parallelism; ++i)
+		threads.emplace_back(startWorker(*m_typeProvider, [&]() { worker(m_concurrentReads); }));
+	worker(true);
+	for (thread& t: threads)
+		t.join();
+	if (failure)
+		rethrow_exception(failure);
+
+	size_t lastID = initialID;
+	vector<string> sourcesToParse = _sourcesToParse;
+	auto readResult = [&](string const&, string const& _path) { return readResults.at(_path); };
+	for (size_t i = 0; i < sourcesToParse.size(); ++i)
+	{
+		string const& path = sourcesToParse[i];
+		ParsedSource& parsedSource = parsedSources.at(path);
+		ASTNode::shiftIDs(parsedSource.nodes, lastID);
+		lastID += parsedSource.idCount;
+		m_errorReporter.append(parsedSource.errors);
+
+		Source& source = m_sources[path];
+		source.scanner = parsedSource.scanner;
+		source.ast.reset();
+		source.arena = std::move(parsedSource.arena);
+		source.ast = std::move(parsedSource.ast);
+		source.cleanlyParsed = source.ast && parsedSource.errors.empty();
+		if (!source.ast)
+			solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
+		else
+			for (auto const& newSource: loadMissingSources(*source.ast, path, readResult))
+			{
+				m_sources[newSource.first].scanner = parsedSources.at(newSource.first).scanner;
+				sourcesToParse.push_back(newSource.first);
+			}
+	}
+	ASTNode::resetID(lastID);
+}
+
+string CompilerStack::absoluteImportPath(ImportDirective const& _import, string const& _sourcePath)
+{
+	solAssert(!_import.path().empty(), "Import path cannot be empty.");
+
+	string importPath = dev::absolutePath(_import.path(), _sourcePath);
+	// The current value of `path` is the absolute path as seen from this source file.
+	// We first have to apply remappings before we can store the actual absolute path
+	// as seen globally.
+	return applyRemapping(importPath, _sourcePath);
+}
+
+StringMap CompilerStack::loadMissingSources(
+	SourceUnit const& _ast,
+	std::string const& _sourcePath,
+	ReadCallback::Callback const& _readFile
+)
 {
 	solAssert(m_stackState < ParsingPerformed, "");
 	StringMap newSources;
 	for (auto const& node: _ast.nodes())
 		if (ImportDirective const* import = dynamic_cast<ImportDirective*>(node.get()))
 		{
-			solAssert(!import->path().empty(), "Import path cannot be empty.");
-
-			string importPath = dev::absolutePath(import->path(), _sourcePath);
-			// The current value of `path` is the absolute path as seen from this source file.
-			// We first have to apply remappings before we can store the actual absolute path
-			// as seen globally.
-			importPath = applyRemapping(importPath, _sourcePath);
+			string importPath = absoluteImportPath(*import, _sourcePath);
 			import->annotation().absolutePath = importPath;
 			if (m_sources.count(importPath) || newSources.count(importPath))
 				continue;
 
 			ReadCallback::Result result{false, string("File not supplied initially.")};
-			if (m_readFile)
-				result = m_readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), importPath);
+			if (_readFile)
+				result = _readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), importPath);
 
 			if (result.success)
-				newSources[importPath] = result.responseOrErrorMessage;
+				newSources[importPath] = std::move(result.responseOrErrorMessage);
 			else
 			{
 				m_errorReporter.parserError(
@@ -992,6 +1934,251 @@ bool onlySafeExperimentalFeaturesActivated(set<ExperimentalFeature> const& featu
 }
 }
 
+void CompilerStack::runPipeline(
+	ContractDefinition const& _contract,
+	map<ContractDefinition const*, shared_ptr<Compiler const>>& _otherCompilers
+)
+{
+	PipelineConfig pipeline = pipelineConfig(_contract);
+	if (pipeline.bytecode)
+		compileContract(_contract, _otherCompilers);
+	if (pipeline.irCodegen || pipeline.ewasm)
+		generateIR(_contract);
+	if (pipeline.ewasm)
+		generateEwasm(_contract);
+}
+
+void CompilerStack::compileContracts(vector<ContractDefinition const*> const& _contracts)
+{
+	map<ContractDefinition const*, shared_ptr<Compiler const>> otherCompilers;
+	for (ContractDefinition const* contract: _contracts)
+		runPipeline(*contract, otherCompilers);
+}
+
+void CompilerStack::compileContractsInParallel(vector<ContractDefinition const*> const& _contracts)
+{
+	// All contracts that share a dependency are compiled by the same worker.
+	vector<vector<size_t>> groups = dependencyGroups(_contracts);
+
+	// Compute all lazily cached data that is shared between contracts upfront,
+	// so that the workers only read it.
+	SimpleASTVisitor initialiser(
+		[](ASTNode const& _node)
+		{
+			_node.annotation();
+			if (auto contract = dynamic_cast<ContractDefinition const*>(&_node))
+			{
+				contract->interfaceFunctionList();
+				contract->interfaceEvents();
+				contract->inheritableMembers();
+			}
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	for (auto const& source: m_sources)
+	{
+		source.second.keccak256();
+		if (!m_metadataLiteralSources)
+		{
+			source.second.swarmHash();
+			source.second.ipfsUrl();
+		}
+		if (source.second.ast)
+			source.second.ast->accept(initialiser);
+	}
+
+	// The exception of the contract that would have been compiled first is rethrown,
+	// which is the one the sequential compilation would have stopped at.
+	vector<pair<size_t, exception_ptr>> failures(groups.size());
+	atomic<size_t> nextGroup{0};
+	auto worker = [&]()
+	{
+		for (size_t g = nextGroup++; g < groups.size(); g = nextGroup++)
+		{
+			map<ContractDefinition const*, shared_ptr<Compiler const>> otherCompilers;
+			for (size_t index: groups[g])
+				try
+				{
+					runPipeline(*_contracts[index], otherCompilers);
+				}
+				catch (...)
+				{
+					failures[g] = {index, current_exception()};
+					break;
+				}
+		}
+	};
+
+	vector<thread> threads;
+	for (size_t i = 1; i < min<size_t>(m_parallelism, groups.size()); ++i)
+		threads.emplace_back(startWorker(*m_typeProvider, worker));
+	worker();
+	for (thread& t: threads)
+		t.join();
+
+	pair<size_t, exception_ptr> const* firstFailure = nullptr;
+	for (auto const& failure: failures)
+		if (failure.second && (!firstFailure || failure.first < firstFailure->first))
+			firstFailure = &failure;
+	if (firstFailure)
+		rethrow_exception(firstFailure->second);
+}
+
+namespace
+{
+Json::Value linkerObjectToJson(eth::LinkerObject const& _object)
+{
+	Json::Value ret(Json::objectValue);
+	ret["bytecode"] = toHex(_object.bytecode);
+	ret["linkReferences"] = Json::objectValue;
+	for (auto const& reference: _object.linkReferences)
+		ret["linkReferences"][to_string(reference.first)] = reference.second;
+	return ret;
+}
+
+std::optional<eth::LinkerObject> linkerObjectFromJson(Json::Value const& _json)
+{
+	if (!_json.isObject() || !_json["bytecode"].isString() || !_json["linkReferences"].isObject())
+		return {};
+	eth::LinkerObject object;
+	object.bytecode = fromHex(_json["bytecode"].asString());
+	for (auto const& offset: _json["linkReferences"].getMemberNames())
+	{
+		if (offset.empty() || !boost::all(offset, boost::is_digit()) || !_json["linkReferences"][offset].isString())
+			return {};
+		object.linkReferences[stoul(offset)] = _json["linkReferences"][offset].asString();
+	}
+	return object;
+}
+}
+
+h256 CompilerStack::artifactCacheKey(Contract const& _contract) const
+{
+	string key = metadata(_contract);
+	// Source indices in source mappings depend on all sources, not only on the referenced ones.
+	for (auto const& source: m_sources)
+		key += "\n" + source.first;
+	PipelineConfig pipeline = pipelineConfig(*_contract.contract);
+	key += "\n" + to_string(pipeline.irCodegen || pipeline.ewasm) + to_string(pipeline.ewasm);
+	return dev::keccak256(key);
+}
+
+vector<ContractDefinition const*> CompilerStack::loadCachedArtifacts(vector<ContractDefinition const*> const& _contracts)
+{
+	ArtifactCache cache(m_cacheDirectory);
+	map<ContractDefinition const*, Json::Value> cached;
+	for (ContractDefinition const* contract: _contracts)
+		if (contract->canBeDeployed() && pipelineConfig(*contract).bytecode)
+			if (auto artifacts = cache.load(artifactCacheKey(m_contracts.at(contract->fullyQualifiedName()))))
+				cached[contract] = std::move(*artifacts);
+
+	// Contracts that have to be compiled need the compilers of all contracts they create.
+	set<ContractDefinition const*> needed;
+	vector<ContractDefinition const*> toVisit;
+	for (ContractDefinition const* contract: _contracts)
+		if (!cached.count(contract) && pipelineConfig(*contract).bytecode)
+			toVisit.push_back(contract);
+	while (!toVisit.empty())
+	{
+		ContractDefinition const* contract = toVisit.back();
+		toVisit.pop_back();
+		if (!needed.insert(contract).second)
+			continue;
+		for (auto const* dependency: contract->annotation().contractDependencies)
+			toVisit.push_back(dependency);
+	}
+
+	vector<ContractDefinition const*> remaining;
+	for (ContractDefinition const* contract: _contracts)
+	{
+		if (needed.count(contract) || !cached.count(contract))
+		{
+			remaining.push_back(contract);
+			continue;
+		}
+		Json::Value& artifacts = cached.at(contract);
+		PipelineConfig pipeline = pipelineConfig(*contract);
+		auto object = linkerObjectFromJson(artifacts["bytecode"]);
+		auto runtimeObject = linkerObjectFromJson(artifacts["deployedBytecode"]);
+		bool valid =
+			artifacts["compilerVersion"] == VersionStringStrict &&
+			object && runtimeObject &&
+			artifacts["sourceMap"].isString() &&
+			artifacts["deployedSourceMap"].isString() &&
+			artifacts["assembly"].isString() &&
+			(!(pipeline.irCodegen || pipeline.ewasm) || (artifacts["ir"].isString() && artifacts["irOptimized"].isString())) &&
+			(!pipeline.ewasm || (artifacts["ewasm"].isString() && linkerObjectFromJson(artifacts["ewasmObject"])));
+		if (!valid)
+		{
+			remaining.push_back(contract);
+			continue;
+		}
+
+		Contract& compiledContract = m_contracts.at(contract->fullyQualifiedName());
+		compiledContract.object = std::move(*object);
+		compiledContract.runtimeObject = std::move(*runtimeObject);
+		compiledContract.sourceMapping = make_unique<string const>(artifacts["sourceMap"].asString());
+		compiledContract.runtimeSourceMapping = make_unique<string const>(artifacts["deployedSourceMap"].asString());
+		if (pipeline.irCodegen || pipeline.ewasm)
+		{
+			compiledContract.yulIR = artifacts["ir"].asString();
+			compiledContract.yulIROptimized = artifacts["irOptimized"].asString();
+		}
+		if (pipeline.ewasm)
+		{
+			compiledContract.ewasm = artifacts["ewasm"].asString();
+			compiledContract.ewasmObject = *linkerObjectFromJson(artifacts["ewasmObject"]);
+		}
+		compiledContract.cachedArtifacts = std::move(artifacts);
+	}
+	return remaining;
+}
+
+StringMap CompilerStack::sourceCodes() const
+{
+	StringMap sourceCodes;
+	for (auto const& source: m_sources)
+		sourceCodes[source.first] = string(source.second.scanner->source());
+	return sourceCodes;
+}
+
+void CompilerStack::storeCachedArtifacts(vector<string> const& _contractNames, StringMap const& _sourceCodes)
+{
+	solAssert(m_stackState >= CompilationSuccessful, "");
+
+	ArtifactCache cache(m_cacheDirectory);
+	for (string const& contractName: _contractNames)
+	{
+		Contract const& contract = m_contracts.at(contractName);
+		if (!contract.compiler)
+			continue;
+
+		Json::Value artifacts(Json::objectValue);
+		// The version is part of the key already, this guards against entries of other builds.
+		artifacts["compilerVersion"] = VersionStringStrict;
+		artifacts["bytecode"] = linkerObjectToJson(contract.object);
+		artifacts["deployedBytecode"] = linkerObjectToJson(contract.runtimeObject);
+		artifacts["sourceMap"] = *sourceMapping(contractName);
+		artifacts["deployedSourceMap"] = *runtimeSourceMapping(contractName);
+		artifacts["assembly"] = contract.compiler->assemblyString(_sourceCodes);
+		artifacts["legacyAssembly"] = contract.compiler->assemblyJSON(_sourceCodes);
+		artifacts["gasEstimates"] = gasEstimates(contractName);
+		PipelineConfig pipeline = pipelineConfig(*contract.contract);
+		if (pipeline.irCodegen || pipeline.ewasm)
+		{
+			artifacts["ir"] = contract.yulIR;
+			artifacts["irOptimized"] = contract.yulIROptimized;
+		}
+		if (pipeline.ewasm)
+		{
+			artifacts["ewasm"] = contract.ewasm;
+			artifacts["ewasmObject"] = linkerObjectToJson(contract.ewasmObject);
+		}
+		cache.store(artifactCacheKey(contract), artifacts);
+	}
+}
+
 void CompilerStack::compileContract(
 	ContractDefinition const& _contract,
 	map<ContractDefinition const*, shared_ptr<Compiler const>>& _otherCompilers
@@ -1007,6 +2194,7 @@ void CompilerStack::compileContract(
 		compileContract(*dependency, _otherCompilers);
 
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
+	ScopedStatisticsCollector collector(statisticsCollector(&compiledContract));
 
 	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_revertStrings, m_optimiserSettings);
 	compiledContract.compiler = compiler;
@@ -1019,6 +2207,7 @@ void CompilerStack::compileContract(
 	try
 	{
 		// Run optimiser and compile the contract.
+		ScopedPhase phase("codegen");
 		compiler->compileContract(_contract, _otherCompilers, cborEncodedMetadata);
 	}
 	catch(eth::OptimizerException const&)
@@ -1026,6 +2215,7 @@ void CompilerStack::compileContract(
 		solAssert(false, "Optimizer exception during compilation");
 	}
 
+	ScopedPhase phase("assembly");
 	try
 	{
 		// Assemble deployment (incl. runtime)  object.
@@ -1065,6 +2255,8 @@ void CompilerStack::generateIR(ContractDefinition const& _contract)
 	for (auto const* dependency: _contract.annotation().contractDependencies)
 		generateIR(*dependency);
 
+	ScopedStatisticsCollector collector(statisticsCollector(&compiledContract));
+	ScopedPhase phase("irGeneration");
 	IRGenerator generator(m_evmVersion, m_optimiserSettings);
 	tie(compiledContract.yulIR, compiledContract.yulIROptimized) = generator.run(_contract);
 }
@@ -1080,6 +2272,9 @@ void CompilerStack::generateEwasm(ContractDefinition const& _contract)
 	if (!compiledContract.ewasm.empty())
 		return;
 
+	ScopedStatisticsCollector collector(statisticsCollector(&compiledContract));
+	ScopedPhase phase("ewasmGeneration");
+
 	// Re-parse the Yul IR in EVM dialect
 	yul::AssemblyStack stack(m_evmVersion, yul::AssemblyStack::Language::StrictAssembly, m_optimiserSettings);
 	stack.parseAndAnalyze("", compiledContract.yulIROptimized);
@@ -1158,7 +2353,7 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 		solAssert(s.second.scanner, "Scanner not available");
 		meta["sources"][s.first]["keccak256"] = "0x" + toHex(s.second.keccak256().asBytes());
 		if (m_metadataLiteralSources)
-			meta["sources"][s.first]["content"] = s.second.scanner->source();
+			meta["sources"][s.first]["content"] = string(s.second.scanner->source());
 		else
 		{
 			meta["sources"][s.first]["urls"] = Json::arrayValue;
@@ -1342,7 +2537,10 @@ string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) con
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
 	string ret;
-	map<string, unsigned> sourceIndicesMap = sourceIndices();
+	// Locations refer to the char streams of the scanners of the sources.
+	unordered_map<uint32_t, int> sourceIndicesMap;
+	for (auto const& [name, index]: sourceIndices())
+		sourceIndicesMap[m_sources.at(name).scanner->charStream()->index()] = int(index);
 	int prevStart = -1;
 	int prevLength = -1;
 	int prevSourceIndex = -1;
@@ -1355,10 +2553,8 @@ string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) con
 
 		SourceLocation const& location = item.location();
 		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
-		int sourceIndex =
-			location.source && sourceIndicesMap.count(location.source->name()) ?
-			sourceIndicesMap.at(location.source->name()) :
-			-1;
+		auto sourceIndexIt = sourceIndicesMap.find(location.source.index());
+		int sourceIndex = sourceIndexIt != sourceIndicesMap.end() ? sourceIndexIt->second : -1;
 		char jump = '-';
 		if (item.getJumpType() == eth::AssemblyItem::JumpType::IntoFunction)
 			jump = 'i';
@@ -1443,6 +2639,10 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 	if (m_stackState != CompilationSuccessful)
 		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
 
+	Contract const& currentContract = contract(_contractName);
+	if (!currentContract.compiler && currentContract.cachedArtifacts)
+		return (*currentContract.cachedArtifacts)["gasEstimates"];
+
 	if (!assemblyItems(_contractName) && !runtimeAssemblyItems(_contractName))
 		return Json::Value();
 
@@ -23,12 +23,14 @@
 
 #pragma once
 
+#include <libsolidity/ast/ASTArena.h>
 #include <libsolidity/interface/ReadFile.h>
 #include <libsolidity/interface/OptimiserSettings.h>
 #include <libsolidity/interface/Version.h>
 #include <libsolidity/interface/DebugSettings.h>
 #include <libsolidity/formal/SolverInterface.h>
 
+#include <liblangutil/CharStream.h>
 #include <liblangutil/ErrorReporter.h>
 #include <liblangutil/EVMVersion.h>
 #include <liblangutil/SourceLocation.h>
@@ -37,12 +39,14 @@
 
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/Statistics.h>
 
 #include <boost/noncopyable.hpp>
 #include <json/json.h>
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <set>
 #include <string>
@@ -67,6 +71,7 @@ namespace solidity
 {
 
 // forward declarations
+struct ASTBinaryContext;
 class ASTNode;
 class ContractDefinition;
 class FunctionDefinition;
@@ -74,6 +79,7 @@ class SourceUnit;
 class Compiler;
 class GlobalContext;
 class Natspec;
+class TypeProvider;
 class DeclarationContainer;
 
 /**
@@ -82,6 +88,8 @@ class DeclarationContainer;
  * before compilation to bytecode) or run the whole compilation in one call.
  * If error recovery is active, it is possible to progress through the stages even when
  * there are errors. In any case, producing code is only possible without errors.
+ * The stack uses the type provider that is current when it is created (see TypeProvider::ScopedInstance)
+ * and has to be used while that provider is current. Only one stack can use a provider at a time.
  */
 class CompilerStack: boost::noncopyable
 {
@@ -107,6 +115,19 @@ public:
 		std::string target;
 	};
 
+	/// Stages of the compilation pipeline that are run for a contract after analysis.
+	struct PipelineConfig
+	{
+		/// Legacy code generation, optimisation and assembly.
+		bool bytecode = false;
+		/// Yul IR generation.
+		bool irCodegen = false;
+		/// Translation of the optimised Yul IR to Ewasm, implies irCodegen.
+		bool ewasm = false;
+
+		bool empty() const { return !bytecode && !irCodegen && !ewasm; }
+	};
+
 	/// Creates a new compiler stack.
 	/// @param _readFile callback used to read files for import statements. Must return
 	/// and must not emit exceptions.
@@ -163,6 +184,28 @@ public:
 	/// Must be set before parsing.
 	void setEVMVersion(langutil::EVMVersion _version = langutil::EVMVersion{});
 
+	/// Sets the maximum number of threads used to parse sources and to generate code for
+	/// independent contracts. The output does not depend on this setting.
+	/// Must be set before parsing.
+	void setParallelism(unsigned _parallelism = 1);
+
+	/// Declares whether the read callback can be called from multiple threads at the same time.
+	/// If so and the parallelism is larger than one, imported files are read concurrently.
+	/// Otherwise, they are read one at a time while other sources are parsed.
+	/// Must be set before parsing.
+	void allowConcurrentReads(bool _allow = true);
+
+	/// Enables collecting the time and memory used by each phase of the compilation
+	/// and by each contract, together with some counters, see @a statistics.
+	/// Must be set before parsing.
+	void enableStatistics(bool _enable = true);
+
+	/// Sets the directory in which compilation artifacts of contracts are cached across runs.
+	/// Contracts whose artifacts are found there are not compiled again.
+	/// Caching is disabled if @a _directory is empty.
+	/// Must be set before parsing.
+	void setCacheDirectory(std::string _directory = std::string());
+
 	/// Set which SMT solvers should be enabled.
 	void setSMTSolverChoice(smt::SMTSolverChoice _enabledSolvers);
 
@@ -181,6 +224,21 @@ public:
 	/// Enable experimental generation of Ewasm code. If enabled, IR is also generated.
 	void enableEwasmGeneration(bool _enable = true) { m_generateEwasm = _enable; }
 
+	/// Enables or disables parsing and validating the documentation during analysis, which is
+	/// enabled by default. If it is disabled, invalid documentation is not reported, and it is only
+	/// parsed when needed for the NatSpec output or the metadata. This is meant for callers that
+	/// request neither of them nor bytecode, whose metadata includes the NatSpec output.
+	void enableDocumentationAnalysis(bool _enable = true) { m_documentationAnalysis = _enable; }
+
+	/// Sets the pipeline stages to run for each contract, by fully qualified name.
+	/// Contracts that are not listed are only analysed, unless they are needed to compile
+	/// other contracts. If this is not set, all requested contracts are compiled to bytecode,
+	/// and to IR and Ewasm as enabled by enableIRGeneration and enableEwasmGeneration.
+	void setContractPipelines(std::map<std::string, PipelineConfig> _pipelines)
+	{
+		m_contractPipelines = std::move(_pipelines);
+	}
+
 	/// @arg _metadataLiteralSources When true, store sources as literals in the contract metadata.
 	/// Must be set before parsing.
 	void useMetadataLiteralSources(bool _metadataLiteralSources);
@@ -192,6 +250,35 @@ public:
 
 	/// Sets the sources. Must be set before parsing.
 	void setSources(StringMap _sources);
+	/// Sets the sources to the given char streams, named by their paths. The streams share
+	/// their source text with the given ones instead of copying it. Must be set before parsing.
+	void setSourceStreams(std::vector<langutil::CharStream> _sources);
+
+	/// Replaces the contents of the given sources (or adds them) while keeping the parsed and
+	/// analysed state of all sources that neither changed nor (transitively) import a changed source.
+	/// The next call to parse() and analyze() only processes the affected sources. Errors and
+	/// warnings of the unaffected sources are kept. Node IDs of re-parsed sources differ from
+	/// the ones a fresh compiler stack would assign.
+	/// If the previous run had errors, all sources are processed again.
+	/// Can be called in any state and puts the stack into the SourcesSet state.
+	void updateSources(StringMap _changedSources);
+	/// Same as updateSources(), but shares the source text of the given char streams,
+	/// which are named by their paths.
+	void updateSourceStreams(std::vector<langutil::CharStream> _changedSources);
+	/// Replaces the bytes from @a _start to @a _end of the source @a _sourceName by @a _replacement
+	/// and otherwise behaves like updateSources(). Only the tokens around the edit are scanned again.
+	/// If the edit lies inside a single element of the source unit or of a contract, like a contract
+	/// or a function, and the source was parsed without errors or warnings, only this element is
+	/// parsed again and replaces the previous one in the AST. Otherwise the whole source is
+	/// parsed again. The memory of replaced elements is only freed when that happens.
+	void editSource(std::string const& _sourceName, size_t _start, size_t _end, std::string const& _replacement);
+
+	/// Adds the source encoded in @a _encodedAST (see encodedAST()) under its original name.
+	/// Its AST is recreated from the encoding instead of parsing the source. If the encoding
+	/// contains the analysed AST and the sources it imports did not change, the source is not
+	/// analysed again and its warnings are not reported again. Must be called before parsing.
+	/// Throws CompilerError if the encoding is invalid or from a different compiler version.
+	void addEncodedAST(std::string const& _encodedAST);
 
 	/// Adds a response to an SMTLib2 query (identified by the hash of the query input).
 	/// Must be set before parsing.
@@ -214,6 +301,19 @@ public:
 	/// @returns false on error.
 	bool compile();
 
+	/// Receives the fully qualified name of a contract whose outputs are available.
+	using ContractCallback = std::function<void(std::string const& _contractName)>;
+
+	/// Compiles the contracts @a _contractNames (fully qualified names) and calls @a _compiled
+	/// for each of them in the given order, as soon as its outputs are available. The outputs
+	/// of a contract are released when the callback returns, so only the contracts that share
+	/// dependencies with it are kept in memory at the same time. Contracts that are not listed
+	/// are only compiled if listed contracts create them. The outputs are the same as the ones
+	/// of compile(), but the contracts are always compiled on the calling thread.
+	/// If an exception is thrown, the stack is left in the AnalysisPerformed state.
+	/// @returns false on error.
+	bool compile(std::vector<std::string> const& _contractNames, ContractCallback const& _compiled);
+
 	/// @returns the list of sources (paths) used
 	std::vector<std::string> sourceNames() const;
 
@@ -227,6 +327,11 @@ public:
 	/// @returns the parsed source unit with the supplied name.
 	SourceUnit const& ast(std::string const& _sourceName) const;
 
+	/// @returns a compact binary encoding of the source and parsed AST of the given source,
+	/// which can be loaded via addEncodedAST() by a compiler of the same version. If the source
+	/// was analysed without errors, the encoding also contains the annotations of its AST.
+	std::string encodedAST(std::string const& _sourceName) const;
+
 	/// Helper function for logs printing. Do only use in error cases, it's quite expensive.
 	/// line and columns are numbered starting from 1 with following order:
 	/// start line, start column, end line, end column
@@ -236,6 +341,10 @@ public:
 	/// by calling @a addSMTLib2Response).
 	std::vector<std::string> const& unhandledSMTLib2Queries() const { return m_unhandledSMTLib2Queries; }
 
+	/// @returns the statistics of the phases run since the last call to @a parse, in total
+	/// and by contract, if enabled via @a enableStatistics.
+	Json::Value statistics() const;
+
 	/// @returns a list of the contract names in the sources.
 	std::vector<std::string> contractNames() const;
 
@@ -319,11 +428,26 @@ private:
 	struct Source
 	{
 		std::shared_ptr<langutil::Scanner> scanner;
+		/// Memory the nodes and annotations of the AST are allocated from. Declared before
+		/// the AST, such that it is destroyed after it.
+		std::unique_ptr<ASTArena> arena;
 		std::shared_ptr<SourceUnit> ast;
+		/// Encoding the AST is recreated from instead of parsing, if not empty.
+		std::string encodedAST;
 		h256 mutable keccak256HashCached;
 		h256 mutable swarmHashCached;
 		std::string mutable ipfsUrlCached;
-		void reset() { *this = Source(); }
+		/// Whether the AST was analysed without errors and does not need to be analysed again.
+		bool analysed = false;
+		/// Whether the doc strings in the AST were parsed into its annotations.
+		bool mutable documentationAnalysed = false;
+		/// Whether parsing reported neither errors nor warnings, such that parts of the AST can be
+		/// parsed again after an edit.
+		bool cleanlyParsed = false;
+		/// Whether the AST was kept across an edit, which reset all its annotations.
+		bool edited = false;
+		/// The AST is dropped first, assigning a new source would destroy the arena before it.
+		void reset() { ast.reset(); *this = Source(); }
 		h256 const& keccak256() const;
 		h256 const& swarmHash() const;
 		std::string const& ipfsUrl() const;
@@ -347,21 +471,70 @@ private:
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
 		mutable std::unique_ptr<std::string const> sourceMapping;
 		mutable std::unique_ptr<std::string const> runtimeSourceMapping;
+		/// Compiler-dependent outputs (assembly, gas estimates) if the contract was
+		/// loaded from the artifact cache instead of being compiled.
+		std::optional<Json::Value> cachedArtifacts;
+		/// Statistics of the code generation of this contract.
+		StatisticsCollector statistics;
+
+		/// Frees the outputs of the code generation and the cached JSON outputs.
+		void releaseGeneratedCode();
 	};
 
+	/// Drops the ASTs of the sources @a _changedSources and of all sources that (transitively)
+	/// import them, together with everything that refers to them and their errors.
+	/// If the previous run had errors, all sources are affected.
+	/// @returns the affected sources.
+	std::set<std::string> invalidateSources(std::set<std::string> const& _changedSources);
+	/// Parses the element of @a _ast that encloses the bytes from @a _start to @a _end again, after
+	/// they were replaced by @a _replacementLength bytes in the scanner of @a _source, and replaces
+	/// it in @a _ast, see editSource().
+	/// @returns false if no such element exists or it could not be parsed cleanly.
+	bool reparseEditedElement(
+		Source const& _source,
+		SourceUnit& _ast,
+		size_t _start,
+		size_t _end,
+		size_t _replacementLength
+	);
 	/// Loads the missing sources from @a _ast (named @a _path) using the callback
-	/// @a m_readFile and stores the absolute paths of all imports in the AST annotations.
+	/// @a _readFile and stores the absolute paths of all imports in the AST annotations.
 	/// @returns the newly loaded sources.
-	StringMap loadMissingSources(SourceUnit const& _ast, std::string const& _path);
+	StringMap loadMissingSources(SourceUnit const& _ast, std::string const& _path, ReadCallback::Callback const& _readFile);
+	/// @returns the absolute path of the file imported by @a _import in the source @a _path,
+	/// after applying the remappings.
+	std::string absoluteImportPath(ImportDirective const& _import, std::string const& _path);
+	/// Parses the given sources and the sources they import using up to m_parallelism threads.
+	/// The ASTs, their node IDs and the reported errors are the same as when parsing sequentially.
+	void parseInParallel(std::vector<std::string> const& _sourcesToParse);
 	std::string applyRemapping(std::string const& _path, std::string const& _context);
 	void resolveImports();
 
+	/// @returns the sources and settings the annotations of encoded ASTs refer to.
+	ASTBinaryContext encodedASTContext() const;
+
 	/// @returns true if the source is requested to be compiled.
 	bool isRequestedSource(std::string const& _sourceName) const;
 
 	/// @returns true if the contract is requested to be compiled.
 	bool isRequestedContract(ContractDefinition const& _contract) const;
 
+	/// @returns the pipeline stages to run for the given contract.
+	PipelineConfig pipelineConfig(ContractDefinition const& _contract) const;
+
+	/// Runs the pipeline stages configured for a single contract.
+	void runPipeline(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, std::shared_ptr<Compiler const>>& _otherCompilers
+	);
+
+	/// Runs the pipelines of the given contracts in the given order.
+	void compileContracts(std::vector<ContractDefinition const*> const& _contracts);
+
+	/// Same as compileContracts, but distributes groups of contracts that do not share
+	/// any dependencies over up to m_parallelism threads.
+	void compileContractsInParallel(std::vector<ContractDefinition const*> const& _contracts);
+
 	/// Compile a single contract.
 	/// @param _otherCompilers provides access to compilers of other contracts, to get
 	///                        their bytecode if needed. Only filled after they have been compiled.
@@ -377,6 +550,30 @@ private:
 	/// Generate Ewasm representation for a single contract.
 	void generateEwasm(ContractDefinition const& _contract);
 
+	/// @returns the key under which the artifacts of @a _contract are cached. It is derived from
+	/// the metadata, which includes the compiler version, the hashes of all referenced sources
+	/// and all settings, and from all other settings that influence the artifacts.
+	h256 artifactCacheKey(Contract const& _contract) const;
+
+	/// Loads the artifacts of the contracts in @a _contracts from the cache if they are present
+	/// and not needed to compile any of the other contracts.
+	/// @returns the contracts that still have to be compiled.
+	std::vector<ContractDefinition const*> loadCachedArtifacts(std::vector<ContractDefinition const*> const& _contracts);
+
+	/// Stores the artifacts of the contracts @a _contractNames that were compiled in this run
+	/// in the cache. @a _sourceCodes are the texts of all sources, see sourceCodes().
+	/// Has to be called before linking.
+	void storeCachedArtifacts(std::vector<std::string> const& _contractNames, StringMap const& _sourceCodes);
+	/// @returns the texts of all sources by their names.
+	StringMap sourceCodes() const;
+
+	/// @returns the collector to record statistics of the whole stack or of @a _contract into,
+	/// or nullptr if statistics are disabled.
+	StatisticsCollector* statisticsCollector(Contract* _contract = nullptr);
+
+	/// Updates the counters of the statistics that reflect the current state.
+	void updateStatisticsCounters();
+
 	/// Links all the known library addresses in the available objects. Any unknown
 	/// library will still be kept as an unlinked placeholder in the objects.
 	void link();
@@ -410,6 +607,13 @@ private:
 	/// This will generate the JSON object and store it in the Contract object if it is not present yet.
 	Json::Value const& storageLayout(Contract const&) const;
 
+	/// Parses the doc strings of all sources that were not parsed yet and reports errors in them
+	/// to @a _errorReporter.
+	/// @returns false if errors were reported.
+	bool analyseDocumentation(langutil::ErrorReporter& _errorReporter) const;
+	/// Parses the doc strings that were not parsed during analysis, ignoring errors in them.
+	void parseRemainingDocumentation() const;
+
 	/// @returns the Natspec User documentation as a JSON object.
 	/// This will generate the JSON object and store it in the Contract object if it is not present yet.
 	Json::Value const& natspecUser(Contract const&) const;
@@ -437,6 +641,8 @@ private:
 	std::map<std::string, std::set<std::string>> m_requestedContractNames;
 	bool m_generateIR;
 	bool m_generateEwasm;
+	bool m_documentationAnalysis = true;
+	std::optional<std::map<std::string, PipelineConfig>> m_contractPipelines;
 	std::map<std::string, h160> m_libraries;
 	/// list of path prefix remappings, e.g. mylibrary: github.com/ethereum = /usr/local/ethereum
 	/// "context:prefix=target"
@@ -451,9 +657,20 @@ private:
 	std::map<std::string const, Contract> m_contracts;
 	langutil::ErrorList m_errorList;
 	langutil::ErrorReporter m_errorReporter;
+	/// Errors of sources that were kept by updateSources().
+	langutil::ErrorList m_unaffectedErrors;
+	/// Provides the types of this stack, also to its worker threads.
+	TypeProvider* m_typeProvider = nullptr;
 	bool m_metadataLiteralSources = false;
 	MetadataHash m_metadataHash = MetadataHash::IPFS;
 	bool m_parserErrorRecovery = false;
+	unsigned m_parallelism = 1;
+	bool m_concurrentReads = false;
+	/// Highest node ID assigned during the last parsing run.
+	size_t m_lastNodeID = 0;
+	bool m_statisticsEnabled = false;
+	StatisticsCollector m_statistics;
+	std::string m_cacheDirectory;
 	State m_stackState = Empty;
 	/// Whether or not there has been an error during processing.
 	/// If this is true, the stack will refuse to generate code.
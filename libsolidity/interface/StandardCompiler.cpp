@@ -23,8 +23,10 @@
 #include <libsolidity/interface/StandardCompiler.h>
 
 #include <libsolidity/ast/ASTJsonConverter.h>
+#include <libsolidity/ast/TypeProvider.h>
 #include <libyul/AssemblyStack.h>
 #include <libyul/Exceptions.h>
+#include <libyul/YulString.h>
 #include <liblangutil/SourceReferenceFormatter.h>
 #include <libevmasm/Instruction.h>
 #include <libdevcore/JSON.h>
@@ -35,6 +37,7 @@
 
 #include <algorithm>
 #include <optional>
+#include <set>
 
 using namespace std;
 using namespace dev;
@@ -76,6 +79,38 @@ Json::Value formatFatalError(string const& _type, string const& _message)
 	return output;
 }
 
+/// @returns the output reporting the exception that is currently being handled.
+Json::Value formatCurrentException()
+{
+	try
+	{
+		throw;
+	}
+	catch (Json::LogicError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
+	}
+	catch (Json::RuntimeError const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
+	}
+	catch (Exception const& _exception)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile: " + boost::diagnostic_information(_exception));
+	}
+	catch (...)
+	{
+		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile");
+	}
+}
+
+/// Passes all members of @a _output to @a _write.
+void writeOutput(StandardCompiler::OutputWriter const& _write, Json::Value const& _output)
+{
+	for (string const& key: _output.getMemberNames())
+		_write({key}, _output[key]);
+}
+
 Json::Value formatSourceLocation(SourceLocation const* location)
 {
 	Json::Value sourceLocation;
@@ -247,39 +282,41 @@ bool isBinaryRequested(Json::Value const& _outputSelection)
 	return false;
 }
 
-/// @returns true if any Ewasm code was requested. Note that as an exception, '*' does not
-/// yet match "ewasm.wast" or "ewasm"
-bool isEwasmRequested(Json::Value const& _outputSelection)
+/// @returns true if the NatSpec documentation of any contract is requested, directly or as part of the metadata.
+/// The metadata embedded in binaries also contains it, see isBinaryRequested.
+bool isDocumentationRequested(Json::Value const& _outputSelection)
 {
 	if (!_outputSelection.isObject())
 		return false;
 
+	static vector<string> const outputsThatRequireDocumentation{"userdoc", "devdoc", "metadata"};
+
 	for (auto const& fileRequests: _outputSelection)
 		for (auto const& requests: fileRequests)
-			for (auto const& request: requests)
-				if (request == "ewasm" || request == "ewasm.wast")
+			for (auto const& output: outputsThatRequireDocumentation)
+				if (isArtifactRequested(requests, output, false))
 					return true;
-
 	return false;
 }
 
-/// @returns true if any Yul IR was requested. Note that as an exception, '*' does not
-/// yet match "ir" or "irOptimized"
-bool isIRRequested(Json::Value const& _outputSelection)
+/// @returns the pipeline stages needed to produce the outputs requested for the given contract.
+/// Outputs that are not listed here, like the ABI or the method identifiers, only need analysis.
+/// Note that as an exception, '*' does not yet match "ir", "irOptimized", "ewasm" or "ewasm.wast".
+CompilerStack::PipelineConfig pipelineConfig(Json::Value const& _outputSelection, string const& _file, string const& _contract)
 {
-	if (isEwasmRequested(_outputSelection))
-		return true;
-
-	if (!_outputSelection.isObject())
-		return false;
-
-	for (auto const& fileRequests: _outputSelection)
-		for (auto const& requests: fileRequests)
-			for (auto const& request: requests)
-				if (request == "ir" || request == "irOptimized")
-					return true;
+	static vector<string> const outputsThatRequireBytecode{
+		"evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes",
+		"evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences",
+		"evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap",
+		"evm.bytecode.linkReferences",
+		"evm.gasEstimates", "evm.legacyAssembly", "evm.assembly"
+	};
 
-	return false;
+	CompilerStack::PipelineConfig pipeline;
+	pipeline.bytecode = isArtifactRequested(_outputSelection, _file, _contract, outputsThatRequireBytecode, false);
+	pipeline.irCodegen = isArtifactRequested(_outputSelection, _file, _contract, vector<string>{"ir", "irOptimized"}, false);
+	pipeline.ewasm = isArtifactRequested(_outputSelection, _file, _contract, vector<string>{"ewasm", "ewasm.wast"}, false);
+	return pipeline;
 }
 
 Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkReferences)
@@ -351,7 +388,7 @@ std::optional<Json::Value> checkAuxiliaryInputKeys(Json::Value const& _input)
 
 std::optional<Json::Value> checkSettingsKeys(Json::Value const& _input)
 {
-	static set<string> keys{"parserErrorRecovery", "debug", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "remappings"};
+	static set<string> keys{"parserErrorRecovery", "cacheDir", "debug", "evmVersion", "libraries", "metadata", "optimizer", "outputSelection", "parallelism", "remappings"};
 	return checkKeys(_input, keys, "settings");
 }
 
@@ -509,6 +546,8 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 		return *result;
 
 	ret.language = _input["language"].asString();
+	ret.settings = _input;
+	ret.settings.removeMember("sources");
 
 	Json::Value const& sources = _input["sources"];
 
@@ -541,7 +580,7 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 					"Mismatch between content and supplied hash for \"" + sourceName + "\""
 				));
 			else
-				ret.sources[sourceName] = content;
+				ret.sources[sourceName] = std::move(content);
 		}
 		else if (sources[sourceName]["urls"].isArray())
 		{
@@ -567,7 +606,7 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 						));
 					else
 					{
-						ret.sources[sourceName] =  result.responseOrErrorMessage;
+						ret.sources[sourceName] = std::move(result.responseOrErrorMessage);
 						found = true;
 						break;
 					}
@@ -649,9 +688,23 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 		ret.evmVersion = *version;
 	}
 
+	if (settings.isMember("parallelism"))
+	{
+		if (!settings["parallelism"].isUInt() || settings["parallelism"].asUInt() == 0)
+			return formatFatalError("JSONError", "\"settings.parallelism\" must be a positive integer.");
+		ret.parallelism = settings["parallelism"].asUInt();
+	}
+
+	if (settings.isMember("cacheDir"))
+	{
+		if (!settings["cacheDir"].isString())
+			return formatFatalError("JSONError", "\"settings.cacheDir\" must be a string.");
+		ret.cacheDirectory = settings["cacheDir"].asString();
+	}
+
 	if (settings.isMember("debug"))
 	{
-		if (auto result = checkKeys(settings["debug"], {"revertStrings"}, "settings.debug"))
+		if (auto result = checkKeys(settings["debug"], {"revertStrings", "statistics"}, "settings.debug"))
 			return *result;
 
 		if (settings["debug"].isMember("revertStrings"))
@@ -668,6 +721,13 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 				);
 			ret.revertStrings = *revertStrings;
 		}
+
+		if (settings["debug"].isMember("statistics"))
+		{
+			if (!settings["debug"]["statistics"].isBool())
+				return formatFatalError("JSONError", "settings.debug.statistics must be a Boolean.");
+			ret.statistics = settings["debug"]["statistics"].asBool();
+		}
 	}
 
 	if (settings.isMember("remappings") && !settings["remappings"].isArray())
@@ -760,38 +820,227 @@ boost::variant<StandardCompiler::InputsAndSettings, Json::Value> StandardCompile
 	return { std::move(ret) };
 }
 
-Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSettings _inputsAndSettings)
+void StandardCompiler::compileSolidity(
+	StandardCompiler::InputsAndSettings _inputsAndSettings,
+	OutputWriter const& _write,
+	bool _streamContracts
+)
 {
-	CompilerStack compilerStack(m_readFile);
-
-	StringMap sourceList = std::move(_inputsAndSettings.sources);
-	compilerStack.setSources(sourceList);
-	for (auto const& smtLib2Response: _inputsAndSettings.smtLib2Responses)
-		compilerStack.addSMTLib2Response(smtLib2Response.first, smtLib2Response.second);
-	compilerStack.setEVMVersion(_inputsAndSettings.evmVersion);
-	compilerStack.setParserErrorRecovery(_inputsAndSettings.parserErrorRecovery);
-	compilerStack.setRemappings(_inputsAndSettings.remappings);
-	compilerStack.setOptimiserSettings(std::move(_inputsAndSettings.optimiserSettings));
-	compilerStack.setRevertStringBehaviour(_inputsAndSettings.revertStrings);
-	compilerStack.setLibraries(_inputsAndSettings.libraries);
-	compilerStack.useMetadataLiteralSources(_inputsAndSettings.metadataLiteralSources);
-	compilerStack.setMetadataHash(_inputsAndSettings.metadataHash);
-	compilerStack.setRequestedContractNames(requestedContractNames(_inputsAndSettings.outputSelection));
-
-	compilerStack.enableIRGeneration(isIRRequested(_inputsAndSettings.outputSelection));
-
-	compilerStack.enableEwasmGeneration(isEwasmRequested(_inputsAndSettings.outputSelection));
+	// The compiler stack shares the text of the sources with these streams.
+	map<string, CharStream> sourceList;
+	for (auto& source: _inputsAndSettings.sources)
+		sourceList.emplace(source.first, CharStream(std::move(source.second), source.first));
+
+	// The kept analysis can be reused if only the contents of sources changed.
+	bool reuseAnalysis =
+		m_compilerStack &&
+		m_compilerStackSettings == _inputsAndSettings.settings &&
+		all_of(m_compilerStackSources.begin(), m_compilerStackSources.end(), [&](auto const& _source) {
+			return sourceList.count(_source.first);
+		});
+	if (reuseAnalysis)
+	{
+		vector<CharStream> changedSources;
+		for (auto const& source: sourceList)
+			if (
+				!m_compilerStackSources.count(source.first) ||
+				m_compilerStackSources.at(source.first).source() != source.second.source()
+			)
+				changedSources.push_back(source.second);
+		// Sources loaded through the read callback are read again, since they can have changed
+		// as well. The stack cannot drop sources, so it is replaced if one cannot be read anymore.
+		for (string const& name: m_compilerStack->sourceNames())
+		{
+			if (sourceList.count(name))
+				continue;
+			ReadCallback::Result result{false, string()};
+			if (m_readFile)
+				result = m_readFile(ReadCallback::kindString(ReadCallback::Kind::ReadFile), name);
+			if (!result.success)
+			{
+				reuseAnalysis = false;
+				break;
+			}
+			if (m_compilerStack->scanner(name).source() != result.responseOrErrorMessage)
+				changedSources.emplace_back(std::move(result.responseOrErrorMessage), name);
+		}
+		if (reuseAnalysis)
+			m_compilerStack->updateSourceStreams(std::move(changedSources));
+	}
+	if (!reuseAnalysis)
+	{
+		// The previous stack has to be destroyed before a new one can be created.
+		m_compilerStack.reset();
+		m_compilerStack = make_unique<CompilerStack>(m_readFile);
+		vector<CharStream> sources;
+		for (auto const& source: sourceList)
+			sources.push_back(source.second);
+		m_compilerStack->setSourceStreams(std::move(sources));
+		for (auto const& smtLib2Response: _inputsAndSettings.smtLib2Responses)
+			m_compilerStack->addSMTLib2Response(smtLib2Response.first, smtLib2Response.second);
+		m_compilerStack->setEVMVersion(_inputsAndSettings.evmVersion);
+		m_compilerStack->setParserErrorRecovery(_inputsAndSettings.parserErrorRecovery);
+		m_compilerStack->setParallelism(_inputsAndSettings.parallelism);
+		m_compilerStack->allowConcurrentReads(m_concurrentReads);
+		m_compilerStack->setCacheDirectory(_inputsAndSettings.cacheDirectory);
+		m_compilerStack->enableStatistics(_inputsAndSettings.statistics);
+		m_compilerStack->setRemappings(_inputsAndSettings.remappings);
+		m_compilerStack->setOptimiserSettings(std::move(_inputsAndSettings.optimiserSettings));
+		m_compilerStack->setRevertStringBehaviour(_inputsAndSettings.revertStrings);
+		m_compilerStack->setLibraries(_inputsAndSettings.libraries);
+		m_compilerStack->useMetadataLiteralSources(_inputsAndSettings.metadataLiteralSources);
+		m_compilerStack->setMetadataHash(_inputsAndSettings.metadataHash);
+		m_compilerStack->setRequestedContractNames(requestedContractNames(_inputsAndSettings.outputSelection));
+	}
+	m_compilerStackSettings = std::move(_inputsAndSettings.settings);
+	m_compilerStackSources = sourceList;
+	// The assembly output shows the code of the sources given in the input.
+	StringMap sourceTexts;
+	auto assemblySources = [&]() -> StringMap const& {
+		if (sourceTexts.empty())
+			for (auto const& source: sourceList)
+				sourceTexts[source.first] = string(source.second.source());
+		return sourceTexts;
+	};
+	// Only kept if requested, the stack is destroyed at the end of this function otherwise.
+	unique_ptr<CompilerStack> ownedCompilerStack = m_keepAnalysis ? nullptr : std::move(m_compilerStack);
+	CompilerStack& compilerStack = m_keepAnalysis ? *m_compilerStack : *ownedCompilerStack;
 
 	Json::Value errors = std::move(_inputsAndSettings.errors);
 
 	bool const binariesRequested = isBinaryRequested(_inputsAndSettings.outputSelection);
+	// Documentation is only parsed and validated if it ends up in the output.
+	compilerStack.enableDocumentationAnalysis(
+		binariesRequested || isDocumentationRequested(_inputsAndSettings.outputSelection)
+	);
+
+	bool const wildcardMatchesExperimental = false;
+
+	bool auxiliaryInputWritten = false;
+	auto writeAuxiliaryInput = [&]() {
+		if (auxiliaryInputWritten || compilerStack.unhandledSMTLib2Queries().empty())
+			return;
+		auxiliaryInputWritten = true;
+		Json::Value queries = Json::objectValue;
+		for (string const& query: compilerStack.unhandledSMTLib2Queries())
+			queries["smtlib2queries"]["0x" + keccak256(query).hex()] = query;
+		_write({"auxiliaryInputRequested"}, std::move(queries));
+	};
+
+	set<string> writtenContracts;
+	auto writeContract = [&](string const& _file, string const& _name, bool _compilationSuccess) {
+		string const contractName = _file + ":" + _name;
+		writtenContracts.insert(contractName);
+
+		// ABI, storage layout, documentation and metadata
+		Json::Value contractData(Json::objectValue);
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "abi", wildcardMatchesExperimental))
+			contractData["abi"] = compilerStack.contractABI(contractName);
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "storageLayout", false))
+			contractData["storageLayout"] = compilerStack.storageLayout(contractName);
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "metadata", wildcardMatchesExperimental))
+			contractData["metadata"] = compilerStack.metadata(contractName);
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "userdoc", wildcardMatchesExperimental))
+			contractData["userdoc"] = compilerStack.natspecUser(contractName);
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "devdoc", wildcardMatchesExperimental))
+			contractData["devdoc"] = compilerStack.natspecDev(contractName);
 
+		// IR
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "ir", wildcardMatchesExperimental))
+			contractData["ir"] = compilerStack.yulIR(contractName);
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "irOptimized", wildcardMatchesExperimental))
+			contractData["irOptimized"] = compilerStack.yulIROptimized(contractName);
+
+		// Ewasm
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "ewasm.wast", wildcardMatchesExperimental))
+			contractData["ewasm"]["wast"] = compilerStack.ewasm(contractName);
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "ewasm.wasm", wildcardMatchesExperimental))
+			contractData["ewasm"]["wasm"] = compilerStack.ewasmObject(contractName).toHex();
+
+		// EVM
+		Json::Value evmData(Json::objectValue);
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "evm.assembly", wildcardMatchesExperimental))
+			evmData["assembly"] = compilerStack.assemblyString(contractName, assemblySources());
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "evm.legacyAssembly", wildcardMatchesExperimental))
+			evmData["legacyAssembly"] = compilerStack.assemblyJSON(contractName, assemblySources());
+		if (isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "evm.methodIdentifiers", wildcardMatchesExperimental))
+			evmData["methodIdentifiers"] = compilerStack.methodIdentifiers(contractName);
+		if (_compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, _file, _name, "evm.gasEstimates", wildcardMatchesExperimental))
+			evmData["gasEstimates"] = compilerStack.gasEstimates(contractName);
+
+		if (_compilationSuccess && isArtifactRequested(
+			_inputsAndSettings.outputSelection,
+			_file,
+			_name,
+			{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" },
+			wildcardMatchesExperimental
+		))
+			evmData["bytecode"] = collectEVMObject(
+				compilerStack.object(contractName),
+				compilerStack.sourceMapping(contractName)
+			);
+
+		if (_compilationSuccess && isArtifactRequested(
+			_inputsAndSettings.outputSelection,
+			_file,
+			_name,
+			{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" },
+			wildcardMatchesExperimental
+		))
+			evmData["deployedBytecode"] = collectEVMObject(
+				compilerStack.runtimeObject(contractName),
+				compilerStack.runtimeSourceMapping(contractName)
+			);
+
+		if (!evmData.empty())
+			contractData["evm"] = evmData;
+
+		if (!contractData.empty())
+			_write({"contracts", _file, _name}, std::move(contractData));
+	};
+
+	bool completed = false;
 	try
 	{
-		if (binariesRequested)
-			compilerStack.compile();
-		else
-			compilerStack.parseAndAnalyze();
+		if (compilerStack.parseAndAnalyze() && binariesRequested)
+		{
+			// Only run the stages of the pipeline that are needed for the outputs of each contract.
+			map<string, CompilerStack::PipelineConfig> pipelines;
+			for (string const& contractName: compilerStack.contractNames())
+			{
+				size_t colon = contractName.rfind(':');
+				solAssert(colon != string::npos, "");
+				pipelines[contractName] = pipelineConfig(
+					_inputsAndSettings.outputSelection,
+					contractName.substr(0, colon),
+					contractName.substr(colon + 1)
+				);
+			}
+			compilerStack.setContractPipelines(std::move(pipelines));
+			if (_streamContracts && _inputsAndSettings.parallelism <= 1)
+			{
+				// Each contract is written as soon as it is compiled and released afterwards.
+				// The output members before "contracts" have to be written first.
+				writeAuxiliaryInput();
+				set<pair<string, string>> contracts;
+				for (string const& contractName: compilerStack.contractNames())
+				{
+					size_t colon = contractName.rfind(':');
+					solAssert(colon != string::npos, "");
+					contracts.emplace(contractName.substr(0, colon), contractName.substr(colon + 1));
+				}
+				vector<string> contractNames;
+				for (auto const& [file, name]: contracts)
+					contractNames.push_back(file + ":" + name);
+				compilerStack.compile(contractNames, [&](string const& _contractName) {
+					size_t colon = _contractName.rfind(':');
+					writeContract(_contractName.substr(0, colon), _contractName.substr(colon + 1), true);
+				});
+			}
+			else
+				compilerStack.compile();
+		}
+		completed = true;
 
 		for (auto const& error: compilerStack.errors())
 		{
@@ -895,6 +1144,10 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 		));
 	}
 
+	// The state of the stack is unknown after an exception, so it is not reused.
+	if (!completed)
+		m_compilerStackSettings = Json::nullValue;
+
 	bool analysisPerformed = compilerStack.state() >= CompilerStack::State::AnalysisPerformed;
 	bool const compilationSuccess = compilerStack.state() == CompilerStack::State::CompilationSuccessful;
 
@@ -903,22 +1156,36 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 
 	/// Inconsistent state - stop here to receive error reports from users
 	if (((binariesRequested && !compilationSuccess) || !analysisPerformed) && errors.empty())
-		return formatFatalError("InternalCompilerError", "No error reported, but compilation failed.");
+	{
+		writeOutput(_write, formatFatalError("InternalCompilerError", "No error reported, but compilation failed."));
+		return;
+	}
 
-	Json::Value output = Json::objectValue;
+	// The members are written in the order of their keys, so that they can be streamed.
+	writeAuxiliaryInput();
 
-	if (errors.size() > 0)
-		output["errors"] = std::move(errors);
+	// Sorted by file and then by name, i.e. in the order of the output.
+	set<pair<string, string>> contracts;
+	for (string const& contractName: analysisPerformed ? compilerStack.contractNames() : vector<string>())
+	{
+		size_t colon = contractName.rfind(':');
+		solAssert(colon != string::npos, "");
+		contracts.emplace(contractName.substr(0, colon), contractName.substr(colon + 1));
+	}
 
-	if (!compilerStack.unhandledSMTLib2Queries().empty())
-		for (string const& query: compilerStack.unhandledSMTLib2Queries())
-			output["auxiliaryInputRequested"]["smtlib2queries"]["0x" + keccak256(query).hex()] = query;
+	for (auto const& [file, name]: contracts)
+		if (!writtenContracts.count(file + ":" + name))
+			writeContract(file, name, compilationSuccess);
 
-	bool const wildcardMatchesExperimental = false;
+	if (errors.size() > 0)
+		_write({"errors"}, std::move(errors));
 
-	output["sources"] = Json::objectValue;
+	// Source names are sorted, so the sources are written in the order of their indices.
+	vector<string> sourceNames = analysisPerformed ? compilerStack.sourceNames() : vector<string>();
+	if (sourceNames.empty())
+		_write({"sources"}, Json::objectValue);
 	unsigned sourceIndex = 0;
-	for (string const& sourceName: analysisPerformed ? compilerStack.sourceNames() : vector<string>())
+	for (string const& sourceName: sourceNames)
 	{
 		Json::Value sourceResult = Json::objectValue;
 		sourceResult["id"] = sourceIndex++;
@@ -926,94 +1193,13 @@ Json::Value StandardCompiler::compileSolidity(StandardCompiler::InputsAndSetting
 			sourceResult["ast"] = ASTJsonConverter(false, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
 		if (isArtifactRequested(_inputsAndSettings.outputSelection, sourceName, "", "legacyAST", wildcardMatchesExperimental))
 			sourceResult["legacyAST"] = ASTJsonConverter(true, compilerStack.sourceIndices()).toJson(compilerStack.ast(sourceName));
-		output["sources"][sourceName] = sourceResult;
+		_write({"sources", sourceName}, std::move(sourceResult));
 	}
 
-	Json::Value contractsOutput = Json::objectValue;
-	for (string const& contractName: analysisPerformed ? compilerStack.contractNames() : vector<string>())
-	{
-		size_t colon = contractName.rfind(':');
-		solAssert(colon != string::npos, "");
-		string file = contractName.substr(0, colon);
-		string name = contractName.substr(colon + 1);
-
-		// ABI, storage layout, documentation and metadata
-		Json::Value contractData(Json::objectValue);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "abi", wildcardMatchesExperimental))
-			contractData["abi"] = compilerStack.contractABI(contractName);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "storageLayout", false))
-			contractData["storageLayout"] = compilerStack.storageLayout(contractName);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "metadata", wildcardMatchesExperimental))
-			contractData["metadata"] = compilerStack.metadata(contractName);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "userdoc", wildcardMatchesExperimental))
-			contractData["userdoc"] = compilerStack.natspecUser(contractName);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "devdoc", wildcardMatchesExperimental))
-			contractData["devdoc"] = compilerStack.natspecDev(contractName);
-
-		// IR
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "ir", wildcardMatchesExperimental))
-			contractData["ir"] = compilerStack.yulIR(contractName);
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "irOptimized", wildcardMatchesExperimental))
-			contractData["irOptimized"] = compilerStack.yulIROptimized(contractName);
-
-		// Ewasm
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "ewasm.wast", wildcardMatchesExperimental))
-			contractData["ewasm"]["wast"] = compilerStack.ewasm(contractName);
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "ewasm.wasm", wildcardMatchesExperimental))
-			contractData["ewasm"]["wasm"] = compilerStack.ewasmObject(contractName).toHex();
-
-		// EVM
-		Json::Value evmData(Json::objectValue);
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.assembly", wildcardMatchesExperimental))
-			evmData["assembly"] = compilerStack.assemblyString(contractName, sourceList);
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.legacyAssembly", wildcardMatchesExperimental))
-			evmData["legacyAssembly"] = compilerStack.assemblyJSON(contractName, sourceList);
-		if (isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.methodIdentifiers", wildcardMatchesExperimental))
-			evmData["methodIdentifiers"] = compilerStack.methodIdentifiers(contractName);
-		if (compilationSuccess && isArtifactRequested(_inputsAndSettings.outputSelection, file, name, "evm.gasEstimates", wildcardMatchesExperimental))
-			evmData["gasEstimates"] = compilerStack.gasEstimates(contractName);
-
-		if (compilationSuccess && isArtifactRequested(
-			_inputsAndSettings.outputSelection,
-			file,
-			name,
-			{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" },
-			wildcardMatchesExperimental
-		))
-			evmData["bytecode"] = collectEVMObject(
-				compilerStack.object(contractName),
-				compilerStack.sourceMapping(contractName)
-			);
-
-		if (compilationSuccess && isArtifactRequested(
-			_inputsAndSettings.outputSelection,
-			file,
-			name,
-			{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" },
-			wildcardMatchesExperimental
-		))
-			evmData["deployedBytecode"] = collectEVMObject(
-				compilerStack.runtimeObject(contractName),
-				compilerStack.runtimeSourceMapping(contractName)
-			);
-
-		if (!evmData.empty())
-			contractData["evm"] = evmData;
-
-		if (!contractData.empty())
-		{
-			if (!contractsOutput.isMember(file))
-				contractsOutput[file] = Json::objectValue;
-			contractsOutput[file][name] = contractData;
-		}
-	}
-	if (!contractsOutput.empty())
-		output["contracts"] = contractsOutput;
-
-	return output;
+	if (_inputsAndSettings.statistics)
+		_write({"statistics"}, compilerStack.statistics());
 }
 
-
 Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 {
 	if (_inputsAndSettings.sources.size() != 1)
@@ -1026,6 +1212,8 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 		return formatFatalError("JSONError", "Field \"settings.libraries\" cannot be used for Yul.");
 	if (_inputsAndSettings.revertStrings != RevertStrings::Default)
 		return formatFatalError("JSONError", "Field \"settings.debug.revertStrings\" cannot be used for Yul.");
+	if (_inputsAndSettings.statistics)
+		return formatFatalError("JSONError", "Field \"settings.debug.statistics\" cannot be used for Yul.");
 
 	Json::Value output = Json::objectValue;
 
@@ -1091,40 +1279,120 @@ Json::Value StandardCompiler::compileYul(InputsAndSettings _inputsAndSettings)
 	return output;
 }
 
+StandardCompiler::StandardCompiler(ReadCallback::Callback const& _readFile):
+	m_readFile(_readFile),
+	m_typeProvider(make_unique<TypeProvider>()),
+	m_yulStrings(make_unique<YulStringRepository>())
+{
+}
 
-Json::Value StandardCompiler::compile(Json::Value const& _input) noexcept
+StandardCompiler::~StandardCompiler() = default;
+
+void StandardCompiler::keepAnalysis(bool _keep)
+{
+	m_keepAnalysis = _keep;
+	if (!_keep)
+		discardAnalysis();
+}
+
+void StandardCompiler::allowConcurrentReads(bool _allow)
 {
-	YulStringRepository::reset();
+	if (_allow != m_concurrentReads)
+		discardAnalysis();
+	m_concurrentReads = _allow;
+}
 
-	try
+void StandardCompiler::compile(Json::Value const& _input, OutputWriter const& _write, bool _streamContracts)
+{
+	TypeProvider::ScopedInstance typeProviderScope(*m_typeProvider);
+	YulStringRepository::ScopedInstance yulStringsScope(*m_yulStrings);
+
+	// Types of changed sources are dropped, but others (e.g. of literals) accumulate.
+	size_t const maxKeptTypes = 1 << 18;
+	if (TypeProvider::typeCount() > maxKeptTypes)
+		discardAnalysis();
+	size_t const maxWarmYulStrings = 1 << 20;
+	if (!(m_keepCachesWarm || m_keepAnalysis) || YulStringRepository::instance().size() > maxWarmYulStrings)
+	{
+		// Inline assembly blocks of the kept sources refer to the interned strings.
+		discardAnalysis();
+		YulStringRepository::reset();
+	}
+
+	auto parsed = parseInput(_input);
+	if (parsed.type() == typeid(Json::Value))
+		writeOutput(_write, boost::get<Json::Value>(parsed));
+	else
 	{
-		auto parsed = parseInput(_input);
-		if (parsed.type() == typeid(Json::Value))
-			return boost::get<Json::Value>(std::move(parsed));
 		InputsAndSettings settings = boost::get<InputsAndSettings>(std::move(parsed));
 		if (settings.language == "Solidity")
-			return compileSolidity(std::move(settings));
+			compileSolidity(std::move(settings), _write, _streamContracts);
 		else if (settings.language == "Yul")
-			return compileYul(std::move(settings));
+			writeOutput(_write, compileYul(std::move(settings)));
 		else
-			return formatFatalError("JSONError", "Only \"Solidity\" or \"Yul\" is supported as a language.");
+			writeOutput(_write, formatFatalError("JSONError", "Only \"Solidity\" or \"Yul\" is supported as a language."));
 	}
-	catch (Json::LogicError const& _exception)
+}
+
+Json::Value StandardCompiler::compile(Json::Value const& _input) noexcept
+{
+	try
 	{
-		return formatFatalError("InternalCompilerError", string("JSON logic exception: ") + _exception.what());
+		Json::Value output = Json::objectValue;
+		compile(_input, [&](vector<string> const& _path, Json::Value _value) {
+			Json::Value* member = &output;
+			for (string const& key: _path)
+				member = &(*member)[key];
+			*member = std::move(_value);
+		});
+		return output;
 	}
-	catch (Json::RuntimeError const& _exception)
+	catch (...)
 	{
-		return formatFatalError("InternalCompilerError", string("JSON runtime exception: ") + _exception.what());
+		return formatCurrentException();
 	}
-	catch (Exception const& _exception)
+}
+
+bool StandardCompiler::compile(string const& _input, ostream& _output) noexcept
+{
+	Json::Value input;
+	string errors;
+	try
 	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile: " + boost::diagnostic_information(_exception));
+		if (!jsonParseStrict(_input, input, &errors))
+		{
+			_output << jsonCompactPrint(formatFatalError("JSONError", errors));
+			return true;
+		}
 	}
 	catch (...)
 	{
-		return formatFatalError("InternalCompilerError", "Internal exception in StandardCompiler::compile");
+		_output << "{\"errors\":[{\"type\":\"JSONError\",\"component\":\"general\",\"severity\":\"error\",\"message\":\"Error parsing input JSON.\"}]}";
+		return true;
+	}
+
+	bool success = true;
+	try
+	{
+		JsonObjectStreamWriter writer(_output);
+		try
+		{
+			compile(input, [&](vector<string> const& _path, Json::Value const& _value) {
+				solAssert(writer.write(_path, _value), "Output not written in order.");
+			}, true);
+		}
+		catch (...)
+		{
+			// Unlike with compile(Json::Value), the members written so far are kept.
+			success = writer.write({"errors"}, formatCurrentException()["errors"]);
+		}
+		writer.finish();
+	}
+	catch (...)
+	{
+		success = false;
 	}
+	return success;
 }
 
 string StandardCompiler::compile(string const& _input) noexcept
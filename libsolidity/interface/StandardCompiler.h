@@ -24,18 +24,29 @@
 
 #include <libsolidity/interface/CompilerStack.h>
 
+#include <functional>
 #include <optional>
+#include <ostream>
 #include <boost/variant.hpp>
 
+namespace yul
+{
+class YulStringRepository;
+}
+
 namespace dev
 {
 
 namespace solidity
 {
 
+class TypeProvider;
+
 /**
  * Standard JSON compiler interface, which expects a JSON input and returns a JSON output.
  * See docs/using-the-compiler#compiler-input-and-output-json-description.
+ * Every instance has its own types and Yul strings, so different instances can compile
+ * on different threads at the same time.
  */
 class StandardCompiler: boost::noncopyable
 {
@@ -43,10 +54,8 @@ public:
 	/// Creates a new StandardCompiler.
 	/// @param _readFile callback used to read files for import statements. Must return
 	/// and must not emit exceptions.
-	explicit StandardCompiler(ReadCallback::Callback const& _readFile = ReadCallback::Callback()):
-		m_readFile(_readFile)
-	{
-	}
+	explicit StandardCompiler(ReadCallback::Callback const& _readFile = ReadCallback::Callback());
+	~StandardCompiler();
 
 	/// Sets all input parameters according to @a _input which conforms to the standardized input
 	/// format, performs compilation and returns a standardized output.
@@ -54,18 +63,56 @@ public:
 	/// Parses input as JSON and peforms the above processing steps, returning a serialized JSON
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input) noexcept;
+	/// Same as above, but writes the output to @a _output while it is generated. The outputs of
+	/// each contract are written as soon as its code is generated and released before the next
+	/// contract is compiled, so apart from the analysed sources, only the contracts that create
+	/// each other (or the same contract) are kept in memory at a time. If "settings.parallelism"
+	/// is larger than one, all contracts are compiled before the first one is written.
+	/// Apart from internal errors, the output is identical to the one of compile(std::string),
+	/// except that contracts written before the code generation of another one fails keep
+	/// their bytecode.
+	/// @returns false if an internal error could not be reported because the errors had already
+	/// been written or the stream failed. The output is still valid JSON unless the stream failed.
+	bool compile(std::string const& _input, std::ostream& _output) noexcept;
+
+	/// Receives the members of the output at @a _path, i.e. the keys of the enclosing objects
+	/// followed by the key of the member, in the order of their keys.
+	using OutputWriter = std::function<void(std::vector<std::string> const& _path, Json::Value _value)>;
+
+	/// Keeps the caches of this compiler (interned Yul strings and the dialects built from them)
+	/// between calls to compile() instead of clearing them before every compilation. They are
+	/// still cleared if they grow too large. The output does not depend on this setting.
+	void keepCachesWarm(bool _keep = true) { m_keepCachesWarm = _keep; }
+
+	/// Keeps the parsed and analysed sources of a Solidity compilation after compile() returns.
+	/// If the next input only differs in its sources, only the sources affected by the changes
+	/// are analysed again (see CompilerStack::updateSources). Implies keepCachesWarm().
+	/// The kept state is discarded if too many types accumulate.
+	void keepAnalysis(bool _keep = true);
+	/// Releases the sources kept by keepAnalysis(). The next compilation starts from scratch.
+	void discardAnalysis() { m_compilerStack.reset(); }
+
+	/// Declares whether the read callback can be called from multiple threads at the same time.
+	/// If so, imported files are read concurrently if "settings.parallelism" is larger than one,
+	/// see CompilerStack::allowConcurrentReads. Changing it discards the kept analysis.
+	void allowConcurrentReads(bool _allow = true);
 
 private:
 	struct InputsAndSettings
 	{
 		std::string language;
+		/// The input without its sources. Used to decide whether kept analysis can be reused.
+		Json::Value settings;
 		Json::Value errors;
 		bool parserErrorRecovery = false;
+		unsigned parallelism = 1;
+		std::string cacheDirectory;
 		std::map<std::string, std::string> sources;
 		std::map<h256, std::string> smtLib2Responses;
 		langutil::EVMVersion evmVersion;
 		std::vector<CompilerStack::Remapping> remappings;
 		RevertStrings revertStrings = RevertStrings::Default;
+		bool statistics = false;
 		OptimiserSettings optimiserSettings = OptimiserSettings::minimal();
 		std::map<std::string, h160> libraries;
 		bool metadataLiteralSources = false;
@@ -77,10 +124,25 @@ private:
 	/// it in condensed form or an error as a json object.
 	boost::variant<InputsAndSettings, Json::Value> parseInput(Json::Value const& _input);
 
-	Json::Value compileSolidity(InputsAndSettings _inputsAndSettings);
+	/// Compiles @a _input and passes the output to @a _write member by member. Can throw.
+	/// If @a _streamContracts is true, the outputs of each contract are passed to @a _write
+	/// as soon as it is compiled, see CompilerStack::compile(std::vector<std::string>, ContractCallback).
+	void compile(Json::Value const& _input, OutputWriter const& _write, bool _streamContracts = false);
+	void compileSolidity(InputsAndSettings _inputsAndSettings, OutputWriter const& _write, bool _streamContracts);
 	Json::Value compileYul(InputsAndSettings _inputsAndSettings);
 
 	ReadCallback::Callback m_readFile;
+	/// Types and Yul strings of this compiler, current on the compiling thread during compile().
+	std::unique_ptr<TypeProvider> m_typeProvider;
+	std::unique_ptr<yul::YulStringRepository> m_yulStrings;
+	bool m_keepCachesWarm = false;
+	bool m_keepAnalysis = false;
+	bool m_concurrentReads = false;
+	/// Compiler stack of the previous compilation, only set if m_keepAnalysis is true.
+	std::unique_ptr<CompilerStack> m_compilerStack;
+	/// Settings and sources the kept compiler stack was run with.
+	Json::Value m_compilerStackSettings;
+	std::map<std::string, langutil::CharStream> m_compilerStackSources;
 };
 
 }
@@ -60,9 +60,11 @@ public:
 	template <class NodeType, typename... Args>
 	ASTPointer<NodeType> createNode(Args&& ... _args)
 	{
-		solAssert(m_location.source, "");
+		solAssert(m_location.source.index(), "");
 		if (m_location.end < 0)
 			markEndPosition();
+		if (m_parser.m_arena)
+			return ASTNode::createInArena<NodeType>(*m_parser.m_arena, m_location, std::forward<Args>(_args)...);
 		return make_shared<NodeType>(m_location, std::forward<Args>(_args)...);
 	}
 
@@ -73,40 +75,17 @@ private:
 	SourceLocation m_location;
 };
 
-ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
+ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner, ASTArena* _arena)
 {
 	try
 	{
 		m_recursionDepth = 0;
 		m_scanner = _scanner;
+		m_arena = _arena;
 		ASTNodeFactory nodeFactory(*this);
 		vector<ASTPointer<ASTNode>> nodes;
 		while (m_scanner->currentToken() != Token::EOS)
-		{
-			switch (m_scanner->currentToken())
-			{
-			case Token::Pragma:
-				nodes.push_back(parsePragmaDirective());
-				break;
-			case Token::Import:
-				nodes.push_back(parseImportDirective());
-				break;
-			case Token::Abstract:
-			case Token::Interface:
-			case Token::Contract:
-			case Token::Library:
-				nodes.push_back(parseContractDefinition());
-				break;
-			case Token::Struct:
-				nodes.push_back(parseStructDefinition());
-				break;
-			case Token::Enum:
-				nodes.push_back(parseEnumDefinition());
-				break;
-			default:
-				fatalParserError(string("Expected pragma, import directive or contract/interface/library/struct/enum definition."));
-			}
-		}
+			nodes.push_back(parseSourceUnitElement());
 		solAssert(m_recursionDepth == 0, "");
 		return nodeFactory.createNode<SourceUnit>(nodes);
 	}
@@ -118,6 +97,52 @@ ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
 	}
 }
 
+ASTPointer<ASTNode> Parser::parseElement(
+	shared_ptr<Scanner> const& _scanner,
+	bool _contractBody,
+	ASTArena* _arena
+)
+{
+	try
+	{
+		m_recursionDepth = 0;
+		m_scanner = _scanner;
+		m_arena = _arena;
+		ASTPointer<ASTNode> element = _contractBody ? parseContractBodyElement() : parseSourceUnitElement();
+		solAssert(m_recursionDepth == 0, "");
+		return element;
+	}
+	catch (FatalError const&)
+	{
+		if (m_errorReporter.errors().empty())
+			throw; // Something is weird here, rather throw again.
+		return nullptr;
+	}
+}
+
+ASTPointer<ASTNode> Parser::parseSourceUnitElement()
+{
+	switch (m_scanner->currentToken())
+	{
+	case Token::Pragma:
+		return parsePragmaDirective();
+	case Token::Import:
+		return parseImportDirective();
+	case Token::Abstract:
+	case Token::Interface:
+	case Token::Contract:
+	case Token::Library:
+		return parseContractDefinition();
+	case Token::Struct:
+		return parseStructDefinition();
+	case Token::Enum:
+		return parseEnumDefinition();
+	default:
+		fatalParserError(string("Expected pragma, import directive or contract/interface/library/struct/enum definition."));
+	}
+	return nullptr;
+}
+
 void Parser::parsePragmaVersion(SourceLocation const& _location, vector<Token> const& _tokens, vector<string> const& _literals)
 {
 	SemVerMatchExpressionParser parser(_tokens, _literals);
@@ -153,7 +178,7 @@ ASTPointer<PragmaDirective> Parser::parsePragmaDirective()
 			parserError("Token incompatible with Solidity parser as part of pragma directive.");
 		else
 		{
-			string literal = m_scanner->currentLiteral();
+			string literal{m_scanner->currentLiteral()};
 			if (literal.empty() && TokenTraits::toString(token))
 				literal = TokenTraits::toString(token);
 			literals.push_back(literal);
@@ -295,44 +320,8 @@ ASTPointer<ContractDefinition> Parser::parseContractDefinition()
 			}
 			while (m_scanner->currentToken() == Token::Comma);
 		expectToken(Token::LBrace);
-		while (true)
-		{
-			Token currentTokenValue = m_scanner->currentToken();
-			if (currentTokenValue == Token::RBrace)
-				break;
-			else if (
-				(currentTokenValue == Token::Function && m_scanner->peekNextToken() != Token::LParen) ||
-				currentTokenValue == Token::Constructor ||
-				currentTokenValue == Token::Receive ||
-				currentTokenValue == Token::Fallback
-			)
-				subNodes.push_back(parseFunctionDefinition());
-			else if (currentTokenValue == Token::Struct)
-				subNodes.push_back(parseStructDefinition());
-			else if (currentTokenValue == Token::Enum)
-				subNodes.push_back(parseEnumDefinition());
-			else if (
-				currentTokenValue == Token::Identifier ||
-				currentTokenValue == Token::Mapping ||
-				TokenTraits::isElementaryTypeName(currentTokenValue) ||
-				(currentTokenValue == Token::Function && m_scanner->peekNextToken() == Token::LParen)
-			)
-			{
-				VarDeclParserOptions options;
-				options.isStateVariable = true;
-				options.allowInitialValue = true;
-				subNodes.push_back(parseVariableDeclaration(options));
-				expectToken(Token::Semicolon);
-			}
-			else if (currentTokenValue == Token::Modifier)
-				subNodes.push_back(parseModifierDefinition());
-			else if (currentTokenValue == Token::Event)
-				subNodes.push_back(parseEventDefinition());
-			else if (currentTokenValue == Token::Using)
-				subNodes.push_back(parseUsingDirective());
-			else
-				fatalParserError(string("Function, variable, struct or modifier declaration expected."));
-		}
+		while (m_scanner->currentToken() != Token::RBrace)
+			subNodes.push_back(parseContractBodyElement());
 	}
 	catch (FatalError const&)
 	{
@@ -359,6 +348,45 @@ ASTPointer<ContractDefinition> Parser::parseContractDefinition()
 	);
 }
 
+ASTPointer<ASTNode> Parser::parseContractBodyElement()
+{
+	Token currentTokenValue = m_scanner->currentToken();
+	if (
+		(currentTokenValue == Token::Function && m_scanner->peekNextToken() != Token::LParen) ||
+		currentTokenValue == Token::Constructor ||
+		currentTokenValue == Token::Receive ||
+		currentTokenValue == Token::Fallback
+	)
+		return parseFunctionDefinition();
+	else if (currentTokenValue == Token::Struct)
+		return parseStructDefinition();
+	else if (currentTokenValue == Token::Enum)
+		return parseEnumDefinition();
+	else if (
+		currentTokenValue == Token::Identifier ||
+		currentTokenValue == Token::Mapping ||
+		TokenTraits::isElementaryTypeName(currentTokenValue) ||
+		(currentTokenValue == Token::Function && m_scanner->peekNextToken() == Token::LParen)
+	)
+	{
+		VarDeclParserOptions options;
+		options.isStateVariable = true;
+		options.allowInitialValue = true;
+		ASTPointer<VariableDeclaration> variable = parseVariableDeclaration(options);
+		expectToken(Token::Semicolon);
+		return variable;
+	}
+	else if (currentTokenValue == Token::Modifier)
+		return parseModifierDefinition();
+	else if (currentTokenValue == Token::Event)
+		return parseEventDefinition();
+	else if (currentTokenValue == Token::Using)
+		return parseUsingDirective();
+	else
+		fatalParserError(string("Function, variable, struct or modifier declaration expected."));
+	return nullptr;
+}
+
 ASTPointer<InheritanceSpecifier> Parser::parseInheritanceSpecifier()
 {
 	RecursionGuard recursionGuard(*this);
@@ -1195,7 +1223,9 @@ ASTPointer<InlineAssembly> Parser::parseInlineAssembly(ASTPointer<ASTString> con
 		BOOST_THROW_EXCEPTION(FatalError());
 
 	location.end = block->location.end;
-	return make_shared<InlineAssembly>(location, _docString, dialect, block);
+	ASTNodeFactory nodeFactory(*this);
+	nodeFactory.setLocation(location);
+	return nodeFactory.createNode<InlineAssembly>(_docString, dialect, block);
 }
 
 ASTPointer<IfStatement> Parser::parseIfStatement(ASTPointer<ASTString> const& _docString)
@@ -1785,7 +1815,7 @@ ASTPointer<Expression> Parser::parsePrimaryExpression()
 	case Token::StringLiteral:
 	case Token::HexStringLiteral:
 	{
-		string literal = m_scanner->currentLiteral();
+		string literal{m_scanner->currentLiteral()};
 		Token firstToken = m_scanner->currentToken();
 		while (m_scanner->peekNextToken() == firstToken)
 		{
@@ -1943,11 +1973,40 @@ Parser::LookAheadInfo Parser::peekStatementType() const
 		if (next == Token::Identifier || TokenTraits::isLocationSpecifier(next))
 			return LookAheadInfo::VariableDeclaration;
 		if (next == Token::LBrack || next == Token::Period)
-			return LookAheadInfo::IndexAccessStructure;
+			return token == Token::Identifier ? peekIndexAccessedPathType() : LookAheadInfo::IndexAccessStructure;
 	}
 	return LookAheadInfo::Expression;
 }
 
+Parser::LookAheadInfo Parser::peekIndexAccessedPathType() const
+{
+	// Skip 'Identifier ("." Identifier)* ("[" ... "]")*' and check whether a variable name
+	// or data location follows. Index ranges and conditionals ("[a:b]", "[a ? b : c]") are
+	// left to tryParseIndexAccessedPath, which reports invalid array lengths.
+	size_t ahead = 1;
+	while (m_scanner->peekToken(ahead) == Token::Period && m_scanner->peekToken(ahead + 1) == Token::Identifier)
+		ahead += 2;
+	while (m_scanner->peekToken(ahead) == Token::LBrack)
+	{
+		size_t depth = 0;
+		do
+		{
+			Token token = m_scanner->peekToken(ahead++);
+			if (token == Token::LBrack)
+				depth++;
+			else if (token == Token::RBrack)
+				depth--;
+			else if (token == Token::EOS || (token == Token::Colon && depth == 1))
+				return LookAheadInfo::IndexAccessStructure;
+		}
+		while (depth > 0);
+	}
+	Token next = m_scanner->peekToken(ahead);
+	if (next == Token::Identifier || TokenTraits::isLocationSpecifier(next))
+		return LookAheadInfo::VariableDeclaration;
+	return LookAheadInfo::Expression;
+}
+
 Parser::IndexAccessedPath Parser::parseIndexAccessedPath()
 {
 	IndexAccessedPath iap;
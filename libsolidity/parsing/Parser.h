@@ -48,7 +48,21 @@ public:
 		m_evmVersion(_evmVersion)
 	{}
 
-	ASTPointer<SourceUnit> parse(std::shared_ptr<langutil::Scanner> const& _scanner);
+	/// Parses the source of @a _scanner. If @a _arena is given, all nodes are allocated from it,
+	/// and it has to outlive them.
+	ASTPointer<SourceUnit> parse(
+		std::shared_ptr<langutil::Scanner> const& _scanner,
+		ASTArena* _arena = nullptr
+	);
+	/// Parses a single element of a source unit, or of the body of a contract if @a _contractBody
+	/// is true, starting at the current token of @a _scanner. This is used to parse a part of an
+	/// edited source again. If @a _arena is given, all nodes are allocated from it.
+	/// @returns nullptr on a fatal error.
+	ASTPointer<ASTNode> parseElement(
+		std::shared_ptr<langutil::Scanner> const& _scanner,
+		bool _contractBody,
+		ASTArena* _arena = nullptr
+	);
 
 private:
 	class ASTNodeFactory;
@@ -84,10 +98,14 @@ private:
 	void parsePragmaVersion(langutil::SourceLocation const& _location, std::vector<Token> const& _tokens, std::vector<std::string> const& _literals);
 	ASTPointer<PragmaDirective> parsePragmaDirective();
 	ASTPointer<ImportDirective> parseImportDirective();
+	/// Parses a pragma, import directive or contract, struct or enum definition.
+	ASTPointer<ASTNode> parseSourceUnitElement();
 	/// @returns an std::pair<ContractDefinition::ContractKind, bool>, where
 	/// result.second is set to true, if an abstract contract was parsed, false otherwise.
 	std::pair<ContractDefinition::ContractKind, bool> parseContractKind();
 	ASTPointer<ContractDefinition> parseContractDefinition();
+	/// Parses a function, modifier, event, variable, struct, enum or using for inside a contract.
+	ASTPointer<ASTNode> parseContractBodyElement();
 	ASTPointer<InheritanceSpecifier> parseInheritanceSpecifier();
 	Visibility parseVisibilitySpecifier();
 	ASTPointer<OverrideSpecifier> parseOverrideSpecifier();
@@ -178,8 +196,12 @@ private:
 	std::pair<LookAheadInfo, IndexAccessedPath> tryParseIndexAccessedPath();
 	/// Performs limited look-ahead to distinguish between variable declaration and expression statement.
 	/// For source code of the form "a[][8]" ("IndexAccessStructure"), this is not possible to
-	/// decide with constant look-ahead.
+	/// decide with constant look-ahead, see peekIndexAccessedPathType.
 	LookAheadInfo peekStatementType() const;
+	/// Looks ahead past a path of identifiers and index accesses to decide between a variable
+	/// declaration and an expression without parsing it.
+	/// @returns LookAheadInfo::IndexAccessStructure if this cannot be decided from the tokens alone.
+	LookAheadInfo peekIndexAccessedPathType() const;
 	/// @returns an IndexAccessedPath as a prestage to parsing a variable declaration (type name)
 	/// or an expression;
 	IndexAccessedPath parseIndexAccessedPath();
@@ -200,6 +222,8 @@ private:
 	/// Flag that signifies whether '_' is parsed as a PlaceholderStatement or a regular identifier.
 	bool m_insideModifier = false;
 	langutil::EVMVersion m_evmVersion;
+	/// Arena the nodes are allocated from, if any.
+	ASTArena* m_arena = nullptr;
 };
 
 }
@@ -70,11 +70,11 @@ protected:
 			r.location.start = position();
 			r.location.end = endPosition();
 		}
-		if (!r.location.source)
-			r.location.source = m_scanner->charStream();
+		if (!r.location.source.index())
+			r.location.source = *m_scanner->charStream();
 		return r;
 	}
-	langutil::SourceLocation location() const { return {position(), endPosition(), m_scanner->charStream()}; }
+	langutil::SourceLocation location() const { return {position(), endPosition(), *m_scanner->charStream()}; }
 
 	Block parseBlock();
 	Statement parseStatement();
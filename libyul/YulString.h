@@ -22,8 +22,11 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <array>
 #include <unordered_map>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <functional>
@@ -35,6 +38,10 @@ namespace yul
 /// Owns the string data for all YulStrings, which can be referenced by a Handle.
 /// A Handle consists of an ID (that depends on the insertion order of YulStrings and is potentially
 /// non-deterministic) and a deterministic string hash.
+/// Strings can be inserted from multiple threads concurrently. The string data is stored in
+/// fixed-size chunks that are never moved, so looking up a string does not require locking.
+/// YulStrings refer to the repository that is current on the thread they are used on, see
+/// ScopedInstance, so YulStrings of different repositories must not be mixed.
 class YulStringRepository
 {
 public:
@@ -44,8 +51,36 @@ public:
 		std::uint64_t hash;
 	};
 
+	YulStringRepository()
+	{
+		// The callbacks are run on destruction, so they have to outlive all repositories.
+		callbackRegistry();
+		clear();
+	}
+	~YulStringRepository() { runResetCallbacks(); }
+	YulStringRepository(YulStringRepository const&) = delete;
+	YulStringRepository& operator=(YulStringRepository const& _rhs) = delete;
+
+	/// Makes a repository the current one of the calling thread for the lifetime of this
+	/// object, so that independent compilations can use separate repositories.
+	class ScopedInstance
+	{
+	public:
+		explicit ScopedInstance(YulStringRepository& _repository): m_previous(current()) { current() = &_repository; }
+		~ScopedInstance() { current() = m_previous; }
+		ScopedInstance(ScopedInstance const&) = delete;
+		ScopedInstance& operator=(ScopedInstance const&) = delete;
+
+	private:
+		YulStringRepository* m_previous;
+	};
+
+	/// @returns the current repository of the calling thread. Unless one is set via
+	/// ScopedInstance, this is a default repository shared by all threads.
 	static YulStringRepository& instance()
 	{
+		if (YulStringRepository* repository = current())
+			return *repository;
 		static YulStringRepository inst;
 		return inst;
 	}
@@ -55,17 +90,27 @@ public:
 		if (_string.empty())
 			return { 0, emptyHash() };
 		std::uint64_t h = hash(_string);
+		std::lock_guard<std::mutex> lock(m_mutex);
 		auto range = m_hashToID.equal_range(h);
 		for (auto it = range.first; it != range.second; ++it)
-			if (*m_strings[it->second] == _string)
+			if (idToString(it->second) == _string)
 				return Handle{it->second, h};
-		m_strings.emplace_back(std::make_shared<std::string>(_string));
-		size_t id = m_strings.size() - 1;
+		size_t id = m_size;
+		if (!m_chunks.at(id / ChunkSize))
+			m_chunks[id / ChunkSize] = std::make_unique<Chunk>();
+		(*m_chunks[id / ChunkSize])[id % ChunkSize] = _string;
+		++m_size;
 		m_hashToID.emplace_hint(range.second, std::make_pair(h, id));
 
 		return Handle{id, h};
 	}
-	std::string const& idToString(size_t _id) const	{ return *m_strings.at(_id); }
+	std::string const& idToString(size_t _id) const	{ return (*m_chunks[_id / ChunkSize])[_id % ChunkSize]; }
+	/// @returns the number of strings in the repository.
+	size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_size;
+	}
 
 	static std::uint64_t hash(std::string const& v)
 	{
@@ -80,41 +125,85 @@ public:
 		return hash;
 	}
 	static constexpr std::uint64_t emptyHash() { return 14695981039346656037u; }
-	/// Clear the repository.
+	/// Clear the current repository.
 	/// Use with care - there cannot be any dangling YulString references.
 	/// If references need to be cleared manually, register the callback via
 	/// resetCallback.
 	static void reset()
 	{
-		for (auto const& cb: resetCallbacks())
-			cb();
-		instance() = YulStringRepository{};
+		instance().runResetCallbacks();
+		instance().clear();
 	}
-	/// Struct that registers a reset callback as a side-effect of its construction.
-	/// Useful as static local variable to register a reset callback once.
+	/// Struct that registers a reset callback as a side-effect of its construction and removes
+	/// it on destruction. Useful as static local variable to register a reset callback once.
+	/// The callback receives the repository that is reset or destroyed.
 	struct ResetCallback
 	{
-		ResetCallback(std::function<void()> _fun)
+		explicit ResetCallback(std::function<void(YulStringRepository const&)> _fun)
 		{
-			YulStringRepository::resetCallbacks().emplace_back(std::move(_fun));
+			CallbackRegistry& registry = callbackRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			m_position = registry.callbacks.emplace(registry.callbacks.end(), std::move(_fun));
 		}
+		~ResetCallback()
+		{
+			CallbackRegistry& registry = callbackRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.callbacks.erase(m_position);
+		}
+		ResetCallback(ResetCallback const&) = delete;
+		ResetCallback& operator=(ResetCallback const&) = delete;
+
+	private:
+		std::list<std::function<void(YulStringRepository const&)>>::iterator m_position;
 	};
 
 private:
-	YulStringRepository() = default;
-	YulStringRepository(YulStringRepository const&) = delete;
-	YulStringRepository(YulStringRepository&&) = default;
-	YulStringRepository& operator=(YulStringRepository const& _rhs) = delete;
-	YulStringRepository& operator=(YulStringRepository&& _rhs) = default;
+	static constexpr size_t ChunkSize = 4096;
+	static constexpr size_t MaxChunks = 65536;
+	using Chunk = std::array<std::string, ChunkSize>;
+
+	struct CallbackRegistry
+	{
+		std::mutex mutex;
+		std::list<std::function<void(YulStringRepository const&)>> callbacks;
+	};
+
+	static YulStringRepository*& current()
+	{
+		static thread_local YulStringRepository* repository = nullptr;
+		return repository;
+	}
+
+	void runResetCallbacks() const
+	{
+		CallbackRegistry& registry = callbackRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (auto const& callback: registry.callbacks)
+			callback(*this);
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (auto& chunk: m_chunks)
+			chunk.reset();
+		m_chunks[0] = std::make_unique<Chunk>();
+		m_size = 1;
+		m_hashToID = {{emptyHash(), 0}};
+	}
 
-	static std::vector<std::function<void()>>& resetCallbacks()
+	static CallbackRegistry& callbackRegistry()
 	{
-		static std::vector<std::function<void()>> callbacks;
-		return callbacks;
+		static CallbackRegistry registry;
+		return registry;
 	}
 
-	std::vector<std::shared_ptr<std::string>> m_strings = {std::make_shared<std::string>()};
-	std::unordered_multimap<std::uint64_t, size_t> m_hashToID = {{emptyHash(), 0}};
+	mutable std::mutex m_mutex;
+	/// Chunks of string data, the empty string is stored at ID zero.
+	std::array<std::unique_ptr<Chunk>, MaxChunks> m_chunks;
+	size_t m_size = 0;
+	std::unordered_multimap<std::uint64_t, size_t> m_hashToID;
 };
 
 /// Wrapper around handles into the YulString repository.
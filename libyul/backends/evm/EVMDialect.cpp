@@ -34,6 +34,9 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <mutex>
+#include <tuple>
+
 using namespace std;
 using namespace dev;
 using namespace yul;
@@ -166,6 +169,28 @@ map<YulString, BuiltinFunctionForEVM> createBuiltins(langutil::EVMVersion _evmVe
 	return builtins;
 }
 
+/// @returns the dialect with the given properties built for the current YulString repository.
+/// The dialects store YulStrings, so they are dropped when their repository is reset or destroyed.
+EVMDialect const& cachedDialect(AsmFlavour _flavour, bool _objectAccess, langutil::EVMVersion _version)
+{
+	using Key = tuple<YulStringRepository const*, AsmFlavour, bool, langutil::EVMVersion>;
+	static map<Key, unique_ptr<EVMDialect const>> dialects;
+	static mutex dialectsMutex;
+	static YulStringRepository::ResetCallback callback{[](YulStringRepository const& _repository) {
+		lock_guard<mutex> lock(dialectsMutex);
+		for (auto it = dialects.begin(); it != dialects.end();)
+			if (get<0>(it->first) == &_repository)
+				it = dialects.erase(it);
+			else
+				++it;
+	}};
+	lock_guard<mutex> lock(dialectsMutex);
+	auto& dialect = dialects[Key{&YulStringRepository::instance(), _flavour, _objectAccess, _version}];
+	if (!dialect)
+		dialect = make_unique<EVMDialect>(_flavour, _objectAccess, _version);
+	return *dialect;
+}
+
 }
 
 EVMDialect::EVMDialect(AsmFlavour _flavour, bool _objectAccess, langutil::EVMVersion _evmVersion):
@@ -187,29 +212,17 @@ BuiltinFunctionForEVM const* EVMDialect::builtin(YulString _name) const
 
 EVMDialect const& EVMDialect::strictAssemblyForEVM(langutil::EVMVersion _version)
 {
-	static map<langutil::EVMVersion, unique_ptr<EVMDialect const>> dialects;
-	static YulStringRepository::ResetCallback callback{[&] { dialects.clear(); }};
-	if (!dialects[_version])
-		dialects[_version] = make_unique<EVMDialect>(AsmFlavour::Strict, false, _version);
-	return *dialects[_version];
+	return cachedDialect(AsmFlavour::Strict, false, _version);
 }
 
 EVMDialect const& EVMDialect::strictAssemblyForEVMObjects(langutil::EVMVersion _version)
 {
-	static map<langutil::EVMVersion, unique_ptr<EVMDialect const>> dialects;
-	static YulStringRepository::ResetCallback callback{[&] { dialects.clear(); }};
-	if (!dialects[_version])
-		dialects[_version] = make_unique<EVMDialect>(AsmFlavour::Strict, true, _version);
-	return *dialects[_version];
+	return cachedDialect(AsmFlavour::Strict, true, _version);
 }
 
 EVMDialect const& EVMDialect::yulForEVM(langutil::EVMVersion _version)
 {
-	static map<langutil::EVMVersion, unique_ptr<EVMDialect const>> dialects;
-	static YulStringRepository::ResetCallback callback{[&] { dialects.clear(); }};
-	if (!dialects[_version])
-		dialects[_version] = make_unique<EVMDialect>(AsmFlavour::Yul, false, _version);
-	return *dialects[_version];
+	return cachedDialect(AsmFlavour::Yul, false, _version);
 }
 
 SideEffects EVMDialect::sideEffectsOfInstruction(eth::Instruction _instruction)
@@ -20,6 +20,9 @@
 
 #include <libyul/backends/wasm/WasmDialect.h>
 
+#include <map>
+#include <mutex>
+
 using namespace std;
 using namespace yul;
 
@@ -96,8 +99,15 @@ BuiltinFunction const* WasmDialect::builtin(YulString _name) const
 
 WasmDialect const& WasmDialect::instance()
 {
-	static std::unique_ptr<WasmDialect> dialect;
-	static YulStringRepository::ResetCallback callback{[&] { dialect.reset(); }};
+	// The dialect stores YulStrings, so there is one per YulString repository.
+	static map<YulStringRepository const*, unique_ptr<WasmDialect>> dialects;
+	static mutex dialectMutex;
+	static YulStringRepository::ResetCallback callback{[](YulStringRepository const& _repository) {
+		lock_guard<mutex> lock(dialectMutex);
+		dialects.erase(&_repository);
+	}};
+	lock_guard<mutex> lock(dialectMutex);
+	auto& dialect = dialects[&YulStringRepository::instance()];
 	if (!dialect)
 		dialect = make_unique<WasmDialect>();
 	return *dialect;
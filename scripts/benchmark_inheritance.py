@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# Measures the time solc spends on name resolution and type checking for a
+# deep inheritance hierarchy: every contract inherits from the previous one
+# and its functions refer to state variables of all of its bases.
+#
+# Usage: scripts/benchmark_inheritance.py <path to solc> [--runs N] [--contracts N] ...
+# Prints the median wall time of the phases reported by "solc --stats".
+
+from argparse import ArgumentParser
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+DESCRIPTION = """Benchmark of the analysis of a deep inheritance hierarchy."""
+
+def generate_source(contracts, variables, functions):
+    lines = ["pragma solidity >=0.6.0;", ""]
+    for c in range(contracts):
+        base = " is C{}".format(c - 1) if c > 0 else ""
+        lines.append("contract C{}{} {{".format(c, base))
+        for v in range(variables):
+            lines.append("    uint v{}_{};".format(c, v))
+        # Spread the functions over the contracts, the last one gets the rest.
+        count = functions // contracts + (functions % contracts if c == contracts - 1 else 0)
+        for f in range(count):
+            # Refer to a variable of the contract itself and of a distant base.
+            other = (c * 7 + f) % (c + 1)
+            lines.append("    function f{}_{}() public view returns (uint) {{".format(c, f))
+            lines.append("        return v{}_{} + v{}_{};".format(c, f % variables, other, (f * 3) % variables))
+            lines.append("    }")
+        lines.append("}")
+    return "\n".join(lines) + "\n"
+
+def run_solc(solc, path):
+    output = subprocess.run(
+        [solc, "--stats", path],
+        stdout=subprocess.PIPE,
+        stderr=subprocess.STDOUT,
+        check=True,
+        universal_newlines=True
+    ).stdout
+    return json.loads(output[output.index("{"):])["phases"]
+
+def main():
+    parser = ArgumentParser(description=DESCRIPTION)
+    parser.add_argument("solc", help="path to the solc executable")
+    parser.add_argument("--runs", type=int, default=5, help="number of compilations to take the median of")
+    parser.add_argument("--contracts", type=int, default=40, help="depth of the inheritance hierarchy")
+    parser.add_argument("--variables", type=int, default=40, help="state variables per contract")
+    parser.add_argument("--functions", type=int, default=300, help="functions in total")
+    parser.add_argument("--output", help="also write the generated source to this file")
+    args = parser.parse_args()
+
+    source = generate_source(args.contracts, args.variables, args.functions)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(source)
+
+    fd, path = tempfile.mkstemp(suffix=".sol")
+    try:
+        with os.fdopen(fd, "w") as f:
+            f.write(source)
+        runs = [run_solc(args.solc, path) for _ in range(args.runs)]
+    finally:
+        os.remove(path)
+
+    for phase in ("parsing", "nameResolution", "analysis"):
+        times = [run[phase]["wallTime"] for run in runs if phase in run]
+        if times:
+            print("{}: {:.1f} ms".format(phase, statistics.median(times)))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
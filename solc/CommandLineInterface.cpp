@@ -61,6 +61,10 @@
 	#define fileno _fileno
 #else // unix
 	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <csignal>
+	#include <cstring>
 #endif
 
 #include <string>
@@ -104,6 +108,7 @@ static string const g_strAllowPaths = "allow-paths";
 static string const g_strAsm = "asm";
 static string const g_strAsmJson = "asm-json";
 static string const g_strAssemble = "assemble";
+static string const g_strCacheDir = "cache-dir";
 static string const g_strAst = "ast";
 static string const g_strAstJson = "ast-json";
 static string const g_strAstCompactJson = "ast-compact-json";
@@ -121,6 +126,7 @@ static string const g_strGas = "gas";
 static string const g_strHelp = "help";
 static string const g_strInputFile = "input-file";
 static string const g_strInterface = "interface";
+static string const g_strJobs = "jobs";
 static string const g_strYul = "yul";
 static string const g_strYulDialect = "yul-dialect";
 static string const g_strIR = "ir";
@@ -143,6 +149,7 @@ static string const g_strOptimizeYul = "optimize-yul";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
 static string const g_strRevertStrings = "revert-strings";
+static string const g_strServer = "server";
 
 /// Possible arguments to for --revert-strings
 static set<string> const g_revertStringsArgs
@@ -154,11 +161,13 @@ static set<string> const g_revertStringsArgs
 };
 
 static string const g_strSignatureHashes = "hashes";
+static string const g_strSocket = "socket";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
 static string const g_strSrcMap = "srcmap";
 static string const g_strSrcMapRuntime = "srcmap-runtime";
 static string const g_strStandardJSON = "standard-json";
+static string const g_strStats = "stats";
 static string const g_strStrictAssembly = "strict-assembly";
 static string const g_strSwarm = "swarm";
 static string const g_strPrettyJson = "pretty-json";
@@ -174,6 +183,7 @@ static string const g_argAllowPaths = g_strAllowPaths;
 static string const g_argAsm = g_strAsm;
 static string const g_argAsmJson = g_strAsmJson;
 static string const g_argAssemble = g_strAssemble;
+static string const g_argCacheDir = g_strCacheDir;
 static string const g_argAstCompactJson = g_strAstCompactJson;
 static string const g_argAstJson = g_strAstJson;
 static string const g_argBinary = g_strBinary;
@@ -186,6 +196,7 @@ static string const g_argHelp = g_strHelp;
 static string const g_argInputFile = g_strInputFile;
 static string const g_argYul = g_strYul;
 static string const g_argIR = g_strIR;
+static string const g_argJobs = g_strJobs;
 static string const g_argEwasm = g_strEwasm;
 static string const g_argLibraries = g_strLibraries;
 static string const g_argLink = g_strLink;
@@ -199,8 +210,11 @@ static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
 static string const g_argOutputDir = g_strOutputDir;
+static string const g_argServer = g_strServer;
 static string const g_argSignatureHashes = g_strSignatureHashes;
+static string const g_argSocket = g_strSocket;
 static string const g_argStandardJSON = g_strStandardJSON;
+static string const g_argStats = g_strStats;
 static string const g_argStrictAssembly = g_strStrictAssembly;
 static string const g_argVersion = g_strVersion;
 static string const g_stdinFileName = g_stdinFileNameStr;
@@ -451,6 +465,14 @@ void CommandLineInterface::handleNatspec(bool _natspecDev, string const& _contra
 	}
 }
 
+void CommandLineInterface::handleStatistics()
+{
+	if (!m_args.count(g_argStats))
+		return;
+
+	serr() << "Statistics:" << endl << dev::jsonPrettyPrint(m_compiler->statistics()) << endl;
+}
+
 void CommandLineInterface::handleGasEstimation(string const& _contract)
 {
 	Json::Value estimates = m_compiler->gasEstimates(_contract);
@@ -543,13 +565,13 @@ bool CommandLineInterface::readInputFilesAndConfigureRemappings()
 					continue;
 				}
 
-				m_sourceCodes[infile.generic_string()] = dev::readFileAsString(infile.string());
+				m_sourceCodes[infile.generic_string()] = CharStream::fromFile(infile.string(), infile.generic_string());
 				path = boost::filesystem::canonical(infile).string();
 			}
 			m_allowedDirectories.push_back(boost::filesystem::path(path).remove_filename());
 		}
 	if (addStdin)
-		m_sourceCodes[g_stdinFileName] = dev::readStandardInput();
+		m_sourceCodes[g_stdinFileName] = CharStream(dev::readStandardInput(), g_stdinFileName);
 	if (m_sourceCodes.size() == 0)
 	{
 		serr() << "No input files given. If you wish to use the standard input please specify \"-\" explicitly." << endl;
@@ -710,17 +732,45 @@ Allowed options)",
 			"If given, creates one file per component and contract/file at the specified directory."
 		)
 		(g_strOverwrite.c_str(), "Overwrite existing files (used together with -o).")
+		(
+			g_argCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Cache compilation artifacts of contracts in the given directory and reuse them "
+			"if neither the sources nor the settings changed."
+		)
+		(
+			(g_argJobs + ",j").c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Parse up to n sources and generate code for up to n independent contracts in parallel. "
+			"The output does not depend on this setting."
+		)
 		(
 			g_argCombinedJson.c_str(),
 			po::value<string>()->value_name(boost::join(g_combinedJsonArgs, ",")),
 			"Output a single json document containing the specified information."
 		)
 		(g_argGas.c_str(), "Print an estimate of the maximal gas usage for each function.")
+		(
+			g_argStats.c_str(),
+			"Print the time used by each compilation phase, in total and by contract, "
+			"together with the peak memory of the process and further statistics to the standard error output."
+		)
 		(
 			g_argStandardJSON.c_str(),
 			"Switch to Standard JSON input / output mode, ignoring all options. "
 			"It reads from standard input and provides the result on the standard output."
 		)
+		(
+			g_argServer.c_str(),
+			"Switch to Standard JSON server mode, ignoring all options except --allow-paths and --socket. "
+			"It answers a stream of requests on the standard input and output until the input ends. "
+			"Every request and response is preceded by its length in bytes as a decimal number and a newline."
+		)
+		(
+			g_argSocket.c_str(),
+			po::value<string>()->value_name("path"),
+			"Listen for connections on the given Unix domain socket in server mode instead of using the standard input."
+		)
 		(
 			g_argAssemble.c_str(),
 			"Switch to assembly mode, ignoring all options except --machine, --yul-dialect and --optimize and assumes input is assembly."
@@ -846,6 +896,12 @@ Allowed options)",
 		m_revertStrings = *revertStrings;
 	}
 
+	if (m_args[g_argJobs].as<unsigned>() == 0)
+	{
+		serr() << "Invalid option for --" << g_argJobs << ": has to be at least 1." << endl;
+		return false;
+	}
+
 	if (m_args.count(g_argCombinedJson))
 	{
 		vector<string> requests;
@@ -896,9 +952,7 @@ bool CommandLineInterface::processInput()
 			if (!boost::filesystem::is_regular_file(canonicalPath))
 				return ReadCallback::Result{false, "Not a valid file."};
 
-			auto contents = dev::readFileAsString(canonicalPath.string());
-			m_sourceCodes[path.generic_string()] = contents;
-			return ReadCallback::Result{true, contents};
+			return ReadCallback::Result{true, dev::readFileAsString(canonicalPath.string())};
 		}
 		catch (Exception const& _exception)
 		{
@@ -926,12 +980,18 @@ bool CommandLineInterface::processInput()
 		}
 	}
 
+	if (m_args.count(g_argServer))
+		return serve(fileReader);
+
 	if (m_args.count(g_argStandardJSON))
 	{
 		string input = dev::readStandardInput();
 		StandardCompiler compiler(fileReader);
-		sout() << compiler.compile(std::move(input)) << endl;
-		return true;
+		bool success = compiler.compile(input, sout());
+		sout() << endl;
+		if (!success)
+			serr() << "Internal error while writing the output." << endl;
+		return success;
 	}
 
 	if (!readInputFilesAndConfigureRemappings())
@@ -1064,10 +1124,18 @@ bool CommandLineInterface::processInput()
 			m_compiler->setMetadataHash(m_metadataHash);
 		if (m_args.count(g_argInputFile))
 			m_compiler->setRemappings(m_remappings);
-		m_compiler->setSources(m_sourceCodes);
+		vector<CharStream> sources;
+		for (auto const& sourceCode: m_sourceCodes)
+			sources.push_back(sourceCode.second);
+		m_compiler->setSourceStreams(std::move(sources));
 		if (m_args.count(g_argLibraries))
 			m_compiler->setLibraries(m_libraries);
 		m_compiler->setParserErrorRecovery(m_args.count(g_argErrorRecovery));
+		m_compiler->setParallelism(m_args[g_argJobs].as<unsigned>());
+		m_compiler->allowConcurrentReads();
+		if (m_args.count(g_argCacheDir))
+			m_compiler->setCacheDirectory(m_args[g_argCacheDir].as<string>());
+		m_compiler->enableStatistics(m_args.count(g_argStats));
 		m_compiler->setEVMVersion(m_evmVersion);
 		m_compiler->setRevertStringBehaviour(m_revertStrings);
 		// TODO: Perhaps we should not compile unless requested
@@ -1083,6 +1151,11 @@ bool CommandLineInterface::processInput()
 
 		bool successful = m_compiler->compile();
 
+		// Imported files are only read by the compiler, share its copy of their text.
+		for (string const& sourceName: m_compiler->sourceNames())
+			if (!m_sourceCodes.count(sourceName))
+				m_sourceCodes.emplace(sourceName, *m_compiler->scanner(sourceName).charStream());
+
 		for (auto const& error: m_compiler->errors())
 		{
 			g_hasOutput = true;
@@ -1166,6 +1239,7 @@ void CommandLineInterface::handleCombinedJSON()
 
 	if (!contracts.empty())
 		output[g_strContracts] = Json::Value(Json::objectValue);
+	StringMap const sourceCodes = requests.count(g_strAsm) ? sourceTexts() : StringMap{};
 	for (string const& contractName: contracts)
 	{
 		Json::Value& contractData = output[g_strContracts][contractName] = Json::objectValue;
@@ -1180,7 +1254,7 @@ void CommandLineInterface::handleCombinedJSON()
 		if (requests.count(g_strOpcodes) && m_compiler->compilationSuccessful())
 			contractData[g_strOpcodes] = dev::eth::disassemble(m_compiler->object(contractName).bytecode);
 		if (requests.count(g_strAsm) && m_compiler->compilationSuccessful())
-			contractData[g_strAsm] = m_compiler->assemblyJSON(contractName, m_sourceCodes);
+			contractData[g_strAsm] = m_compiler->assemblyJSON(contractName, sourceCodes);
 		if (requests.count(g_strSrcMap) && m_compiler->compilationSuccessful())
 		{
 			auto map = m_compiler->sourceMapping(contractName);
@@ -1286,7 +1360,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 bool CommandLineInterface::actOnInput()
 {
-	if (m_args.count(g_argStandardJSON) || m_onlyAssemble)
+	if (m_args.count(g_argStandardJSON) || m_args.count(g_argServer) || m_onlyAssemble)
 		// Already done in "processInput" phase.
 		return true;
 	else if (m_onlyLink)
@@ -1319,14 +1393,15 @@ bool CommandLineInterface::link()
 	}
 	for (auto& src: m_sourceCodes)
 	{
-		auto end = src.second.end();
-		for (auto it = src.second.begin(); it != end;)
+		string source(src.second.source());
+		auto end = source.end();
+		for (auto it = source.begin(); it != end;)
 		{
 			while (it != end && *it != '_') ++it;
 			if (it == end) break;
 			if (end - it < placeholderSize)
 			{
-				serr() << "Error in binary object file " << src.first << " at position " << (end - src.second.begin()) << endl;
+				serr() << "Error in binary object file " << src.first << " at position " << (end - source.begin()) << endl;
 				return false;
 			}
 
@@ -1342,22 +1417,31 @@ bool CommandLineInterface::link()
 		}
 		// Remove hints for resolved libraries.
 		for (auto const& library: m_libraries)
-			boost::algorithm::erase_all(src.second, "\n" + libraryPlaceholderHint(library.first));
-		while (!src.second.empty() && *prev(src.second.end()) == '\n')
-			src.second.resize(src.second.size() - 1);
+			boost::algorithm::erase_all(source, "\n" + libraryPlaceholderHint(library.first));
+		while (!source.empty() && *prev(source.end()) == '\n')
+			source.resize(source.size() - 1);
+		src.second = CharStream(std::move(source), src.first);
 	}
 	return true;
 }
 
+StringMap CommandLineInterface::sourceTexts() const
+{
+	StringMap texts;
+	for (auto const& sourceCode: m_sourceCodes)
+		texts[sourceCode.first] = string(sourceCode.second.source());
+	return texts;
+}
+
 void CommandLineInterface::writeLinkedFiles()
 {
 	for (auto const& src: m_sourceCodes)
 		if (src.first == g_stdinFileName)
-			sout() << src.second << endl;
+			sout() << src.second.source() << endl;
 		else
 		{
 			ofstream outFile(src.first);
-			outFile << src.second;
+			outFile << src.second.source();
 			if (!outFile)
 			{
 				serr() << "Could not write to file " << src.first << ". Aborting." << endl;
@@ -1384,6 +1468,185 @@ string CommandLineInterface::objectWithLinkRefsHex(eth::LinkerObject const& _obj
 	return out;
 }
 
+/// Maximum size of a request in server mode in bytes. Larger requests are skipped and answered
+/// with an error, so that a single malformed header cannot exhaust the memory of the server.
+static size_t const c_maxServerRequestSize = size_t(1) << 28;
+
+/// @returns a standard JSON output that only reports the error @a _message about a request.
+static string serverErrorResponse(string const& _message)
+{
+	Json::Value error(Json::objectValue);
+	error["type"] = "JSONError";
+	error["component"] = "general";
+	error["severity"] = "error";
+	error["message"] = _message;
+	error["formattedMessage"] = _message;
+	Json::Value output(Json::objectValue);
+	output["errors"].append(error);
+	return jsonCompactPrint(output);
+}
+
+/// Answers length-prefixed standard JSON requests read via @a _read with responses
+/// written via @a _write, until the input ends. Requests with a malformed or too large
+/// length are answered with an error and skipped.
+/// @returns false if the input ends within a request or a response cannot be written.
+static bool serveRequests(
+	StandardCompiler& _compiler,
+	function<bool(char*, size_t)> const& _read,
+	function<bool(string const&)> const& _write
+)
+{
+	auto respond = [&](string const& _response)
+	{
+		return _write(to_string(_response.size()) + "\n" + _response);
+	};
+	while (true)
+	{
+		string header;
+		bool endOfLine = false;
+		char c;
+		while (_read(&c, 1))
+		{
+			if (c == '\n')
+			{
+				endOfLine = true;
+				break;
+			}
+			// Longer headers are malformed anyway, there is no need to store them.
+			if (header.size() <= 20)
+				header += c;
+		}
+		if (!endOfLine)
+			return header.empty();
+
+		// The header cannot be trusted if it is not a number, hence the request is assumed to
+		// end with it and the next line is expected to be the header of the next request.
+		if (header.empty() || header.size() > 19 || !boost::all(header, boost::is_digit()))
+		{
+			if (!respond(serverErrorResponse("Malformed request header: Expected the length of the request in bytes.")))
+				return false;
+			continue;
+		}
+		unsigned long long size = stoull(header);
+		if (size > c_maxServerRequestSize)
+		{
+			for (unsigned long long remaining = size; remaining > 0;)
+			{
+				char buffer[4096];
+				size_t chunk = size_t(min<unsigned long long>(remaining, sizeof(buffer)));
+				if (!_read(buffer, chunk))
+					return false;
+				remaining -= chunk;
+			}
+			if (!respond(serverErrorResponse(
+				"Request too large: At most " + to_string(c_maxServerRequestSize) + " bytes are accepted."
+			)))
+				return false;
+			continue;
+		}
+
+		string request(size_t(size), '\0');
+		if (!request.empty() && !_read(&request[0], request.size()))
+			return false;
+		if (!respond(_compiler.compile(request)))
+			return false;
+	}
+}
+
+bool CommandLineInterface::serve(ReadCallback::Callback const& _fileReader)
+{
+	StandardCompiler compiler(_fileReader);
+	compiler.keepCachesWarm();
+
+	if (!m_args.count(g_argSocket))
+	{
+		bool success = serveRequests(
+			compiler,
+			[](char* _data, size_t _size) { return !!cin.read(_data, _size); },
+			[](string const& _data) { return !!(sout() << _data << flush); }
+		);
+		if (!success)
+			serr() << "Unexpected end of input in server mode." << endl;
+		return success;
+	}
+
+#if defined(_WIN32)
+	serr() << "--" << g_argSocket << " is not supported on this platform." << endl;
+	return false;
+#else
+	string const& path = m_args[g_argSocket].as<string>();
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path))
+	{
+		serr() << "Socket path too long: " << path << endl;
+		return false;
+	}
+	path.copy(address.sun_path, path.size());
+
+	int server = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(path.c_str());
+	if (
+		server < 0 ||
+		::bind(server, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0 ||
+		listen(server, 16) != 0
+	)
+	{
+		serr() << "Could not listen on socket " << path << ": " << strerror(errno) << endl;
+		return false;
+	}
+	// Clients closing their connection early must not terminate the server.
+	signal(SIGPIPE, SIG_IGN);
+
+	while (true)
+	{
+		int connection = accept(server, nullptr, nullptr);
+		if (connection < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			serr() << "Could not accept connection: " << strerror(errno) << endl;
+			close(server);
+			return false;
+		}
+		serveRequests(
+			compiler,
+			[&](char* _data, size_t _size)
+			{
+				while (_size > 0)
+				{
+					ssize_t count = read(connection, _data, _size);
+					if (count < 0 && errno == EINTR)
+						continue;
+					if (count <= 0)
+						return false;
+					_data += count;
+					_size -= size_t(count);
+				}
+				return true;
+			},
+			[&](string const& _data)
+			{
+				char const* data = _data.data();
+				size_t size = _data.size();
+				while (size > 0)
+				{
+					ssize_t count = write(connection, data, size);
+					if (count < 0 && errno == EINTR)
+						continue;
+					if (count <= 0)
+						return false;
+					data += count;
+					size -= size_t(count);
+				}
+				return true;
+			}
+		);
+		close(connection);
+	}
+#endif
+}
+
 bool CommandLineInterface::assemble(
 	yul::AssemblyStack::Language _language,
 	yul::AssemblyStack::Machine _targetMachine,
@@ -1401,7 +1664,7 @@ bool CommandLineInterface::assemble(
 		);
 		try
 		{
-			if (!stack.parseAndAnalyze(src.first, src.second))
+			if (!stack.parseAndAnalyze(src.first, string(src.second.source())))
 				successful = false;
 			else
 				stack.optimize();
@@ -1516,6 +1779,7 @@ void CommandLineInterface::outputCompilationResults()
 	// do we need AST output?
 	handleAst(g_argAstJson);
 	handleAst(g_argAstCompactJson);
+	handleStatistics();
 
 	if (!m_compiler->compilationSuccessful())
 	{
@@ -1524,6 +1788,7 @@ void CommandLineInterface::outputCompilationResults()
 	}
 
 	vector<string> contracts = m_compiler->contractNames();
+	StringMap const sourceCodes = m_args.count(g_argAsm) || m_args.count(g_argAsmJson) ? sourceTexts() : StringMap{};
 	for (string const& contract: contracts)
 	{
 		if (needsHumanTargetedStdout(m_args))
@@ -1534,9 +1799,9 @@ void CommandLineInterface::outputCompilationResults()
 		{
 			string ret;
 			if (m_args.count(g_argAsmJson))
-				ret = dev::jsonPrettyPrint(m_compiler->assemblyJSON(contract, m_sourceCodes));
+				ret = dev::jsonPrettyPrint(m_compiler->assemblyJSON(contract, sourceCodes));
 			else
-				ret = m_compiler->assemblyString(contract, m_sourceCodes);
+				ret = m_compiler->assemblyString(contract, sourceCodes);
 
 			if (m_args.count(g_argOutputDir))
 			{
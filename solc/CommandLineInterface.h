@@ -24,6 +24,7 @@
 #include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/interface/DebugSettings.h>
 #include <libyul/AssemblyStack.h>
+#include <liblangutil/CharStream.h>
 #include <liblangutil/EVMVersion.h>
 
 #include <boost/program_options.hpp>
@@ -60,6 +61,10 @@ private:
 
 	bool assemble(yul::AssemblyStack::Language _language, yul::AssemblyStack::Machine _targetMachine, bool _optimize);
 
+	/// Answers standard JSON requests from the standard input or the socket given by --socket
+	/// until the input ends.
+	bool serve(ReadCallback::Callback const& _fileReader);
+
 	void outputCompilationResults();
 
 	void handleCombinedJSON();
@@ -74,10 +79,13 @@ private:
 	void handleABI(std::string const& _contract);
 	void handleNatspec(bool _natspecDev, std::string const& _contract);
 	void handleGasEstimation(std::string const& _contract);
+	void handleStatistics();
 	void handleFormal();
 
 	/// Fills @a m_sourceCodes initially and @a m_redirects.
 	bool readInputFilesAndConfigureRemappings();
+	/// @returns a copy of the text of each source, as needed for the assembly output.
+	StringMap sourceTexts() const;
 	/// Tries to read from the file @a _input or interprets _input literally if that fails.
 	/// It then tries to parse the contents and appends to m_libraries.
 	bool parseLibraryOption(std::string const& _input);
@@ -100,8 +108,8 @@ private:
 
 	/// Compiler arguments variable map
 	boost::program_options::variables_map m_args;
-	/// map of input files to source code strings
-	std::map<std::string, std::string> m_sourceCodes;
+	/// map of input and imported files to their sources
+	std::map<std::string, langutil::CharStream> m_sourceCodes;
 	/// list of remappings
 	std::vector<dev::solidity::CompilerStack::Remapping> m_remappings;
 	/// list of allowed directories to read files from
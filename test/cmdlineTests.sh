@@ -437,6 +437,52 @@ SOLTMPDIR=$(mktemp -d)
     fi
 )
 
+printTask "Testing server mode..."
+SOLTMPDIR=$(mktemp -d)
+(
+    set -e
+    request='{"language": "Solidity", "sources": {"a.sol": {"content": "contract C {}"}}, "settings": {"outputSelection": {"*": {"*": ["evm.bytecode.object"]}}}}'
+
+    # Malformed and too large requests are answered with an error and skipped.
+    {
+        printf 'abc\n\n99999999999999999999\n'
+        printf '268435457\n'
+        head -c 268435457 /dev/zero
+        printf '%s\n%s' "${#request}" "$request"
+    } | "$SOLC" --server > "$SOLTMPDIR/output"
+    [[ $(grep -o "\"message\":\"Malformed request header" "$SOLTMPDIR/output" | wc -l) == 3 ]]
+    grep -q "Request too large" "$SOLTMPDIR/output"
+    grep -q '"object":"' "$SOLTMPDIR/output"
+
+    "$SOLC" --server --socket "$SOLTMPDIR/socket" &
+    server=$!
+    for i in $(seq 100); do [[ -S "$SOLTMPDIR/socket" ]] && break; sleep 0.1; done
+    set +e
+    python3 - "$SOLTMPDIR/socket" "$request" <<'EOF'
+import socket
+import sys
+
+client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+client.connect(sys.argv[1])
+request = sys.argv[2].encode()
+client.sendall(b'x\n' + str(len(request)).encode() + b'\n' + request)
+client.shutdown(socket.SHUT_WR)
+output = b''
+while True:
+    data = client.recv(65536)
+    if not data:
+        break
+    output += data
+assert b'Malformed request header' in output, output
+assert b'"object":"' in output, output
+EOF
+    result=$?
+    kill $server
+    wait $server
+    exit $result
+)
+rm -rf "$SOLTMPDIR"
+
 printTask "Testing soljson via the fuzzer..."
 SOLTMPDIR=$(mktemp -d)
 (
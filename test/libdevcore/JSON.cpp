@@ -21,6 +21,8 @@
 
 #include <libdevcore/JSON.h>
 
+#include <sstream>
+
 #include <test/Options.h>
 
 using namespace std;
@@ -104,6 +106,37 @@ BOOST_AUTO_TEST_CASE(parse_json_strict)
 	BOOST_CHECK(json[0] == "\x80\xec\x80");
 }
 
+BOOST_AUTO_TEST_CASE(json_object_stream_writer)
+{
+	Json::Value json;
+	json["1"] = 1;
+	json["2"]["2.1"]["2.1.1"] = "a";
+	json["2"]["2.1"]["2.1.2"] = Json::arrayValue;
+	json["2"]["2.2"] = "\"";
+	json["3"] = Json::objectValue;
+	json["4"]["4.1"] = true;
+
+	std::stringstream stream;
+	JsonObjectStreamWriter writer(stream);
+	BOOST_CHECK(writer.write({"1"}, 1));
+	BOOST_CHECK(writer.write({"2", "2.1", "2.1.1"}, "a"));
+	BOOST_CHECK(writer.write({"2", "2.1", "2.1.2"}, Json::arrayValue));
+	BOOST_CHECK(writer.write({"2", "2.2"}, "\""));
+	BOOST_CHECK(writer.write({"3"}, Json::objectValue));
+	// Members have to be written in order and not into values written before.
+	BOOST_CHECK(!writer.write({"2", "2.3"}, 0));
+	BOOST_CHECK(!writer.write({"3", "3.1"}, 0));
+	BOOST_CHECK(writer.write({"4", "4.1"}, true));
+	writer.finish();
+	BOOST_CHECK(!writer.write({"5"}, 0));
+
+	BOOST_CHECK_EQUAL(stream.str(), jsonCompactPrint(json));
+
+	std::stringstream emptyStream;
+	JsonObjectStreamWriter(emptyStream).finish();
+	BOOST_CHECK_EQUAL(emptyStream.str(), "{}");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -25,6 +25,10 @@
 
 #include <test/Options.h>
 
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
 namespace langutil
 {
 namespace test
@@ -47,6 +51,81 @@ BOOST_AUTO_TEST_CASE(test_fail)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(translate_position)
+{
+	CharStream const source("ab\ncd\n\nef", "source");
+
+	BOOST_CHECK(source.translatePositionToLineColumn(0) == std::make_tuple(0, 0));
+	BOOST_CHECK(source.translatePositionToLineColumn(2) == std::make_tuple(0, 2));
+	BOOST_CHECK(source.translatePositionToLineColumn(3) == std::make_tuple(1, 0));
+	BOOST_CHECK(source.translatePositionToLineColumn(6) == std::make_tuple(2, 0));
+	BOOST_CHECK(source.translatePositionToLineColumn(8) == std::make_tuple(3, 1));
+	BOOST_CHECK(source.translatePositionToLineColumn(100) == std::make_tuple(3, 2));
+
+	BOOST_CHECK_EQUAL(source.lineAtPosition(1), "ab");
+	BOOST_CHECK_EQUAL(source.lineAtPosition(2), "ab");
+	BOOST_CHECK_EQUAL(source.lineAtPosition(4), "cd");
+	BOOST_CHECK_EQUAL(source.lineAtPosition(6), "");
+	BOOST_CHECK_EQUAL(source.lineAtPosition(7), "ef");
+	BOOST_CHECK_EQUAL(source.lineAtPosition(100), "ef");
+}
+
+BOOST_AUTO_TEST_CASE(shared_source)
+{
+	CharStream const source(std::string("contract C {}"), "source");
+	CharStream copy = source;
+	BOOST_CHECK(copy.source().data() == source.source().data());
+	CharStream moved = std::move(copy);
+	BOOST_CHECK(moved.source().data() == source.source().data());
+	BOOST_CHECK_EQUAL(moved.name(), "source");
+	BOOST_CHECK('\0' == moved.setPosition(13));
+}
+
+BOOST_AUTO_TEST_CASE(from_file)
+{
+	boost::filesystem::path const file =
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("solc-charstream-%%%%-%%%%-%%%%.sol");
+	std::ofstream(file.string()) << "ab\ncd";
+	{
+		CharStream const source = CharStream::fromFile(file.string(), "a.sol");
+		BOOST_CHECK_EQUAL(std::string(source.source()), "ab\ncd");
+		BOOST_CHECK_EQUAL(source.name(), "a.sol");
+		BOOST_CHECK(source.translatePositionToLineColumn(4) == std::make_tuple(1, 1));
+		CharStream const copy = source;
+		BOOST_CHECK(copy.source().data() == source.source().data());
+	}
+	std::ofstream(file.string(), std::ios::trunc);
+	BOOST_CHECK(CharStream::fromFile(file.string(), "a.sol").source().empty());
+	boost::filesystem::remove(file);
+}
+
+BOOST_AUTO_TEST_CASE(from_index)
+{
+	uint32_t index = 0;
+	{
+		CharStream const source("contract C {}", "source");
+		index = source.index();
+		BOOST_CHECK(CharStream::fromIndex(index) == &source);
+		CharStream const copy = source;
+		BOOST_CHECK(copy.index() != index);
+		BOOST_CHECK(CharStream::fromIndex(copy.index()) == &copy);
+	}
+	BOOST_CHECK(CharStream::fromIndex(index) == nullptr);
+	BOOST_CHECK(CharStream::fromIndex(0) == nullptr);
+
+	// Create and destroy enough streams for the storage of the first ones to be reused.
+	CharStream const kept("", "kept");
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		CharStream const stream("", "");
+		BOOST_REQUIRE(CharStream::fromIndex(stream.index()) == &stream);
+	}
+	BOOST_CHECK(CharStream::fromIndex(index) == nullptr);
+	BOOST_CHECK(CharStream::fromIndex(kept.index()) == &kept);
+	BOOST_CHECK(CharStream::fromIndex(kept.index() + 5000) == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
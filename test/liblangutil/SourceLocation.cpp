@@ -45,6 +45,25 @@ BOOST_AUTO_TEST_CASE(test_fail)
 	BOOST_CHECK((SourceLocation{3, 7, sourceA} < SourceLocation{4, 6, sourceB}));
 }
 
+BOOST_AUTO_TEST_CASE(source_reference)
+{
+	BOOST_CHECK(sizeof(SourceLocation) <= 3 * sizeof(int));
+
+	auto source = std::make_shared<CharStream>("abc", "source");
+	SourceLocation location{1, 2, source};
+	BOOST_REQUIRE(location.source);
+	BOOST_CHECK_EQUAL(location.source->name(), "source");
+	BOOST_CHECK_EQUAL(location.text(), "b");
+
+	// A copy of the stream is a different source.
+	auto copy = std::make_shared<CharStream>(*source);
+	BOOST_CHECK((location != SourceLocation{1, 2, copy}));
+
+	source.reset();
+	BOOST_CHECK(!location.source);
+	BOOST_CHECK((location == SourceLocation{1, 2, location.source}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
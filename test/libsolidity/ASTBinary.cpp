@@ -0,0 +1,282 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the binary encoding of the AST.
+ */
+
+#include <test/Options.h>
+
+#include <liblangutil/Exceptions.h>
+#include <liblangutil/Scanner.h>
+#include <libsolidity/analysis/GlobalContext.h>
+#include <libsolidity/ast/ASTBinary.h>
+#include <libsolidity/ast/ASTJsonConverter.h>
+#include <libsolidity/ast/ASTVisitor.h>
+#include <libsolidity/ast/TypeProvider.h>
+#include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/interface/Version.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Keccak256.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace std;
+using namespace langutil;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+string const c_library = R"(
+	pragma solidity >=0.0;
+	pragma experimental ABIEncoderV2;
+	/// @title Library
+	library L {
+		struct S { uint a; mapping(uint => bytes32[]) m; }
+		enum E { A, B }
+		function f(uint x) internal pure returns (uint y, bool) {
+			assembly { y := add(x, 1) }
+			for (uint i = 0; i < 3; ++i) { if (i == 1) continue; else break; }
+			do { x--; } while (x > 10);
+			(y, ) = (x * 2 ether + 1 days, true);
+			return (y, !false);
+		}
+	}
+	interface I { function g() external returns (uint); }
+	abstract contract Base {
+		modifier m(uint a) virtual { require(a > 0, "a"); _; }
+		function h() public view virtual returns (uint);
+	}
+	contract C is Base {
+		using L for uint;
+		event Ev(uint indexed x, string) anonymous;
+		uint constant k = 0x12;
+		function(uint) internal pure returns (uint, bool) v = L.f;
+		constructor() public { v(k); }
+		function h() public view override m(1) returns (uint) { return address(this).balance; }
+		function t(I _i, bytes calldata _b) external returns (bytes memory) {
+			uint[] memory a = new uint[](2);
+			a[0] = k > 1 ? uint8(2) : 3;
+			try _i.g() returns (uint x) { emit Ev(x, "y"); } catch Error(string memory) {} catch (bytes memory e) { return e; }
+			return bytes(_b[1:]);
+		}
+		receive() external payable {}
+	}
+)";
+
+string const c_main = R"(
+	pragma solidity >=0.0;
+	import "lib.sol" as Lib;
+	import {C as D} from "lib.sol";
+	contract M is D { function u() public pure returns (uint x) { (x, ) = Lib.L.f(2); } }
+)";
+
+string const c_base = R"(
+	pragma solidity >=0.0;
+	contract B { function g() public pure virtual returns (uint) { return 1; } }
+)";
+
+string const c_derived = R"(
+	pragma solidity >=0.0;
+	import "base.sol";
+	contract A is B { function f() public { uint x; } }
+)";
+
+}
+
+BOOST_AUTO_TEST_SUITE(ASTBinary)
+
+namespace
+{
+
+/// The outputs of a compilation that have to be the same for parsed and loaded sources.
+struct Outputs
+{
+	map<string, string> asts;
+	map<string, bytes> bytecodes;
+	map<string, string> metadata;
+};
+
+Outputs compile(StringMap const& _sources, vector<string> const& _encodedASTs = {}, string* _encodedLibrary = nullptr)
+{
+	// Only one compiler stack can use the type provider of a thread at a time.
+	CompilerStack compiler;
+	compiler.setSources(_sources);
+	for (string const& encodedAST: _encodedASTs)
+		compiler.addEncodedAST(encodedAST);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE_MESSAGE(compiler.compile(), "Compiling contract failed");
+
+	Outputs outputs;
+	for (string const& source: compiler.sourceNames())
+		outputs.asts[source] = jsonCompactPrint(
+			ASTJsonConverter(false, compiler.sourceIndices()).toJson(compiler.ast(source))
+		);
+	for (string const& contract: compiler.contractNames())
+	{
+		outputs.bytecodes[contract] = compiler.object(contract).bytecode;
+		outputs.metadata[contract] = compiler.metadata(contract);
+	}
+	if (_encodedLibrary)
+		*_encodedLibrary = compiler.encodedAST("lib.sol");
+	return outputs;
+}
+
+/// Compiles @a _sources and @returns the number of warnings in @a _sourceName.
+size_t warningsIn(
+	string const& _sourceName,
+	StringMap const& _sources,
+	vector<string> const& _encodedASTs,
+	EVMVersion _evmVersion,
+	string* _encoded = nullptr
+)
+{
+	CompilerStack compiler;
+	compiler.setSources(_sources);
+	for (string const& encodedAST: _encodedASTs)
+		compiler.addEncodedAST(encodedAST);
+	compiler.setEVMVersion(_evmVersion);
+	BOOST_REQUIRE_MESSAGE(compiler.compile(), "Compiling contract failed");
+	if (_encoded)
+		*_encoded = compiler.encodedAST(_sourceName);
+
+	size_t warnings = 0;
+	for (auto const& error: compiler.errors())
+	{
+		SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+		if (location && location->source && location->source->name() == _sourceName)
+			++warnings;
+	}
+	return warnings;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+	string encodedLibrary;
+	Outputs original = compile({{"lib.sol", c_library}, {"main.sol", c_main}}, {}, &encodedLibrary);
+	Outputs imported = compile({{"main.sol", c_main}}, {encodedLibrary});
+
+	BOOST_CHECK(imported.asts == original.asts);
+	BOOST_CHECK(imported.bytecodes == original.bytecodes);
+	BOOST_CHECK(imported.metadata == original.metadata);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_encoding)
+{
+	string encoded;
+	compile({{"lib.sol", c_library}}, {}, &encoded);
+
+	string otherVersion = encoded;
+	otherVersion[otherVersion.find(VersionString)] ^= 1;
+	{
+		CompilerStack compiler;
+		BOOST_CHECK_THROW(compiler.addEncodedAST(otherVersion), CompilerError);
+		BOOST_CHECK_THROW(compiler.addEncodedAST(encoded.substr(0, 4)), CompilerError);
+	}
+
+	CompilerStack truncated;
+	truncated.addEncodedAST(encoded.substr(0, encoded.size() - 1));
+	BOOST_CHECK(!truncated.parse());
+}
+
+BOOST_AUTO_TEST_CASE(analysis_skipped)
+{
+	EVMVersion const evmVersion = dev::test::Options::get().evmVersion();
+	string encoded;
+	BOOST_REQUIRE(warningsIn("derived.sol", {{"base.sol", c_base}, {"derived.sol", c_derived}}, {}, evmVersion, &encoded) > 0);
+
+	// The loaded source is not analysed again, so its warnings are not reported again.
+	BOOST_CHECK_EQUAL(warningsIn("derived.sol", {{"base.sol", c_base}}, {encoded}, evmVersion), 0);
+
+	// It is analysed again if a source it imports or the EVM version changed.
+	string const changedBase = c_base.substr(0, c_base.find("return 1;")) + "return 2; } }";
+	BOOST_CHECK(warningsIn("derived.sol", {{"base.sol", changedBase}}, {encoded}, evmVersion) > 0);
+	EVMVersion const otherVersion = evmVersion == EVMVersion::byzantium() ? EVMVersion::petersburg() : EVMVersion::byzantium();
+	BOOST_CHECK(warningsIn("derived.sol", {{"base.sol", c_base}}, {encoded}, otherVersion) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_input)
+{
+	EVMVersion const evmVersion = dev::test::Options::get().evmVersion();
+	CompilerStack compiler;
+	compiler.setSources({{"lib.sol", c_library}, {"main.sol", c_main}});
+	compiler.setEVMVersion(evmVersion);
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+
+	ASTBinaryContext context;
+	context.evmVersion = evmVersion;
+	context.sources["lib.sol"] = {&compiler.ast("lib.sol"), keccak256(c_library)};
+
+	// Truncated and corrupted encodings may only be rejected with ASTBinaryError.
+	mt19937 random(1);
+	for (string const sourceName: {"lib.sol", "main.sol"})
+	{
+		string const encoded = compiler.encodedAST(sourceName);
+		for (size_t i = 0; i < 200; ++i)
+		{
+			string data = encoded;
+			if (i % 5 == 0)
+				data.resize(random() % data.size());
+			else
+				for (size_t changes = 1 + random() % 3; changes > 0; --changes)
+					data[random() % data.size()] = char(random());
+
+			GlobalContext globalContext;
+			context.globalContext = &globalContext;
+			ASTPointer<SourceUnit> sourceUnit;
+			try
+			{
+				auto scanner = make_shared<Scanner>(CharStream(ASTBinaryReader::sourceContent(data), sourceName));
+				sourceUnit = ASTBinaryReader::read(data, scanner, evmVersion);
+				for (auto const& node: sourceUnit->nodes())
+					if (auto import = dynamic_cast<ImportDirective const*>(node.get()))
+						import->annotation().absolutePath = import->path();
+				ASTBinaryReader::readAnnotations(data, *sourceUnit, context);
+			}
+			catch (ASTBinaryError const&)
+			{
+			}
+
+			if (sourceUnit)
+			{
+				set<ASTNode const*> nodes;
+				SimpleASTVisitor collector([&](ASTNode const& _node) { nodes.insert(&_node); return true; }, [](ASTNode const&) {});
+				sourceUnit->accept(collector);
+				TypeProvider::removeTypesReferringTo(nodes);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
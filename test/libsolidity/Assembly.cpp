@@ -110,7 +110,7 @@ void printAssemblyLocations(AssemblyItems const& _items)
 			", " <<
 			_loc.end <<
 			", make_shared<string>(\"" <<
-			_loc.source->name() <<
+			(_loc.source ? _loc.source->name() : "") <<
 			"\"))) +" << endl;
 	};
 
@@ -28,6 +28,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 
 using namespace std;
@@ -55,6 +58,59 @@ BOOST_AUTO_TEST_CASE(remappings)
 	BOOST_CHECK(c.compile());
 }
 
+BOOST_AUTO_TEST_CASE(concurrent_read_callback)
+{
+	StringMap const files{
+		{"b.sol", "import \"d.sol\"; contract B is D {} pragma solidity >=0.0;"},
+		{"c.sol", "import \"d.sol\"; contract C is D {} pragma solidity >=0.0;"},
+		{"d.sol", "contract D { function f() public pure {} } pragma solidity >=0.0;"}
+	};
+	StringMap const sources{{"a.sol", "import \"b.sol\"; import \"c.sol\"; contract A is B, C {} pragma solidity >=0.0;"}};
+
+	// The reads of b.sol and c.sol wait for each other to check that they overlap.
+	mutex readMutex;
+	condition_variable readStarted;
+	size_t activeReads = 0;
+	bool overlapped = false;
+	map<string, size_t> readCounts;
+	ReadCallback::Callback readFile = [&](string const& _kind, string const& _path)
+	{
+		BOOST_REQUIRE_EQUAL(_kind, ReadCallback::kindString(ReadCallback::Kind::ReadFile));
+		unique_lock<mutex> lock(readMutex);
+		++readCounts[_path];
+		++activeReads;
+		readStarted.notify_all();
+		if (_path != "d.sol" && readStarted.wait_for(lock, chrono::seconds(10), [&]() { return activeReads > 1 || overlapped; }))
+			overlapped = true;
+		--activeReads;
+		if (!files.count(_path))
+			return ReadCallback::Result{false, "File not found."};
+		return ReadCallback::Result{true, files.at(_path)};
+	};
+
+	bytes sequentialBytecode;
+	{
+		CompilerStack c(readFile);
+		c.setSources(sources);
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		overlapped = true;
+		BOOST_REQUIRE(c.compile());
+		sequentialBytecode = c.object("A").bytecode;
+	}
+
+	overlapped = false;
+	readCounts.clear();
+	CompilerStack c(readFile);
+	c.setSources(sources);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	c.setParallelism(4);
+	c.allowConcurrentReads();
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK(overlapped);
+	BOOST_CHECK((readCounts == map<string, size_t>{{"b.sol", 1}, {"c.sol", 1}, {"d.sol", 1}}));
+	BOOST_CHECK(c.object("A").bytecode == sequentialBytecode);
+}
+
 BOOST_AUTO_TEST_CASE(context_dependent_remappings)
 {
 	CompilerStack c;
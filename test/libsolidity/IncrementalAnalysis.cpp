@@ -0,0 +1,258 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for re-analysing changed sources in a long-lived compiler stack.
+ */
+
+#include <test/Options.h>
+
+#include <liblangutil/Exceptions.h>
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/TypeProvider.h>
+#include <libsolidity/interface/CompilerStack.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+using namespace std;
+using namespace langutil;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+StringMap const c_sources{
+	{"a.sol", "pragma solidity >=0.0; contract A { function f() public pure returns (uint) { return 1; } }"},
+	{"b.sol", "pragma solidity >=0.0; import \"a.sol\"; contract B is A { function g() public pure returns (uint) { return f(); } }"},
+	{"c.sol", "pragma solidity >=0.0; contract C { function h() public pure { uint x; } }"}
+};
+
+string const c_editedSource =
+	"pragma solidity >=0.0;\n"
+	"contract D {\n"
+	"	function f() public pure returns (uint) { return 1; }\n"
+	"	function g() public pure returns (uint r) { assembly { r := 7 } }\n"
+	"	function h() public pure { uint x; }\n"
+	"}\n";
+
+/// @returns the number of errors of the given type that refer to a source,
+/// i.e. ignoring the pre-release warning.
+size_t countErrors(CompilerStack const& _compiler, Error::Type _type)
+{
+	size_t count = 0;
+	for (auto const& error: _compiler.errors())
+	{
+		SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+		if (error->type() == _type && location && location->source)
+			++count;
+	}
+	return count;
+}
+
+/// @returns the location of the first error of the given type that refers to a source.
+SourceLocation errorLocation(CompilerStack const& _compiler, Error::Type _type)
+{
+	for (auto const& error: _compiler.errors())
+	{
+		SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+		if (error->type() == _type && location && location->source)
+			return *location;
+	}
+	return {};
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(IncrementalAnalysis)
+
+BOOST_AUTO_TEST_CASE(unaffected_sources_are_kept)
+{
+	CompilerStack compiler;
+	compiler.setSources(c_sources);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	SourceUnit const* a = &compiler.ast("a.sol");
+	SourceUnit const* c = &compiler.ast("c.sol");
+
+	compiler.updateSources({
+		{"b.sol", "pragma solidity >=0.0; import \"a.sol\"; contract B is A { function g() public pure returns (uint) { return f() + 1; } }"}
+	});
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	BOOST_CHECK_EQUAL(a, &compiler.ast("a.sol"));
+	BOOST_CHECK_EQUAL(c, &compiler.ast("c.sol"));
+	// The unused variable warning of c.sol is kept, but not duplicated.
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::Warning), 1);
+	BOOST_CHECK(compiler.compile());
+	BOOST_CHECK(!compiler.object("B").bytecode.empty());
+}
+
+BOOST_AUTO_TEST_CASE(same_bytecode_as_fresh_compilation)
+{
+	StringMap changed{
+		{"a.sol", "pragma solidity >=0.0; contract A { function f() public pure returns (uint) { return 2; } }"}
+	};
+	bytes freshBytecode;
+	{
+		StringMap sources = c_sources;
+		sources["a.sol"] = changed["a.sol"];
+		CompilerStack compiler;
+		compiler.setSources(sources);
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		BOOST_REQUIRE(compiler.compile());
+		freshBytecode = compiler.object("B").bytecode;
+	}
+
+	CompilerStack compiler;
+	compiler.setSources(c_sources);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.compile());
+	compiler.updateSources(changed);
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK(compiler.object("B").bytecode == freshBytecode);
+}
+
+BOOST_AUTO_TEST_CASE(types_of_removed_sources_are_dropped)
+{
+	CompilerStack compiler;
+	compiler.setSources(c_sources);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+
+	// Changes the function type of g, the types of its body and the types of B and its members.
+	auto update = [&](string const& _returnType)
+	{
+		compiler.updateSources({{
+			"b.sol",
+			"pragma solidity >=0.0; import \"a.sol\"; contract B is A { struct S { " + _returnType + " x; } "
+			"function g(S memory _s) internal pure returns (" + _returnType + ") { return _s.x; } }"
+		}});
+		BOOST_REQUIRE(compiler.parseAndAnalyze());
+	};
+	update("bool");
+	update("address");
+	size_t const typeCount = TypeProvider::typeCount();
+	for (size_t i = 0; i < 4; ++i)
+		update(i % 2 ? "address" : "bool");
+	BOOST_CHECK_EQUAL(TypeProvider::typeCount(), typeCount);
+}
+
+BOOST_AUTO_TEST_CASE(importers_are_reanalysed)
+{
+	CompilerStack compiler;
+	compiler.setSources(c_sources);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	SourceUnit const* c = &compiler.ast("c.sol");
+
+	compiler.updateSources({{"a.sol", "pragma solidity >=0.0; contract A {}"}});
+	BOOST_CHECK(!compiler.parseAndAnalyze());
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::DeclarationError), 1);
+	BOOST_CHECK_EQUAL(c, &compiler.ast("c.sol"));
+
+	// After an error, everything is analysed again.
+	compiler.updateSources({{"a.sol", c_sources.at("a.sol")}});
+	BOOST_CHECK(compiler.parseAndAnalyze());
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::DeclarationError), 0);
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::Warning), 1);
+}
+
+BOOST_AUTO_TEST_CASE(edited_function_is_parsed_again)
+{
+	string source = c_editedSource;
+	size_t const position = source.find("1;");
+	source.replace(position, 1, "1 + 2");
+	bytes freshBytecode;
+	string freshSourceMapping;
+	SourceLocation freshWarningLocation;
+	{
+		CompilerStack compiler;
+		compiler.setSources({{"d.sol", source}});
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		BOOST_REQUIRE(compiler.compile());
+		freshBytecode = compiler.object("D").bytecode;
+		freshSourceMapping = *compiler.sourceMapping("D");
+		BOOST_REQUIRE_EQUAL(countErrors(compiler, Error::Type::Warning), 1);
+		freshWarningLocation = errorLocation(compiler, Error::Type::Warning);
+	}
+
+	CompilerStack compiler;
+	compiler.setSources({{"d.sol", c_editedSource}});
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.compile());
+	SourceUnit const* sourceUnit = &compiler.ast("d.sol");
+	auto const* contract = dynamic_cast<ContractDefinition const*>(sourceUnit->nodes().back().get());
+	BOOST_REQUIRE(contract);
+	vector<ASTPointer<ASTNode>> functions = contract->subNodes();
+
+	compiler.editSource("d.sol", position, position + 1, "1 + 2");
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK_EQUAL(sourceUnit, &compiler.ast("d.sol"));
+	BOOST_REQUIRE_EQUAL(contract->subNodes().size(), 3);
+	BOOST_CHECK(contract->subNodes()[0] != functions[0]);
+	BOOST_CHECK(contract->subNodes()[1] == functions[1]);
+	BOOST_CHECK(contract->subNodes()[2] == functions[2]);
+	BOOST_CHECK(compiler.object("D").bytecode == freshBytecode);
+	BOOST_CHECK_EQUAL(*compiler.sourceMapping("D"), freshSourceMapping);
+	BOOST_REQUIRE_EQUAL(countErrors(compiler, Error::Type::Warning), 1);
+	SourceLocation warningLocation = errorLocation(compiler, Error::Type::Warning);
+	BOOST_CHECK_EQUAL(warningLocation.start, freshWarningLocation.start);
+	BOOST_CHECK_EQUAL(warningLocation.end, freshWarningLocation.end);
+}
+
+BOOST_AUTO_TEST_CASE(edit_with_syntax_error)
+{
+	bytes freshBytecode;
+	{
+		CompilerStack compiler;
+		compiler.setSources({{"d.sol", c_editedSource}});
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		BOOST_REQUIRE(compiler.compile());
+		freshBytecode = compiler.object("D").bytecode;
+	}
+
+	CompilerStack compiler;
+	compiler.setSources({{"d.sol", c_editedSource}});
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(compiler.parseAndAnalyze());
+	size_t const position = c_editedSource.find("1;") + 1;
+
+	// The whole source is parsed again after the element could not be parsed.
+	compiler.editSource("d.sol", position, position + 1, "");
+	BOOST_CHECK(!compiler.parseAndAnalyze());
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::ParserError), 1);
+
+	compiler.editSource("d.sol", position, position, ";");
+	BOOST_REQUIRE(compiler.compile());
+	BOOST_CHECK_EQUAL(countErrors(compiler, Error::Type::ParserError), 0);
+	BOOST_CHECK(compiler.object("D").bytecode == freshBytecode);
+
+	BOOST_CHECK_THROW(compiler.editSource("e.sol", 0, 0, ""), CompilerError);
+	BOOST_CHECK_THROW(compiler.editSource("d.sol", 1, 0, ""), CompilerError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
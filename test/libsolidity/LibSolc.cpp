@@ -19,7 +19,12 @@
  * Unit tests for libsolc/libsolc.cpp.
  */
 
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <boost/test/unit_test.hpp>
 #include <libdevcore/JSON.h>
 #include <libsolidity/interface/ReadFile.h>
@@ -182,6 +187,273 @@ BOOST_AUTO_TEST_CASE(with_callback)
 	BOOST_CHECK(containsError(result, "ParserError", "Source \"notfound.sol\" not found: Callback not supported."));
 }
 
+BOOST_AUTO_TEST_CASE(compiler_handle)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"fileA": {
+				"content": "import \"fileB\"; contract A is B { function f() public pure returns (uint) { return 1; } }"
+			}
+		},
+		"settings": {
+			"outputSelection": { "*": { "*": ["evm.bytecode.object", "abi"] } }
+		}
+	}
+	)";
+	auto compileWith = [&](SolidityCompiler* _compiler) {
+		size_t length = 0;
+		char const* output = solidity_compiler_compile(_compiler, input, &length);
+		BOOST_REQUIRE(output != nullptr);
+		BOOST_CHECK_EQUAL(strlen(output), length);
+		Json::Value ret;
+		BOOST_REQUIRE(jsonParseStrict(string(output, length), ret));
+		return ret;
+	};
+
+	SolidityCompiler* compiler = solidity_compiler_create(nullptr, nullptr);
+	BOOST_REQUIRE(compiler != nullptr);
+	BOOST_CHECK(!solidity_compiler_update_sources(compiler, "[]"));
+	BOOST_CHECK(solidity_compiler_update_sources(compiler, R"({"fileB": {"content": "contract B {}"}})"));
+	Json::Value result = compileWith(compiler);
+	BOOST_CHECK(!result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+
+	// A second compiler in between has its own sources.
+	SolidityCompiler* other = solidity_compiler_create(nullptr, nullptr);
+	BOOST_REQUIRE(other != nullptr);
+	Json::Value otherResult = compileWith(other);
+	BOOST_CHECK(containsError(otherResult, "ParserError", "Source \"fileB\" not found: File not supplied initially."));
+	solidity_compiler_destroy(other);
+
+	// Only the changed source is supplied.
+	BOOST_CHECK(solidity_compiler_update_sources(compiler, R"({"fileB": {"content": "contract B { function g() public {} }"}})"));
+	result = compileWith(compiler);
+	BOOST_CHECK_EQUAL(result["contracts"]["fileA"]["A"]["abi"].size(), 2);
+
+	// The result is the same as the one of a fresh compilation.
+	Json::Value fullInput;
+	BOOST_REQUIRE(jsonParseStrict(input, fullInput));
+	fullInput["sources"]["fileB"]["content"] = "contract B { function g() public {} }";
+	Json::Value fresh = compile(jsonCompactPrint(fullInput));
+	BOOST_CHECK_EQUAL(
+		result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString(),
+		fresh["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString()
+	);
+
+	// Removing a source that is still imported is reported.
+	BOOST_CHECK(solidity_compiler_update_sources(compiler, R"({"fileB": null})"));
+	result = compileWith(compiler);
+	BOOST_CHECK(containsError(result, "ParserError", "Source \"fileB\" not found: File not supplied initially."));
+	solidity_compiler_destroy(compiler);
+}
+
+BOOST_AUTO_TEST_CASE(compiler_handle_changed_import)
+{
+	struct Context
+	{
+		bool found = true;
+		string fileB = "contract B {}";
+	};
+	CStyleReadFileCallback callback = [](void* _context, char const*, char const*, char** o_contents, char** o_error)
+	{
+		Context& context = *static_cast<Context*>(_context);
+		if (context.found)
+		{
+			*o_contents = stringToSolidity(context.fileB);
+			*o_error = nullptr;
+		}
+		else
+		{
+			*o_contents = nullptr;
+			*o_error = stringToSolidity("Deleted.");
+		}
+	};
+	char const* input = R"({
+		"language": "Solidity",
+		"sources": { "fileA": { "content": "import \"fileB\"; contract A is B {}" } },
+		"settings": { "outputSelection": { "*": { "*": ["abi"] } } }
+	})";
+	Context context;
+	SolidityCompiler* compiler = solidity_compiler_create(callback, &context);
+	BOOST_REQUIRE(compiler != nullptr);
+	auto compileWith = [&]() {
+		Json::Value ret;
+		BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(compiler, input, nullptr), ret));
+		return ret;
+	};
+
+	Json::Value result = compileWith();
+	BOOST_CHECK_EQUAL(result["contracts"]["fileA"]["A"]["abi"].size(), 0);
+
+	// The imported file is read again although the input did not change.
+	context.fileB = "contract B { function g() public {} }";
+	result = compileWith();
+	BOOST_CHECK_EQUAL(result["contracts"]["fileA"]["A"]["abi"].size(), 1);
+
+	// An import that cannot be read anymore is reported.
+	context.found = false;
+	result = compileWith();
+	BOOST_CHECK(containsError(result, "ParserError", "Source \"fileB\" not found: Deleted."));
+	solidity_compiler_destroy(compiler);
+}
+
+BOOST_AUTO_TEST_CASE(compiler_handle_in_use)
+{
+	struct Context
+	{
+		SolidityCompiler* compiler = nullptr;
+		bool updateAccepted = true;
+		string compileOutput;
+	};
+	// The callback is called while the compiler is compiling, i.e. in use.
+	CStyleReadFileCallback callback = [](void* _context, char const*, char const*, char** o_contents, char** o_error)
+	{
+		Context& context = *static_cast<Context*>(_context);
+		context.updateAccepted = solidity_compiler_update_sources(context.compiler, "{}");
+		context.compileOutput = solidity_compiler_compile(context.compiler, "{}", nullptr);
+		*o_contents = stringToSolidity("contract B {}");
+		*o_error = nullptr;
+	};
+	Context context;
+	context.compiler = solidity_compiler_create(callback, &context);
+	BOOST_REQUIRE(context.compiler != nullptr);
+	char const* input = R"({
+		"language": "Solidity",
+		"sources": { "fileA": { "content": "import \"fileB\"; contract A is B {}" } },
+		"settings": { "outputSelection": { "*": { "*": ["evm.bytecode.object"] } } }
+	})";
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(context.compiler, input, nullptr), result));
+	BOOST_CHECK(!result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+
+	BOOST_CHECK(!context.updateAccepted);
+	Json::Value inUse;
+	BOOST_REQUIRE(jsonParseStrict(context.compileOutput, inUse));
+	BOOST_CHECK(containsError(inUse, "JSONError", "The compiler is already in use by another thread."));
+
+	// The compiler can be used again afterwards.
+	BOOST_CHECK(solidity_compiler_update_sources(context.compiler, "{}"));
+	solidity_compiler_destroy(context.compiler);
+}
+
+BOOST_AUTO_TEST_CASE(compiler_handle_concurrent_reads)
+{
+	// The reads of the imports of fileA wait for each other to check that they overlap.
+	// Boost.Test is not used in the callback, since it is called from other threads.
+	struct Context
+	{
+		mutex readMutex;
+		condition_variable readStarted;
+		size_t activeReads = 0;
+		bool overlapped = false;
+	};
+	CStyleReadFileCallback callback = [](void* _context, char const*, char const* _path, char** o_contents, char** o_error)
+	{
+		Context& context = *static_cast<Context*>(_context);
+		{
+			unique_lock<mutex> lock(context.readMutex);
+			++context.activeReads;
+			context.readStarted.notify_all();
+			if (context.readStarted.wait_for(lock, chrono::seconds(10), [&]() { return context.overlapped || context.activeReads > 1; }))
+				context.overlapped = true;
+			--context.activeReads;
+		}
+		string const contents = "contract " + string(_path).substr(4) + " {}";
+		*o_contents = solidity_alloc(contents.size());
+		if (*o_contents)
+			memcpy(*o_contents, contents.data(), contents.size());
+		*o_error = nullptr;
+	};
+	char const* input = R"({
+		"language": "Solidity",
+		"sources": { "fileA": { "content": "import \"fileB\"; import \"fileC\"; contract A is B, C {}" } },
+		"settings": { "parallelism": 4, "outputSelection": { "*": { "*": ["evm.bytecode.object"] } } }
+	})";
+
+	Context context;
+	SolidityCompiler* compiler = solidity_compiler_create(callback, &context);
+	BOOST_REQUIRE(compiler != nullptr);
+	BOOST_CHECK(solidity_compiler_allow_concurrent_reads(compiler, true));
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(compiler, input, nullptr), result));
+	BOOST_CHECK(!result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_CHECK(context.overlapped);
+	solidity_compiler_destroy(compiler);
+}
+
+BOOST_AUTO_TEST_CASE(compiler_handles_compile_concurrently)
+{
+	// While the first compiler reads an import, the second one compiles on another thread.
+	// Boost.Test is not used in the callback and the thread.
+	struct Context
+	{
+		mutex stateMutex;
+		condition_variable changed;
+		bool reading = false;
+		bool otherDone = false;
+		bool overlapped = false;
+	};
+	CStyleReadFileCallback callback = [](void* _context, char const*, char const*, char** o_contents, char** o_error)
+	{
+		Context& context = *static_cast<Context*>(_context);
+		{
+			unique_lock<mutex> lock(context.stateMutex);
+			context.reading = true;
+			context.changed.notify_all();
+			context.overlapped = context.changed.wait_for(lock, chrono::seconds(10), [&]() { return context.otherDone; });
+		}
+		*o_contents = stringToSolidity("contract B { function g() public {} }");
+		*o_error = nullptr;
+	};
+	char const* input = R"({
+		"language": "Solidity",
+		"sources": { "fileA": { "content": "import \"fileB\"; contract A is B {}" } },
+		"settings": { "outputSelection": { "*": { "*": ["evm.bytecode.object", "abi"] } } }
+	})";
+	char const* otherInput = R"({
+		"language": "Solidity",
+		"sources": { "fileC": { "content": "contract C { function h() public {} }" } },
+		"settings": { "outputSelection": { "*": { "*": ["evm.bytecode.object", "abi"] } } }
+	})";
+
+	Context context;
+	SolidityCompiler* compiler = solidity_compiler_create(callback, &context);
+	SolidityCompiler* other = solidity_compiler_create(nullptr, nullptr);
+	BOOST_REQUIRE(compiler != nullptr);
+	BOOST_REQUIRE(other != nullptr);
+	string otherOutput;
+	thread otherThread([&]() {
+		{
+			unique_lock<mutex> lock(context.stateMutex);
+			context.changed.wait_for(lock, chrono::seconds(10), [&]() { return context.reading; });
+		}
+		otherOutput = solidity_compiler_compile(other, otherInput, nullptr);
+		lock_guard<mutex> lock(context.stateMutex);
+		context.otherDone = true;
+		context.changed.notify_all();
+	});
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(compiler, input, nullptr), result));
+	otherThread.join();
+	BOOST_CHECK(context.overlapped);
+
+	Json::Value otherResult;
+	BOOST_REQUIRE(jsonParseStrict(otherOutput, otherResult));
+	BOOST_CHECK(!result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_CHECK_EQUAL(result["contracts"]["fileA"]["A"]["abi"].size(), 1);
+	BOOST_CHECK(!otherResult["contracts"]["fileC"]["C"]["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_CHECK_EQUAL(otherResult["contracts"]["fileC"]["C"]["abi"].size(), 1);
+
+	// Both compilers kept their analysis and can compile again.
+	BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(other, otherInput, nullptr), otherResult));
+	BOOST_CHECK(!otherResult["contracts"]["fileC"]["C"]["evm"]["bytecode"]["object"].asString().empty());
+	BOOST_REQUIRE(jsonParseStrict(solidity_compiler_compile(compiler, input, nullptr), result));
+	BOOST_CHECK(!result["contracts"]["fileA"]["A"]["evm"]["bytecode"]["object"].asString().empty());
+	solidity_compiler_destroy(other);
+	solidity_compiler_destroy(compiler);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -43,12 +43,14 @@ public:
 		std::string const& _code,
 		std::string const& _contractName,
 		std::string const& _expectedDocumentationString,
-		bool _userDocumentation
+		bool _userDocumentation,
+		bool _analyseDocumentation = true
 	)
 	{
 		m_compilerStack.reset();
 		m_compilerStack.setSources({{"", "pragma solidity >=0.0;\n" + _code}});
 		m_compilerStack.setEVMVersion(dev::test::Options::get().evmVersion());
+		m_compilerStack.enableDocumentationAnalysis(_analyseDocumentation);
 		BOOST_REQUIRE_MESSAGE(m_compilerStack.parseAndAnalyze(), "Parsing contract failed");
 
 		Json::Value generatedDocumentation;
@@ -124,6 +126,40 @@ BOOST_AUTO_TEST_CASE(dev_and_user_basic_test)
 	checkNatspec(sourceCode, "test", userNatspec, true);
 }
 
+BOOST_AUTO_TEST_CASE(dev_and_user_documentation_parsed_on_demand)
+{
+	char const* sourceCode = R"(
+		contract test {
+			/// @param x not a parameter
+			function f(uint y) public pure {}
+			/// @notice Multiplies `a` by 7
+			/// @dev Multiplies a number by 7
+			function mul(uint a) public returns(uint d) { return a * 7; }
+		}
+	)";
+
+	char const* devNatspec = R"R({
+		"methods": {
+			"f(uint256)": {
+				"params": { "x": "not a parameter" }
+			},
+			"mul(uint256)": {
+				"details": "Multiplies a number by 7"
+			}
+		}
+	})R";
+
+	char const* userNatspec = R"R({
+		"methods": {
+			"mul(uint256)": { "notice": "Multiplies `a` by 7" }
+		}
+	})R";
+
+	// Errors in the documentation are not reported if it is not analysed.
+	checkNatspec(sourceCode, "test", devNatspec, false, false);
+	checkNatspec(sourceCode, "test", userNatspec, true, false);
+}
+
 BOOST_AUTO_TEST_CASE(user_multiline_comment)
 {
 	char const* sourceCode = R"(
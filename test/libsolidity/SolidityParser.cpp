@@ -674,11 +674,13 @@ BOOST_AUTO_TEST_CASE(inline_asm_end_location)
 	class CheckInlineAsmLocation: public ASTConstVisitor
 	{
 	public:
+		explicit CheckInlineAsmLocation(string const& _source): source(_source) {}
+		string const& source;
 		bool visited = false;
 		virtual bool visit(InlineAssembly const& _inlineAsm)
 		{
 			auto loc = _inlineAsm.location();
-			auto asmStr = loc.source->source().substr(loc.start, loc.end - loc.start);
+			auto asmStr = source.substr(loc.start, loc.end - loc.start);
 			BOOST_CHECK_EQUAL(asmStr, "assembly { a := 0x12345678 }");
 			visited = true;
 
@@ -686,12 +688,72 @@ BOOST_AUTO_TEST_CASE(inline_asm_end_location)
 		}
 	};
 
-	CheckInlineAsmLocation visitor;
+	CheckInlineAsmLocation visitor(sourceCode);
 	contract->accept(visitor);
 
 	BOOST_CHECK_MESSAGE(visitor.visited, "No inline asm block found?!");
 }
 
+BOOST_AUTO_TEST_CASE(arena_allocation)
+{
+	char const* text = R"(
+		contract C {
+			function f(uint a) public pure returns (uint) { assembly { a := 1 } return a; }
+		}
+	)";
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	ASTArena arena;
+	ASTPointer<SourceUnit> sourceUnit = Parser(
+		errorReporter,
+		dev::test::Options::get().evmVersion()
+	).parse(make_shared<Scanner>(CharStream(text, "")), &arena);
+	BOOST_REQUIRE(sourceUnit);
+	BOOST_CHECK(errors.empty());
+	size_t parsed = arena.usedBytes();
+	BOOST_CHECK(parsed > 0);
+
+	// Annotations are allocated from the arena of their node.
+	sourceUnit->annotation().path = "a";
+	BOOST_CHECK(arena.usedBytes() > parsed);
+	BOOST_CHECK_EQUAL(sourceUnit->annotation().path, "a");
+}
+
+BOOST_AUTO_TEST_CASE(arena_groups_annotations_by_kind)
+{
+	char const* text = R"(
+		contract C {
+			function f() public pure returns (uint) { return 1 + 2 + 3; }
+		}
+	)";
+	ErrorList errors;
+	ErrorReporter errorReporter(errors);
+	ASTArena arena;
+	ASTPointer<SourceUnit> sourceUnit = Parser(
+		errorReporter,
+		dev::test::Options::get().evmVersion()
+	).parse(make_shared<Scanner>(CharStream(text, "")), &arena);
+	BOOST_REQUIRE(sourceUnit);
+
+	// The annotations of the literals are not interleaved with those of other nodes.
+	vector<char const*> literalAnnotations;
+	SimpleASTVisitor annotator(
+		[&](ASTNode const& _node)
+		{
+			if (auto literal = dynamic_cast<Literal const*>(&_node))
+				literalAnnotations.push_back(reinterpret_cast<char const*>(&literal->annotation()));
+			else
+				_node.annotation();
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	sourceUnit->accept(annotator);
+	BOOST_REQUIRE_EQUAL(literalAnnotations.size(), 3u);
+	for (size_t i = 1; i < literalAnnotations.size(); ++i)
+		BOOST_CHECK_EQUAL(size_t(literalAnnotations[i] - literalAnnotations[i - 1]), sizeof(ExpressionAnnotation));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
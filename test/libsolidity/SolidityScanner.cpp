@@ -664,6 +664,162 @@ BOOST_AUTO_TEST_CASE(irregular_line_breaks_in_strings)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(multibyte_characters_in_comments_and_strings)
+{
+	// The first bytes of U+00E4 and U+20AC are also the first bytes of line terminators.
+	string const text = "a \xC2\xA0 \xE2\x82\xAC b";
+	Scanner scanner(CharStream(
+		"// " + text + "\n/// " + text + "\nx /** " + text + "*/ \"" + text + "\" '" + text + "' /* " + text + " */",
+		""
+	));
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), text);
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), text);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), text);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), text);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(long_runs)
+{
+	// Runs of whitespace, comments and string literals are skipped at once.
+	// Their end is tested at every position up to a length beyond a few machine words.
+	for (size_t length = 0; length < 80; ++length)
+	{
+		string const run = string(length, 'x') + "y";
+		string const spaces(length, ' ');
+		Scanner scanner(CharStream(
+			spaces + "a" + spaces + "\t\n// " + run + "\n/** " + run + "\n* " + run + " */ b \"" + run +
+			"\\n\" '" + run + "\xC2\xA0' /* " + run + "*/" + spaces,
+			""
+		));
+		BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentLocation().start, int(length));
+		BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+		BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), run + "\n" + run + " ");
+		BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), run + "\n");
+		BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+		BOOST_CHECK_EQUAL(scanner.currentLiteral(), run + "\xC2\xA0");
+		BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(arbitrary_lookahead)
+{
+	Scanner scanner(CharStream("/** doc*/ a.b[1] c; 'x\\n'", ""));
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.peekToken(5), Token::RBrack);
+	BOOST_CHECK_EQUAL(scanner.peekToken(6), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.peekToken(8), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.peekToken(9), Token::EOS);
+	BOOST_CHECK_EQUAL(scanner.peekToken(20), Token::EOS);
+	// Looking ahead does not advance.
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a");
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), "doc");
+	// Literals that appear unchanged in the source refer to it.
+	BOOST_CHECK(scanner.currentLiteral().data() == scanner.source().data() + 10);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Period);
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), "");
+	for (size_t i = 0; i < 6; ++i)
+		scanner.next();
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Semicolon);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "x\n");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(lookahead_period_in_identifier)
+{
+	Scanner scanner(CharStream("x a.b c", ""));
+	BOOST_CHECK_EQUAL(scanner.peekToken(3), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	// Tokens scanned ahead are scanned again.
+	scanner.supportPeriodInIdentifier(true);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a.b");
+	BOOST_CHECK_EQUAL(scanner.peekToken(1), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.peekLiteral(), "c");
+	BOOST_CHECK_EQUAL(scanner.peekToken(2), Token::EOS);
+	scanner.supportPeriodInIdentifier(false);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "a");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Period);
+}
+
+BOOST_AUTO_TEST_CASE(edits)
+{
+	// Checks that the scanner yields the same tokens as a new one for the edited source.
+	auto checkEdit = [](Scanner& _scanner, size_t _start, size_t _end, string const& _replacement)
+	{
+		string source{_scanner.source()};
+		source.replace(_start, _end - _start, _replacement);
+		_scanner.applyEdit(_start, _end, _replacement);
+		BOOST_REQUIRE_EQUAL(_scanner.source(), source);
+		Scanner expectation(CharStream(source, ""));
+		while (true)
+		{
+			BOOST_CHECK_EQUAL(_scanner.currentToken(), expectation.currentToken());
+			BOOST_CHECK_EQUAL(_scanner.currentLiteral(), expectation.currentLiteral());
+			BOOST_CHECK_EQUAL(_scanner.currentLocation().start, expectation.currentLocation().start);
+			BOOST_CHECK_EQUAL(_scanner.currentLocation().end, expectation.currentLocation().end);
+			BOOST_CHECK_EQUAL(_scanner.currentCommentLiteral(), expectation.currentCommentLiteral());
+			if (expectation.currentToken() == Token::EOS)
+				break;
+			_scanner.next();
+			expectation.next();
+		}
+	};
+
+	Scanner scanner(CharStream("a + b; /// doc\nc = \"x\\ty\"; d.e", ""));
+	shared_ptr<CharStream> stream = scanner.charStream();
+	uint32_t const index = stream->index();
+	// Extending the token in front of the edit.
+	checkEdit(scanner, 3, 3, "=");
+	// Merging two tokens.
+	checkEdit(scanner, 1, 5, "");
+	checkEdit(scanner, 1, 1, " += ");
+	// Editing a documentation comment and a decoded string literal.
+	checkEdit(scanner, 11, 14, "new doc");
+	checkEdit(scanner, 26, 26, "\\n");
+	// Starting a comment that spans the rest of the source.
+	checkEdit(scanner, 0, 0, "/*");
+	checkEdit(scanner, 0, 2, "");
+	// Tokens that were scanned with support for period in identifier.
+	scanner.next();
+	scanner.supportPeriodInIdentifier(true);
+	while (scanner.next() != Token::EOS) {}
+	BOOST_CHECK_EQUAL(scanner.peekLiteral(), "");
+	checkEdit(scanner, 0, 1, "f");
+	checkEdit(scanner, 0, scanner.source().size(), "");
+	checkEdit(scanner, 0, 0, "g h");
+	// The source keeps its index.
+	BOOST_CHECK(scanner.charStream() == stream);
+	BOOST_CHECK_EQUAL(stream->index(), index);
+}
+
+BOOST_AUTO_TEST_CASE(set_position_reuses_tokens)
+{
+	Scanner scanner(CharStream("a /** doc */ b c", ""));
+	scanner.next();
+	scanner.next();
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "c");
+	scanner.setPosition(13);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "b");
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), "doc ");
+	// Skipping parts of the source.
+	scanner.setPosition(14);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "c");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+	scanner.applyEdit(0, 1, "x");
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "x");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "b");
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), "doc ");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
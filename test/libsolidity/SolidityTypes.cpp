@@ -220,6 +220,31 @@ BOOST_AUTO_TEST_CASE(type_identifiers)
 	BOOST_CHECK_EQUAL(InaccessibleDynamicType().identifier(), "t_inaccessible");
 }
 
+BOOST_AUTO_TEST_CASE(shared_types)
+{
+	TypePointer uintArray = TypeProvider::array(DataLocation::Memory, TypeProvider::uint256());
+	BOOST_CHECK(uintArray == TypeProvider::array(DataLocation::Memory, TypeProvider::uint256()));
+	ArrayType const* storageArray = TypeProvider::array(DataLocation::Storage, TypeProvider::uint256());
+	BOOST_CHECK(uintArray != storageArray);
+	BOOST_CHECK(uintArray == TypeProvider::withLocation(storageArray, DataLocation::Memory, true));
+
+	TypePointer m = TypeProvider::mapping(TypeProvider::uint256(), uintArray);
+	BOOST_CHECK(m == TypeProvider::mapping(TypeProvider::uint256(), uintArray));
+	BOOST_CHECK(m != TypeProvider::mapping(TypeProvider::uint256(), storageArray));
+	BOOST_CHECK(TypeProvider::tuple({m, uintArray}) == TypeProvider::tuple({m, uintArray}));
+
+	auto function = [&](string const& _parameterName) {
+		return TypeProvider::function(TypePointers{uintArray}, TypePointers{}, strings{_parameterName}, strings{});
+	};
+	BOOST_CHECK(function("a") == function("a"));
+	// Parameter names are not part of the identifier, but still distinguish the types.
+	BOOST_CHECK(function("a") != function("b"));
+	BOOST_CHECK(*function("a") == *function("b"));
+
+	// Rational numbers are not shared, because their compatible bytes types are not part of the identifier.
+	BOOST_CHECK(TypeProvider::rationalNumber(rational(1), nullptr) != TypeProvider::rationalNumber(rational(1), nullptr));
+}
+
 BOOST_AUTO_TEST_CASE(encoded_sizes)
 {
 	BOOST_CHECK_EQUAL(IntegerType(16).calldataEncodedSize(true), 32);
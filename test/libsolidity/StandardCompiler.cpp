@@ -19,13 +19,23 @@
  * Unit tests for interface/StandardCompiler.h.
  */
 
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <boost/test/unit_test.hpp>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/Version.h>
+#include <libdevcore/CommonIO.h>
 #include <libdevcore/JSON.h>
 #include <test/Metadata.h>
 
+#include <boost/filesystem.hpp>
+
 using namespace std;
 using namespace dev::eth;
 
@@ -1366,6 +1376,431 @@ BOOST_AUTO_TEST_CASE(standard_output_selection_wildcard_multiple_sources)
 	BOOST_REQUIRE(result["sources"]["B"].isObject());
 }
 
+BOOST_AUTO_TEST_CASE(parallelism_invalid)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"parallelism": 0
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "\"settings.parallelism\" must be a positive integer."));
+}
+
+BOOST_AUTO_TEST_CASE(parallelism_same_output)
+{
+	string sources = R"(
+		"A": {
+			"content": "pragma solidity >=0.0; contract C { function f() public pure returns (uint) { return 1; } } contract D { C c = new C(); }"
+		},
+		"B": {
+			"content": "pragma solidity >=0.0; import \"A\"; contract E is C { D d = new D(); } contract F { function g() public pure {} } library L { function h() public pure {} }"
+		}
+	)";
+	auto input = [&](string const& _parallelism)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"sources": {)" + sources + R"(},
+			"settings": {
+				"parallelism": )" + _parallelism + R"(,
+				"optimizer": { "enabled": true },
+				"outputSelection": {
+					"*": { "*": ["metadata", "evm.bytecode", "evm.deployedBytecode", "evm.legacyAssembly"] }
+				}
+			}
+		}
+		)";
+	};
+	Json::Value sequential = compile(input("1"));
+	BOOST_CHECK(containsAtMostWarnings(sequential));
+	BOOST_REQUIRE(sequential["contracts"]["B"]["E"].isObject());
+	Json::Value parallel = compile(input("4"));
+	BOOST_CHECK(sequential == parallel);
+}
+
+BOOST_AUTO_TEST_CASE(streaming_same_output)
+{
+	string const input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"A": {
+				"content": "pragma solidity >=0.0; contract C { function f() public pure returns (uint) { uint x; return 1; } } contract D { C c = new C(); }"
+			},
+			"A.B": {
+				"content": "pragma solidity >=0.0; import \"A\"; contract E is C {} interface I { function g() external; } contract F { D d = new D(); C c = new C(); }"
+			}
+		},
+		"settings": {
+			"optimizer": { "enabled": true },
+			"outputSelection": {
+				"*": {
+					"*": ["abi", "metadata", "evm.bytecode", "evm.deployedBytecode", "evm.assembly", "evm.legacyAssembly", "evm.gasEstimates"],
+					"": ["ast"]
+				},
+				"A": { "D": [] }
+			},
+			"debug": { "statistics": true }
+		}
+	}
+	)";
+	dev::solidity::StandardCompiler compiler;
+	string expected = compiler.compile(input);
+	BOOST_REQUIRE(expected.find("\"F\"") != string::npos);
+	stringstream output;
+	BOOST_CHECK(compiler.compile(input, output));
+	Json::Value result;
+	BOOST_REQUIRE(jsonParseStrict(output.str(), result));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	// Statistics contain times, which differ between runs, but are the last member.
+	size_t statistics = expected.find("\"statistics\"");
+	BOOST_REQUIRE(statistics != string::npos);
+	BOOST_CHECK_EQUAL(output.str().substr(0, statistics), expected.substr(0, statistics));
+
+	stringstream invalidOutput;
+	BOOST_CHECK(compiler.compile("{", invalidOutput));
+	BOOST_REQUIRE(jsonParseStrict(invalidOutput.str(), result));
+	BOOST_CHECK_EQUAL(result["errors"][0]["type"].asString(), "JSONError");
+}
+
+BOOST_AUTO_TEST_CASE(parallelism_same_ast)
+{
+	auto input = [&](string const& _parallelism, string const& _missing)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"A": { "content": "pragma solidity >=0.0; import \"B\"; import \"C\"; contract A is B { uint x; }" },
+				"B": { "content": "pragma solidity >=0.0; import \"C\"; import { D as E } from \"D\"; contract B { function f() public pure {} }" },
+				"C": { "content": "pragma solidity >=0.0; import \"A\"; )" + _missing + R"( contract C { function g() public pure { assembly { let x := 1 } } }" },
+				"D": { "content": "pragma solidity >=0.0; contract D { }" }
+			},
+			"settings": {
+				"parallelism": )" + _parallelism + R"(,
+				"outputSelection": {
+					"*": { "": ["ast", "legacyAST"], "*": ["evm.bytecode"] }
+				}
+			}
+		}
+		)";
+	};
+	Json::Value sequential = compile(input("1", ""));
+	BOOST_CHECK(containsAtMostWarnings(sequential));
+	BOOST_CHECK(sequential == compile(input("4", "")));
+
+	sequential = compile(input("1", "import \\\"missing\\\";"));
+	BOOST_CHECK(containsError(sequential, "ParserError", "Source \"missing\" not found: File not supplied initially."));
+	BOOST_CHECK(sequential == compile(input("4", "import \\\"missing\\\";")));
+}
+
+BOOST_AUTO_TEST_CASE(parallelism_read_callback)
+{
+	StringMap const files{
+		{"B", "pragma solidity >=0.0; import \"C\"; import \"D\"; contract B is C { function f() public pure {} }"},
+		{"C", "pragma solidity >=0.0; import \"D\"; contract C is D {}"},
+		{"D", "pragma solidity >=0.0; contract D { function g() public pure { assembly { let x := 1 } } }"}
+	};
+	// Without a declaration that it can be called concurrently, the callback is only
+	// called from one thread at a time, while other threads parse the sources read so far.
+	// With it, the reads of the imports of a source wait for each other to check that they overlap.
+	mutex readMutex;
+	condition_variable readStarted;
+	set<thread::id> readThreads;
+	size_t activeReads = 0;
+	bool overlapped = false;
+	bool concurrentReads = false;
+	ReadCallback::Callback readFile = [&](string const&, string const& _path)
+	{
+		{
+			unique_lock<mutex> lock(readMutex);
+			readThreads.insert(this_thread::get_id());
+			overlapped = overlapped || activeReads > 0;
+			++activeReads;
+			readStarted.notify_all();
+			if (concurrentReads)
+				readStarted.wait_for(lock, chrono::seconds(10), [&]() { return overlapped || activeReads > 1; });
+		}
+		this_thread::sleep_for(chrono::milliseconds(10));
+		lock_guard<mutex> lock(readMutex);
+		overlapped = overlapped || activeReads > 1;
+		--activeReads;
+		if (!files.count(_path))
+			return ReadCallback::Result{false, "File not found."};
+		return ReadCallback::Result{true, files.at(_path)};
+	};
+	auto compileWith = [&](string const& _parallelism)
+	{
+		string input = R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"A": { "content": "pragma solidity >=0.0; import \"B\"; import \"missing\"; contract A is B {}" }
+			},
+			"settings": {
+				"parallelism": )" + _parallelism + R"(,
+				"outputSelection": {
+					"*": { "": ["ast"], "*": ["evm.bytecode"] }
+				}
+			}
+		}
+		)";
+		solidity::StandardCompiler compiler(readFile);
+		compiler.allowConcurrentReads(concurrentReads);
+		Json::Value result;
+		BOOST_REQUIRE(jsonParseStrict(compiler.compile(input), result));
+		return result;
+	};
+
+	Json::Value sequential = compileWith("1");
+	BOOST_CHECK(containsError(sequential, "ParserError", "Source \"missing\" not found: File not found."));
+	readThreads.clear();
+	BOOST_CHECK(sequential == compileWith("4"));
+	BOOST_CHECK(!overlapped);
+	BOOST_CHECK_EQUAL(readThreads.size(), 1);
+	BOOST_CHECK(readThreads.count(this_thread::get_id()));
+
+	concurrentReads = true;
+	readThreads.clear();
+	BOOST_CHECK(sequential == compileWith("4"));
+	BOOST_CHECK(overlapped);
+	BOOST_CHECK(readThreads.size() > 1);
+}
+
+BOOST_AUTO_TEST_CASE(cache_dir_invalid)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"cacheDir": 1
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "\"settings.cacheDir\" must be a string."));
+}
+
+BOOST_AUTO_TEST_CASE(cache_dir_same_output)
+{
+	boost::filesystem::path cacheDir =
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("solc-cache-%%%%-%%%%-%%%%");
+	string input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"A": {
+				"content": "pragma solidity >=0.0; contract C { function f() public pure returns (uint) { return 1; } } contract D { C c = new C(); } library L { function h() public pure {} }"
+			}
+		},
+		"settings": {
+			"cacheDir": ")" + cacheDir.string() + R"(",
+			"libraries": { "A": { "L": "0x4200000000000000000000000000000000000001" } },
+			"outputSelection": {
+				"*": { "*": ["evm.bytecode", "evm.deployedBytecode", "evm.assembly", "evm.legacyAssembly", "evm.gasEstimates"] }
+			}
+		}
+	}
+	)";
+	Json::Value uncached = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(uncached));
+	BOOST_REQUIRE(uncached["contracts"]["A"]["D"].isObject());
+	BOOST_CHECK(!boost::filesystem::is_empty(cacheDir));
+	Json::Value cached = compile(input);
+	boost::filesystem::remove_all(cacheDir);
+	BOOST_CHECK(uncached == cached);
+}
+
+BOOST_AUTO_TEST_CASE(cache_dir_hits_and_invalidation)
+{
+	boost::filesystem::path cacheDir =
+		boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("solc-cache-%%%%-%%%%-%%%%");
+	auto input = [&](string const& _imported, bool _optimize)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"A": { "content": "pragma solidity >=0.0; import \"B\"; contract X { function f() public pure {} }" },
+				"B": { "content": "import \"C\";" },
+				"C": { "content": ")" + _imported + R"(" }
+			},
+			"settings": {
+				"cacheDir": ")" + cacheDir.string() + R"(",
+				"optimizer": { "enabled": )" + (_optimize ? "true" : "false") + R"( },
+				"outputSelection": { "*": { "*": ["evm.bytecode", "evm.assembly"] } }
+			}
+		}
+		)";
+	};
+	// Replaces the value of @a _field in all cache entries by @a _value.
+	auto replaceInCache = [&](string const& _field, string const& _value)
+	{
+		for (auto const& entry: boost::filesystem::directory_iterator(cacheDir))
+		{
+			Json::Value artifacts;
+			BOOST_REQUIRE(jsonParseStrict(readFileAsString(entry.path().string()), artifacts));
+			artifacts[_field] = _value;
+			ofstream(entry.path().string()) << jsonCompactPrint(artifacts);
+		}
+	};
+	// The assembly is marked in the cache to tell whether an output was taken from there.
+	auto cachedAssembly = [&](string const& _imported, bool _optimize)
+	{
+		Json::Value result = compile(input(_imported, _optimize));
+		BOOST_CHECK(containsAtMostWarnings(result));
+		return result["contracts"]["A"]["X"]["evm"]["assembly"] == "cached";
+	};
+
+	string const imported = "contract Z {}";
+	BOOST_CHECK(!cachedAssembly(imported, false));
+	replaceInCache("assembly", "cached");
+	BOOST_CHECK(cachedAssembly(imported, false));
+	// A change of a source that is imported indirectly.
+	BOOST_CHECK(!cachedAssembly(imported + " // changed", false));
+	// A change of the optimiser settings.
+	BOOST_CHECK(!cachedAssembly(imported, true));
+	// Entries of a different compiler version are ignored.
+	BOOST_CHECK(cachedAssembly(imported, false));
+	replaceInCache("compilerVersion", "0.4.0");
+	BOOST_CHECK(!cachedAssembly(imported, false));
+	boost::filesystem::remove_all(cacheDir);
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_per_contract)
+{
+	string sources = R"(
+		"A": {
+			"content": "pragma solidity >=0.0; contract C { function f() public pure returns (uint) { return 1; } } contract D { C c = new C(); }"
+		},
+		"B": {
+			"content": "pragma solidity >=0.0; import \"A\"; contract E is C { function g() public pure {} }"
+		}
+	)";
+	auto input = [&](string const& _outputSelection)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"sources": {)" + sources + R"(},
+			"settings": {
+				"outputSelection": )" + _outputSelection + R"(
+			}
+		}
+		)";
+	};
+	Json::Value full = compile(input(R"({ "*": { "*": ["evm.bytecode"] } })"));
+	BOOST_CHECK(containsAtMostWarnings(full));
+	Json::Value result = compile(input(R"({
+		"A": { "C": ["abi", "evm.methodIdentifiers"], "D": ["evm.bytecode"] },
+		"B": { "E": ["ir"] }
+	})"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["contracts"]["A"]["C"]["abi"].isArray());
+	BOOST_CHECK(result["contracts"]["A"]["C"]["evm"]["methodIdentifiers"].isMember("f()"));
+	BOOST_CHECK(!result["contracts"]["A"]["C"]["evm"].isMember("bytecode"));
+	BOOST_CHECK(result["contracts"]["A"]["D"]["evm"]["bytecode"] == full["contracts"]["A"]["D"]["evm"]["bytecode"]);
+	BOOST_CHECK(!result["contracts"]["B"]["E"]["ir"].asString().empty());
+	BOOST_CHECK(!result["contracts"]["B"]["E"].isMember("evm"));
+}
+
+BOOST_AUTO_TEST_CASE(statistics)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"sources": {
+			"A": {
+				"content": "pragma solidity >=0.0; contract C { function f() public pure returns (uint) { return 1; } } contract D { C c = new C(); }"
+			}
+		},
+		"settings": {
+			"debug": { "statistics": true },
+			"optimizer": { "enabled": true },
+			"outputSelection": {
+				"*": { "D": ["evm.bytecode"] }
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value const& statistics = result["statistics"];
+	for (string phase: {"parsing", "analysis", "nameResolution", "typeChecking", "compilation", "codegen", "evmOptimiser"})
+		BOOST_CHECK_MESSAGE(statistics["phases"][phase]["wallTime"].isNumeric(), phase);
+	BOOST_CHECK(statistics["counters"]["astNodes"].asUInt() > 0);
+	BOOST_CHECK(statistics["counters"]["types"].asUInt() > 0);
+	BOOST_CHECK(statistics["counters"]["evmOptimiserRounds"].asUInt() > 0);
+	BOOST_CHECK(statistics["contracts"]["A"]["C"]["phases"].isMember("codegen"));
+	BOOST_CHECK(statistics["contracts"]["A"]["D"]["phases"].isMember("assembly"));
+}
+
+BOOST_AUTO_TEST_CASE(statistics_invalid)
+{
+	char const* input = R"(
+	{
+		"language": "Solidity",
+		"settings": {
+			"debug": { "statistics": 1 }
+		},
+		"sources": {
+			"empty": {
+				"content": ""
+			}
+		}
+	}
+	)";
+	Json::Value result = compile(input);
+	BOOST_CHECK(containsError(result, "JSONError", "settings.debug.statistics must be a Boolean."));
+}
+
+BOOST_AUTO_TEST_CASE(documentation_only_analysed_if_requested)
+{
+	auto input = [](string const& _outputSelection)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"sources": {
+				"A": {
+					"content": "pragma solidity >=0.0; contract C { /// @param x the input\n/// @notice Does nothing.\nfunction f(uint y) public pure {} }"
+				}
+			},
+			"settings": {
+				"outputSelection": )" + _outputSelection + R"(
+			}
+		}
+		)";
+	};
+	string const error = "Documented parameter \"x\" not found in the parameter list of the function.";
+	Json::Value result = compile(input(R"({ "*": { "": ["ast"], "*": ["abi"] } })"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["sources"]["A"]["ast"].isObject());
+	BOOST_CHECK(result["contracts"]["A"]["C"]["abi"].isArray());
+	for (string output: {"userdoc", "devdoc", "metadata", "evm.bytecode"})
+	{
+		result = compile(input(R"({ "*": { "*": [")" + output + R"("] } })"));
+		BOOST_CHECK_MESSAGE(containsError(result, "DocstringParsingError", error), output);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
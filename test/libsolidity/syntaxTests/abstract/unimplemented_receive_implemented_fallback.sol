@@ -0,0 +1,6 @@
+contract B {
+    receive() external payable virtual;
+    fallback() external {}
+}
+// ----
+// TypeError: (0-81): Contract "B" should be marked as abstract.
@@ -0,0 +1,11 @@
+contract C {
+    struct S { uint x; }
+    S s;
+    function f() internal pure returns (S storage) {}
+    function g(uint x) public pure returns (uint) { return x / 0; }
+    uint constant a = b;
+    uint constant b = a;
+}
+// ----
+// TypeError: (173-192): The value of the constant a has a cyclic dependency via b.
+// TypeError: (198-217): The value of the constant b has a cyclic dependency via a.
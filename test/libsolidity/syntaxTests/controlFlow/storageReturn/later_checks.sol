@@ -0,0 +1,8 @@
+contract C {
+    struct S { uint x; }
+    S s;
+    function f() internal pure returns (S storage) {}
+    function g(uint x) public pure returns (uint) { return x / 0; }
+}
+// ----
+// TypeError: (87-96): This variable is of storage pointer type and can be returned without prior assignment, which would lead to undefined behaviour.
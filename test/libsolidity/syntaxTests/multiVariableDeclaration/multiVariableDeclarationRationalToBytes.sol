@@ -0,0 +1,12 @@
+contract C {
+    function f() public pure {
+        (bytes1 a, uint b) = (0x12, 1);
+        a; b;
+    }
+    function g() public pure {
+        (bytes1 a, uint b) = (18, 1);
+        a; b;
+    }
+}
+// ----
+// TypeError: (143-171): Type int_const 18 is not implicitly convertible to expected type bytes1.
@@ -0,0 +1,148 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Micro-benchmark of the scanner: Scans all Solidity files in the given files and
+ * directories (e.g. test/compilationTests) repeatedly and reports the throughput.
+ */
+
+#include <liblangutil/CharStream.h>
+#include <liblangutil/Scanner.h>
+#include <libdevcore/CommonIO.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace dev;
+using namespace langutil;
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+vector<CharStream> loadSources(vector<string> const& _paths)
+{
+	vector<CharStream> sources;
+	auto add = [&](fs::path const& _file) {
+		sources.emplace_back(readFileAsString(_file.string()), _file.string());
+	};
+	for (string const& path: _paths)
+		if (fs::is_directory(path))
+		{
+			vector<fs::path> files;
+			for (fs::directory_entry const& entry: fs::recursive_directory_iterator(path))
+				if (fs::is_regular_file(entry.path()) && entry.path().extension() == ".sol")
+					files.push_back(entry.path());
+			sort(files.begin(), files.end());
+			for (fs::path const& file: files)
+				add(file);
+		}
+		else
+			add(path);
+	return sources;
+}
+
+/// Scans all @a _sources to their end. @returns the number of tokens.
+size_t scanAll(vector<CharStream> const& _sources)
+{
+	size_t tokens = 0;
+	for (CharStream const& source: _sources)
+	{
+		Scanner scanner(source);
+		for (; scanner.currentToken() != Token::EOS; scanner.next())
+			tokens++;
+	}
+	return tokens;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	po::options_description options(
+		R"(scannerbench, micro-benchmark of the Solidity scanner.
+Usage: scannerbench [Options] <path>...
+Scans all .sol files in the given files and directories repeatedly and
+prints the median time of a pass over all of them.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		(
+			"input-path",
+			po::value<vector<string>>(),
+			"input file or directory"
+		)
+		(
+			"runs",
+			po::value<size_t>()->default_value(100),
+			"number of passes over the input"
+		)
+		("help", "Show this help screen.");
+
+	po::positional_options_description filesPositions;
+	filesPositions.add("input-path", -1);
+
+	po::variables_map arguments;
+	try
+	{
+		po::command_line_parser cmdLineParser(argc, argv);
+		cmdLineParser.options(options).positional(filesPositions);
+		po::store(cmdLineParser.run(), arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+
+	if (arguments.count("help") || !arguments.count("input-path"))
+	{
+		cout << options;
+		return 0;
+	}
+
+	vector<CharStream> const sources = loadSources(arguments["input-path"].as<vector<string>>());
+	size_t bytes = 0;
+	for (CharStream const& source: sources)
+		bytes += source.source().size();
+
+	size_t const runs = max<size_t>(arguments["runs"].as<size_t>(), 1);
+	vector<double> times;
+	size_t tokens = 0;
+	for (size_t run = 0; run < runs; ++run)
+	{
+		auto start = chrono::steady_clock::now();
+		tokens = scanAll(sources);
+		times.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+	sort(times.begin(), times.end());
+	double const median = times[times.size() / 2];
+
+	cout << sources.size() << " files, " << bytes << " bytes, " << tokens << " tokens" << endl;
+	cout << "Median of " << runs << " passes: " << median << " ms (" << (bytes / 1e3 / median) << " MB/s)" << endl;
+	return 0;
+}